@@ -1,6 +1,7 @@
 #include "Game/App.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Window/Window.hpp"
@@ -80,6 +81,7 @@ void App::Startup()
 
 	g_theDevConsole->Startup();
 	g_theEventSystem->Startup();
+	FrameArenaStartup();
 	g_theInput->Startup();
 	g_theWindow->Startup();
 	g_theRenderer->Startup();
@@ -113,6 +115,7 @@ void App::Shutdown()
 	g_theWindow->Shutdown();
 	g_theInput->ShutDown();
 	g_theDevConsole->ShutDown();
+	FrameArenaShutdown();
 	g_theEventSystem->ShutDown();
 
 	delete g_theAudio;
@@ -172,6 +175,7 @@ void App::HandleQuitRequested()
 
 void App::BeginFrame()
 {
+	FrameArenaBeginFrame();
 	g_theDevConsole->BeginFrame();
 	g_theEventSystem->BeginFrame();
 	g_theInput->BeginFrame();
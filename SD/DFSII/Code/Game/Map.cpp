@@ -3,6 +3,11 @@
 #include "Game/Player.hpp"
 #include "Game/Planner.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
+
+// the info panel handlers are called every frame
+static EventId const s_updateStatusEventId("updateStatus");
+static EventId const s_updateItemsEventId("updateItems");
 
 Map::Map(Game* game, Camera* worldCamera, Camera* uiCamera)
 	: m_game(game)
@@ -158,7 +163,7 @@ void Map::UpdateGameInfo()
 	std::string action = m_player->m_currentActions.empty() ? "" : m_player->m_currentActions.front().type;
 	statusArgs.SetValue("action", action);
 
-	CallHandler("updateStatus", statusArgs);
+	CallHandler(s_updateStatusEventId, statusArgs);
 
 	EventArgs itemsArgs;
 	itemsArgs.SetValue("gold", m_player->m_golds);
@@ -173,7 +178,7 @@ void Map::UpdateGameInfo()
 		itemsArgs.SetValue("items", item);
 	}
 
-	CallHandler("updateItems", itemsArgs);
+	CallHandler(s_updateItemsEventId, itemsArgs);
 
 	m_gameInfo->Update();
 }
@@ -194,8 +199,8 @@ void Map::RenderMap() const
 
 	Rgba8 tintColor = InterpolateBetweenColor(Rgba8(50, 50, 80, 255), Rgba8(255, 255, 255, 255), tintValue);
 
-	std::vector<Vertex_PCU> verts;
-	verts.reserve(6 * m_tiles.size());
+	FrameVector<Vertex_PCU> verts;
+	verts.reserve(12 * m_tiles.size());
 	for (int tileIndex = 0; tileIndex < (int)m_tiles.size(); tileIndex++)
 	{
 		Tile const& currentTile = m_tiles[tileIndex];
@@ -208,7 +213,7 @@ void Map::RenderMap() const
 		AddVertsForAABB2D(verts, tileBox, tintColor, topUVs);
 	}
 
-	g_theRenderer->DrawVertexArray(verts);
+	g_theRenderer->DrawVertexArray(int(verts.size()), verts.data());
 }
 
 
@@ -1,20 +1,5 @@
 #pragma once
+#include "Engine/Core/SlotMap.hpp"
 
-struct ActorUID
-{
-public:
-	ActorUID();
-	ActorUID(int index, int salt);
-
-	void Invalidate();
-	bool IsValid() const;
-	int GetIndex() const;
-	bool operator==(ActorUID const& other) const;
-	bool operator!=(ActorUID const& other) const;
-
-	static const ActorUID INVALID;
-
-private:
-	int m_data = 0xffffffff;
-};
-
+// actors live in the map's SlotMap, so their UIDs are its generation checked handles
+typedef SlotHandle ActorUID;
@@ -1,15 +1,21 @@
 #include "Game/App.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Window/Window.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/Benchmark.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
 #include <thread>
 
+constexpr int DEFAULT_BENCHMARK_FRAMES = 1200;
+constexpr int DEFAULT_BENCHMARK_WARMUP_FRAMES = 60;
+
 Window* g_theWindow;
 Renderer* g_theRenderer;
 AudioSystem* g_theAudio;
@@ -18,6 +24,8 @@ static float UICameraSizeX = 0.f;
 static float UICameraSizeY = 0.f;
 AABB2 windowBounds;
 
+static std::vector<ScriptedInputEvent> GetDefaultBenchmarkInput(int numFrames);
+
 App::App()
 {
 
@@ -35,12 +43,14 @@ App::~App()
 }
 
 
-void App::Startup()
+void App::Startup(char const* commandLine)
 {
 	XmlDocument doc;
 	doc.LoadFile("Data/GameConfig.xml");
 	XmlElement* element = doc.RootElement();
 	g_gameConfigBlackboard.PopulateFromXmlElementAttributes(*element);
+	g_gameConfigBlackboard.PopulateFromCommandLine(commandLine);
+	m_isHeadless = g_gameConfigBlackboard.GetValue("headless", false);
 	UICameraSizeX = g_gameConfigBlackboard.GetValue("UICameraDimensionX", 20.f);
 	UICameraSizeY = g_gameConfigBlackboard.GetValue("UICameraDimensionY", 10.f);
 	windowBounds.SetDimensions(Vec2(UICameraSizeX, UICameraSizeY));
@@ -66,10 +76,12 @@ void App::Startup()
 	windowConfig.m_windowTitle = g_gameConfigBlackboard.GetValue("gameTitle", "untitled game");
 	windowConfig.m_clientAspect = g_gameConfigBlackboard.GetValue("windowAspect", 1.f);
 	windowConfig.m_inputSystem = g_theInput;
+	windowConfig.m_isHeadless = m_isHeadless;
 	g_theWindow = new Window(windowConfig);
 
 	RendererConfig renderConfig;
 	renderConfig.m_window = g_theWindow;
+	renderConfig.m_isHeadless = m_isHeadless;
 	g_theRenderer = new Renderer(renderConfig);
 
 	DevConsoleConfig devConsoleConfig;
@@ -78,14 +90,26 @@ void App::Startup()
 	g_theDevConsole = new DevConsole(devConsoleConfig);
 
 	AudioSystemConfig audioSystemConfig;
+	audioSystemConfig.m_isHeadless = m_isHeadless;
 	g_theAudio = new AudioSystem(audioSystemConfig);
 
+	ProfilerConfig profilerConfig;
+	profilerConfig.m_renderer = g_theRenderer;
+	if (m_isHeadless)
+	{
+		// the benchmark reads its scope timings from the history, so it has to hold every frame of the run
+		profilerConfig.m_historyFrames = g_gameConfigBlackboard.GetValue("benchmarkFrames", DEFAULT_BENCHMARK_FRAMES) + g_gameConfigBlackboard.GetValue("benchmarkWarmupFrames", DEFAULT_BENCHMARK_WARMUP_FRAMES);
+	}
+	g_theProfiler = new Profiler(profilerConfig);
+
 	g_theDevConsole->Startup();
 	g_theEventSystem->Startup();
+	FrameArenaStartup();
 	g_theInput->Startup();
 	g_theWindow->Startup();
 	g_theRenderer->Startup();
 	g_theAudio->Startup();
+	g_theProfiler->Startup();
 
 	SubscribeEventCallbackFunction("QuitApp", Event_QuitApp);
 
@@ -107,16 +131,20 @@ void App::RunFrame()
 
 void App::Shutdown()
 {
+	g_theProfiler->ShutDown();
 	g_theAudio->Shutdown();
 	g_theRenderer->Shutdown();
 	g_theWindow->Shutdown();
 	g_theInput->ShutDown();
 	g_theDevConsole->ShutDown();
+	FrameArenaShutdown();
 	g_theEventSystem->ShutDown();
 
 	delete m_theGame;
 	m_theGame = nullptr;
 
+	delete g_theProfiler;
+	g_theProfiler = nullptr;
 	delete g_theAudio;
 	g_theAudio = nullptr;
 	delete g_theRenderer;
@@ -134,6 +162,12 @@ void App::Shutdown()
 
 void App::Run()
 {
+	if (m_isHeadless)
+	{
+		RunBenchmark();
+		return;
+	}
+
 	while (!g_isQuitting)
 	{
 		RunFrame();
@@ -174,6 +208,8 @@ void App::HandleQuitRequested()
 
 void App::BeginFrame()
 {
+	g_theProfiler->BeginFrame();
+	FrameArenaBeginFrame();
 	g_theDevConsole->BeginFrame();
 	g_theEventSystem->BeginFrame();
 	g_theInput->BeginFrame();
@@ -186,6 +222,7 @@ void App::BeginFrame()
 
 void App::Update()
 {
+	PROFILE_SCOPE("Update");
 	HandleDeveloperCheatCode();
 	if (g_theDevConsole->IsOpen())
 	{
@@ -198,9 +235,11 @@ void App::Update()
 
 void App::Render() const
 {
+	PROFILE_SCOPE("Render");
 	m_theGame->Render();
 
 	g_theRenderer->BeginCamera(m_devCamera);
+	g_theProfiler->Render(windowBounds);
 	g_theDevConsole->Render(windowBounds);
 	g_theRenderer->EndCamera(m_devCamera);
 }
@@ -214,10 +253,66 @@ void App::EndFrame()
 	g_theInput->EndFrame();
 	g_theEventSystem->EndFrame();
 	g_theDevConsole->EndFrame();
+	g_theProfiler->EndFrame();
 	std::this_thread::yield();
 }
 
 
+void App::RunBenchmark()
+{
+	BenchmarkConfig benchmarkConfig;
+	benchmarkConfig.m_name = "Doomenstein";
+	benchmarkConfig.m_numFrames = g_gameConfigBlackboard.GetValue("benchmarkFrames", DEFAULT_BENCHMARK_FRAMES);
+	benchmarkConfig.m_numWarmupFrames = g_gameConfigBlackboard.GetValue("benchmarkWarmupFrames", DEFAULT_BENCHMARK_WARMUP_FRAMES);
+	benchmarkConfig.m_outputFilePath = g_gameConfigBlackboard.GetValue("benchmarkOutput", "Benchmark_Doomenstein.json");
+	benchmarkConfig.m_profiledScopes = { "Update", "Map Update", "Spawn Wave", "Update Actors", "Collide Actors", "Collide Actors With Map" };
+	BenchmarkRecorder benchmark(benchmarkConfig);
+
+	Clock::SetSystemFixedDeltaSeconds(g_gameConfigBlackboard.GetValue("benchmarkFixedDelta", 1.f / 60.f));
+	std::string inputScriptPath = g_gameConfigBlackboard.GetValue("inputScript", "");
+	if (inputScriptPath.empty())
+	{
+		g_theInput->SetInputScript(GetDefaultBenchmarkInput(benchmarkConfig.m_numWarmupFrames + benchmarkConfig.m_numFrames));
+	}
+	else if (!g_theInput->LoadInputScript(inputScriptPath))
+	{
+		ERROR_AND_DIE(Stringf("Could not load benchmark input script %s", inputScriptPath.c_str()));
+	}
+
+	while (!g_isQuitting && !benchmark.IsFinished())
+	{
+		benchmark.BeginFrame();
+		BeginFrame();
+		Update();
+		EndFrame();
+		benchmark.EndFrame();
+	}
+
+	m_theGame->AddBenchmarkCounters(benchmark);
+	if (!benchmark.WriteResults())
+	{
+		DebuggerPrintf("Could not write benchmark results to %s\n", benchmarkConfig.m_outputFilePath.c_str());
+	}
+	Clock::SetSystemFixedDeltaSeconds(0.0);
+}
+
+
+static std::vector<ScriptedInputEvent> GetDefaultBenchmarkInput(int numFrames)
+{
+	// walk from attract through the lobby into gameplay and keep firing, the taps repeat so a run that dies comes back for more waves
+	std::vector<ScriptedInputEvent> events;
+	events.push_back({ 10, KEYCODE_LEFT_MOUSE, true });
+	for (int frame = 1; frame < numFrames; frame += 600)
+	{
+		events.push_back({ frame, KEYCODE_SPACE, true });
+		events.push_back({ frame + 1, KEYCODE_SPACE, false });
+		events.push_back({ frame + 3, KEYCODE_SPACE, true });
+		events.push_back({ frame + 4, KEYCODE_SPACE, false });
+	}
+	return events;
+}
+
+
 static bool Event_QuitApp(EventArgs& args)
 {
 	UNUSED(args)
@@ -20,6 +20,8 @@
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Renderer/SimpleTriangleFont.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/Benchmark.hpp"
+#include "Engine/Core/Time.hpp"
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -60,6 +62,7 @@ Game::Game(App* const& owner)
 	LoadConfig();
 	LoadAssets();
 
+	double definitionLoadStartTime = GetCurrentTimeSeconds();
 	TileMaterialDefinition::InitializeDefinitions();
 	TileDefinition::InitializeDefinitions();
 	TileSetDefinition::InitializeDefinitions();
@@ -67,6 +70,8 @@ Game::Game(App* const& owner)
 	WeaponDefinition::InitializeDefinitions("Data/Definitions/WeaponDefinitions.xml");
 	ActorDefinition::InitializeDefinitions("Data/Definitions/ActorDefinitions.xml");
 	MapDefinition::InitializeDefinitions();
+	m_definitionLoadMilliseconds = (GetCurrentTimeSeconds() - definitionLoadStartTime) * 1000.0;
+	DebuggerPrintf("Definitions loaded in %.2fms\n", m_definitionLoadMilliseconds);
 
 	//DebugRenderSetParentClock(Clock::GetSystemClock());
 	SubscribeEventCallbackFunction("debugSpawnScreenMessage", Event_SpawnScreenMessage);
@@ -686,6 +691,14 @@ float Game::GetTotalGameTime() const
 }
 
 
+void Game::AddBenchmarkCounters(BenchmarkRecorder& benchmark) const
+{
+	benchmark.SetCounter("waves", m_currentMap ? m_currentMap->m_waveCounter : 0.0);
+	benchmark.SetCounter("liveActors", m_currentMap ? m_currentMap->GetActorCount() : 0.0);
+	benchmark.SetCounter("definitionLoadMilliseconds", m_definitionLoadMilliseconds);
+}
+
+
 Clock& Game::GetGameClock()
 {
 	return m_gameClock;
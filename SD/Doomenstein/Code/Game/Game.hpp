@@ -6,6 +6,7 @@
 #include "Game/Map.hpp"
 
 class Player;
+class BenchmarkRecorder;
 
 enum class GameMode
 {
@@ -46,6 +47,7 @@ public:
 	int GetPlayerCount() const;
 	std::vector<Player*> GetAllPlayer() const;
 	int GetAlivePlayerCount() const;
+	void AddBenchmarkCounters(BenchmarkRecorder& benchmark) const;
 
 private:
 	void RenderPausePanel() const;
@@ -70,6 +72,8 @@ private:
 	std::vector<Camera*> m_playerUICamera;
 	int m_playerCounter = 0;
 	Stopwatch m_endGameWatch;
+	// the first launch after a definition XML changes parses and cooks it, later ones read the cooked file
+	double m_definitionLoadMilliseconds = 0.0;
 };
 
 
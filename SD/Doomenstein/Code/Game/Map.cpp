@@ -10,9 +10,9 @@
 #include "Engine/Renderer/DebugRenderer.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/Profiler.hpp"
 
-constexpr int MAX_INDEX = 0x0000ffff;
-constexpr int MAX_SALT	= 0x0000fffe;
+static EventId const s_debugSpawnScreenMessageEventId("debugSpawnScreenMessage");
 
 constexpr float COUNTDOWN_TIMER = 5.f;
 
@@ -65,20 +65,13 @@ Map::~Map()
 {
 	delete m_vertexBuffer;
 	delete m_indexBuffer;
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
-	{
-		Actor*& actor = m_actors[actorIndex];
-		if (actor)
-		{
-			delete actor;
-			actor = nullptr;
-		}
-	}
+	m_actors.Clear();
 }
 
 
 void Map::Update(float deltaSeconds)
 {
+	PROFILE_SCOPE("Map Update");
 	SpawnWave();
 	UpdateActors(deltaSeconds);
 	CollideActors();
@@ -129,7 +122,7 @@ void Map::Update(float deltaSeconds)
 		EventArgs infoArgs;
 		infoArgs.SetValue("text", sunInfo);
 		infoArgs.SetValue("duration", "0.0");
-		FireEvent("debugSpawnScreenMessage", infoArgs);
+		FireEvent(s_debugSpawnScreenMessageEventId, infoArgs);
 	}
 }
 
@@ -150,9 +143,9 @@ void Map::Render(Camera const& camera)
 	g_theRenderer->BindLightConstantBuffer();
 	g_theRenderer->DrawIndexBuffer(m_vertexBuffer, m_indexBuffer, (int)m_indices.size());
 
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	for (int actorIndex = 0; actorIndex < m_actors.GetSlotCount(); actorIndex++)
 	{
-		Actor*& actor = m_actors[actorIndex];
+		Actor* actor = m_actors.GetAtSlot(actorIndex);
 		if (actor)
 		{
 			actor->Render(camera);
@@ -219,6 +212,7 @@ RaycastResultDoomenstein Map::RaycastAll(Vec3 const& start, Vec3 const& directio
 
 void Map::SpawnWave()
 {
+	PROFILE_SCOPE("Spawn Wave");
 	int demonCount = GetDemonCount();
 	if (demonCount == 0)
 	{
@@ -271,18 +265,19 @@ void Map::SpawnWave()
 
 void Map::UpdateActors(float deltaSeconds)
 {
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	PROFILE_SCOPE("Update Actors");
+	for (int actorIndex = 0; actorIndex < m_actors.GetSlotCount(); actorIndex++)
 	{
-		Actor*& actor = m_actors[actorIndex];
+		Actor* actor = m_actors.GetAtSlot(actorIndex);
 		if (actor && actor->m_controller && dynamic_cast<AI*>(actor->m_controller))
 		{
 			actor->m_controller->Update(deltaSeconds);
 		}
 	}
 
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	for (int actorIndex = 0; actorIndex < m_actors.GetSlotCount(); actorIndex++)
 	{
-		Actor*& actor = m_actors[actorIndex];
+		Actor* actor = m_actors.GetAtSlot(actorIndex);
 		if (actor)
 		{
 			actor->Update(deltaSeconds);
@@ -293,16 +288,17 @@ void Map::UpdateActors(float deltaSeconds)
 
 void Map::CollideActors()
 {
-	for (int actorAIndex = 0; actorAIndex < (int)m_actors.size() - 1; actorAIndex++)
+	PROFILE_SCOPE("Collide Actors");
+	for (int actorAIndex = 0; actorAIndex < m_actors.GetSlotCount() - 1; actorAIndex++)
 	{
-		Actor*& actorA = m_actors[actorAIndex];
+		Actor* actorA = m_actors.GetAtSlot(actorAIndex);
 		if (!actorA) continue;
 		if (actorA->m_isDead || !actorA->m_definition->m_simulated) continue;
 		if (!actorA->m_definition->m_collidesWithActors) continue;
 
-		for (int actorBIndex = actorAIndex + 1; actorBIndex < (int)m_actors.size(); actorBIndex++)
+		for (int actorBIndex = actorAIndex + 1; actorBIndex < m_actors.GetSlotCount(); actorBIndex++)
 		{
-			Actor*& actorB = m_actors[actorBIndex];
+			Actor* actorB = m_actors.GetAtSlot(actorBIndex);
 			if (!actorB) continue;
 			if (actorB->m_isDead || !actorB->m_definition->m_simulated) continue;
 			if (!actorB->m_definition->m_collidesWithActors) continue;
@@ -333,9 +329,10 @@ void Map::CollideActors(Actor* actorA, Actor* actorB)
 
 void Map::CollideActorsWithMap()
 {
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	PROFILE_SCOPE("Collide Actors With Map");
+	for (int actorIndex = 0; actorIndex < m_actors.GetSlotCount(); actorIndex++)
 	{
-		Actor*& actor = m_actors[actorIndex];
+		Actor* actor = m_actors.GetAtSlot(actorIndex);
 		if (!actor) continue;
 		if (actor->m_isDead || !actor->m_definition->m_simulated) continue;
 		if (!actor->m_definition->m_collidesWithWorld) continue;
@@ -426,62 +423,22 @@ void Map::RespawnPlayer(Player* controller)
 
 Actor* Map::SpawnActor(SpawnInfo const& spawnInfo)
 {
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
-	{
-		Actor*& actor = m_actors[actorIndex];
-		if (!actor)
-		{
-			m_actorSalt++;
-			if (m_actorSalt > MAX_SALT) m_actorSalt = 0;
-			ActorUID uid(actorIndex, m_actorSalt);
-			Actor* newActor = new Actor(this, spawnInfo);
-			newActor->m_uid = uid;
-			m_actors[actorIndex] = newActor;
-			return newActor;
-		}
-	}
-
-	if ((int)m_actors.size() < MAX_INDEX)
-	{
-		m_actorSalt++;
-		if (m_actorSalt > MAX_SALT) m_actorSalt = 0;
-		ActorUID uid((int)m_actors.size(), m_actorSalt);
-		Actor* newActor = new Actor(this, spawnInfo);
-		newActor->m_uid = uid;
-		m_actors.push_back(newActor);
-		return newActor;
-	}
-	else
-	{
-		ERROR_AND_DIE("exceeded maximum actors.");
-	}
+	ActorUID uid = m_actors.Emplace(this, spawnInfo);
+	Actor* newActor = m_actors.Get(uid);
+	newActor->m_uid = uid;
+	return newActor;
 }
 
 
 void Map::DestroyActor(ActorUID const uid)
 {
-	if (!uid.IsValid()) return;
-
-	int index = uid.GetIndex();
-	Actor*& actor = m_actors[index];
-	if (!actor) return;
-	if (actor->m_uid != uid) return;
-
-	delete actor;
-	m_actors[index] = nullptr;
+	m_actors.Remove(uid);
 }
 
 
 Actor* Map::FindActorByUID(ActorUID const uid) const
 {
-	if (!uid.IsValid()) return nullptr;
-
-	int index = uid.GetIndex();
-	Actor* actor = m_actors[index];
-	if (!actor) return nullptr;
-	if (actor->m_uid != uid) return nullptr;
-
-	return actor;
+	return m_actors.Get(uid);
 }
 
 
@@ -493,9 +450,9 @@ Actor* Map::GetClosestVisibleEnemy(Actor* actor)
 
 	RaycastResultDoomenstein best(false, Vec3::ZERO, 9999.f, Vec3::ZERO, start, direction, distance);
 
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	for (int actorIndex = 0; actorIndex < m_actors.GetSlotCount(); actorIndex++)
 	{
-		Actor* other = m_actors[actorIndex];
+		Actor* other = m_actors.GetAtSlot(actorIndex);
 
 		if (!other) continue;
 		if (other->m_isDead) continue;
@@ -570,8 +527,8 @@ void Map::PossessNextActor()
 	while (true)
 	{
 		currentPlayerIndex++;
-		if (currentPlayerIndex == (int)m_actors.size()) currentPlayerIndex = 0;
-		Actor *& actor = m_actors[currentPlayerIndex];
+		if (currentPlayerIndex == m_actors.GetSlotCount()) currentPlayerIndex = 0;
+		Actor* actor = m_actors.GetAtSlot(currentPlayerIndex);
 		if (!actor) continue;
 		if (actor->m_definition->m_canBePossessed)
 		{
@@ -582,12 +539,18 @@ void Map::PossessNextActor()
 }
 
 
+int Map::GetActorCount() const
+{
+	return m_actors.GetLiveCount();
+}
+
+
 int Map::GetDemonCount() const
 {
 	int count = 0;
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	for (int actorIndex = 0; actorIndex < m_actors.GetSlotCount(); actorIndex++)
 	{
-		Actor* actor = m_actors[actorIndex];
+		Actor* actor = m_actors.GetAtSlot(actorIndex);
 		if (!actor) continue;
 		std::string defName = actor->m_definition->m_name;
 		if (defName == "Demon" || defName == "Magma")
@@ -912,9 +875,9 @@ RaycastResultDoomenstein Map::RaycastWorldActors(Vec3 const& start, Vec3 const&
 {
 	RaycastResultDoomenstein best(false, Vec3::ZERO, 9999.f, Vec3::ZERO, start, direction, distance);
 
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	for (int actorIndex = 0; actorIndex < m_actors.GetSlotCount(); actorIndex++)
 	{
-		Actor* actor = m_actors[actorIndex];
+		Actor* actor = m_actors.GetAtSlot(actorIndex);
 
 		if (!actor) continue;
 		if (actor == filter.m_ignoreActor) continue;
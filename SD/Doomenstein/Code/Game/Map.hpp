@@ -4,6 +4,7 @@
 #include "Game/Actor.hpp"
 #include "Game/SpawnInfo.hpp"
 #include "Game/ActorUID.hpp"
+#include "Engine/Core/SlotMap.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/IntVec2.hpp"
 #include "Engine/Math/Vec3.hpp"
@@ -72,6 +73,7 @@ public:
 	std::vector<Player*> GetAllPlayerControllers() const;
 	void IncreaseKills();
 	Game* GetGame();
+	int GetActorCount() const;
 
 	void PossessNextActor();
 
@@ -91,7 +93,6 @@ protected:
 
 	// Info
 	Game* m_game = nullptr;
-	int m_actorSalt = 0x0000fffe;
 
 	// Map
 	MapDefinition const* m_definition = nullptr;
@@ -101,7 +102,7 @@ protected:
 	IntVec2 m_dimensions;
 
 	// Rendering
-	std::vector<Actor*> m_actors;
+	SlotMap<Actor> m_actors;
 	std::vector<Vertex_PNCU> m_vertices;
 	std::vector<unsigned int> m_indices;
 	const Texture* m_texture = nullptr;
@@ -1,8 +1,11 @@
 #include "Game/MapDefinition.hpp"
 #include "Game/TileSetDefinition.hpp"
+#include "Engine/Core/DefinitionCache.hpp"
 
 std::vector<MapDefinition*> MapDefinition::s_definitions;
 
+constexpr uint32_t MAP_COOK_VERSION = 1;
+
 bool MapDefinition::LoadFromXmlElement(const XmlElement& element)
 {
 	m_name						= ParseXmlAttribute(element, "name", "none");
@@ -32,26 +35,49 @@ bool MapDefinition::LoadFromXmlElement(const XmlElement& element)
 }
 
 
-void MapDefinition::InitializeDefinitions()
+void MapDefinition::WriteCooked(BufferWriter& writer) const
 {
-	XmlDocument doc;
-	doc.LoadFile("Data/Definitions/MapDefinitions.xml");
-	XmlElement const* root = doc.RootElement();
+	writer.AppendStringZeroTerminated(m_name);
+	// the image is only named, its texels are read from the file again
+	writer.AppendStringZeroTerminated(m_image ? m_image->GetImageFilePath() : "");
+	writer.AppendStringZeroTerminated(m_tileSetDefinition ? m_tileSetDefinition->m_name : "");
+	writer.AppendUint32((uint32_t)m_spawnInfos.size());
+	for (int spawnInfoIndex = 0; spawnInfoIndex < (int)m_spawnInfos.size(); spawnInfoIndex++)
+	{
+		m_spawnInfos[spawnInfoIndex].WriteCooked(writer);
+	}
+}
+
 
-	XmlElement const* element = root->FirstChildElement();
-	while (element)
+void MapDefinition::ReadCooked(BufferParser& parser)
+{
+	m_name = parser.ParseStringZeroTerminated();
+	std::string imageName = parser.ParseStringZeroTerminated();
+	std::string tileSetDefName = parser.ParseStringZeroTerminated();
+	if (!imageName.empty()) m_image = new Image(imageName.c_str());
+	if (!tileSetDefName.empty()) m_tileSetDefinition = TileSetDefinition::GetByName(tileSetDefName);
+
+	int numSpawnInfos = (int)parser.ParseUint32();
+	m_spawnInfos.resize(numSpawnInfos);
+	for (int spawnInfoIndex = 0; spawnInfoIndex < numSpawnInfos; spawnInfoIndex++)
 	{
-		if (std::string(element->Name()) == "MapDefinition")
-		{
-			MapDefinition* newMapDef = new MapDefinition();
-			newMapDef->LoadFromXmlElement(*element);
-			MapDefinition::s_definitions.push_back(newMapDef);
-			element = element->NextSiblingElement();
-		}
+		m_spawnInfos[spawnInfoIndex].ReadCooked(parser);
 	}
 }
 
 
+void MapDefinition::InitializeDefinitions()
+{
+	LoadOrCookDefinitions("Data/Definitions/MapDefinitions.xml", MAP_COOK_VERSION, s_definitions, [](XmlElement const& element) -> MapDefinition*
+	{
+		if (std::string(element.Name()) != "MapDefinition") return nullptr;
+		MapDefinition* newMapDef = new MapDefinition();
+		newMapDef->LoadFromXmlElement(element);
+		return newMapDef;
+	});
+}
+
+
 void MapDefinition::ClearDefinitions()
 {
 	for (int mapDefIndex = 0; mapDefIndex < (int)s_definitions.size(); mapDefIndex++)
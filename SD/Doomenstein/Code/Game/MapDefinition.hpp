@@ -8,6 +8,8 @@
 #include <vector>
 
 //------------------------------------------------------------------------------------------------
+class BufferParser;
+class BufferWriter;
 class TileSetDefinition;
 
 //------------------------------------------------------------------------------------------------
@@ -15,6 +17,8 @@ class MapDefinition
 {
 public:
 	bool LoadFromXmlElement( const XmlElement& element );
+	void WriteCooked( BufferWriter& writer ) const;
+	void ReadCooked( BufferParser& parser );
 
 public:
 	std::string m_name;
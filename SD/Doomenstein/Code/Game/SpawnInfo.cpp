@@ -1,5 +1,6 @@
 #include "Game/SpawnInfo.hpp"
 #include "Game/ActorDefinition.hpp"
+#include "Engine/Core/BufferUtils.hpp"
 
 SpawnInfo::SpawnInfo()
 {
@@ -35,3 +36,27 @@ bool SpawnInfo::LoadFromXmlElement(XmlElement const& element)
 }
 
 
+void SpawnInfo::WriteCooked(BufferWriter& writer) const
+{
+	writer.AppendStringZeroTerminated(m_definition ? m_definition->m_name : "");
+	writer.AppendVec3(m_position);
+	writer.AppendFloat(m_orientation.m_yawDegrees);
+	writer.AppendFloat(m_orientation.m_pitchDegrees);
+	writer.AppendFloat(m_orientation.m_rollDegrees);
+	writer.AppendVec3(m_velocity);
+}
+
+
+void SpawnInfo::ReadCooked(BufferParser& parser)
+{
+	std::string actorName = parser.ParseStringZeroTerminated();
+	m_position = parser.ParseVec3();
+	m_orientation.m_yawDegrees = parser.ParseFloat();
+	m_orientation.m_pitchDegrees = parser.ParseFloat();
+	m_orientation.m_rollDegrees = parser.ParseFloat();
+	m_velocity = parser.ParseVec3();
+
+	if (!actorName.empty()) m_definition = ActorDefinition::GetByName(actorName);
+}
+
+
@@ -2,6 +2,8 @@
 #include "Game/GameCommon.hpp"
 
 class ActorDefinition;
+class BufferParser;
+class BufferWriter;
 
 //------------------------------------------------------------------------------------------------
 class SpawnInfo
@@ -12,6 +14,8 @@ public:
 	SpawnInfo( char const* definitionName, Vec3 const& position = Vec3::ZERO, EulerAngles const& orientation = EulerAngles::ZERO, Vec3 const& velocity = Vec3::ZERO );
 
 	bool LoadFromXmlElement( XmlElement const& element );
+	void WriteCooked( BufferWriter& writer ) const;
+	void ReadCooked( BufferParser& parser );
 
 	const ActorDefinition* m_definition = nullptr;
 	Vec3 m_position = Vec3::ZERO;
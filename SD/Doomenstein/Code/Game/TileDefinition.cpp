@@ -1,8 +1,11 @@
 #include "Game/TileDefinition.hpp"
 #include "Game/TileMaterialDefinition.hpp"
+#include "Engine/Core/DefinitionCache.hpp"
 
 std::vector<TileDefinition*> TileDefinition::s_definitions;
 
+constexpr uint32_t TILE_COOK_VERSION = 1;
+
 bool TileDefinition::LoadFromXmlElement(const XmlElement& element)
 {
 	m_name								= ParseXmlAttribute(element, "name", "none");
@@ -18,23 +21,40 @@ bool TileDefinition::LoadFromXmlElement(const XmlElement& element)
 }
 
 
-void TileDefinition::InitializeDefinitions()
+void TileDefinition::WriteCooked(BufferWriter& writer) const
 {
-	XmlDocument doc;
-	doc.LoadFile("Data/Definitions/TileDefinitions.xml");
-	XmlElement const* root = doc.RootElement();
+	writer.AppendStringZeroTerminated(m_name);
+	writer.AppendBool(m_isSolid);
+	// materials go by name, so a material table cooked apart from this one still lines up
+	writer.AppendStringZeroTerminated(m_ceilingMaterialDefinition ? m_ceilingMaterialDefinition->m_name : "");
+	writer.AppendStringZeroTerminated(m_floorMaterialDefinition ? m_floorMaterialDefinition->m_name : "");
+	writer.AppendStringZeroTerminated(m_wallMaterialDefinition ? m_wallMaterialDefinition->m_name : "");
+}
+
+
+void TileDefinition::ReadCooked(BufferParser& parser)
+{
+	m_name = parser.ParseStringZeroTerminated();
+	m_isSolid = parser.ParseBool();
+	std::string ceilingMaterialName = parser.ParseStringZeroTerminated();
+	std::string floorMaterialName = parser.ParseStringZeroTerminated();
+	std::string wallMaterialName = parser.ParseStringZeroTerminated();
+
+	if (!ceilingMaterialName.empty()) m_ceilingMaterialDefinition = TileMaterialDefinition::GetByName(ceilingMaterialName);
+	if (!floorMaterialName.empty()) m_floorMaterialDefinition = TileMaterialDefinition::GetByName(floorMaterialName);
+	if (!wallMaterialName.empty()) m_wallMaterialDefinition = TileMaterialDefinition::GetByName(wallMaterialName);
+}
+
 
-	XmlElement const* element = root->FirstChildElement();
-	while (element)
+void TileDefinition::InitializeDefinitions()
+{
+	LoadOrCookDefinitions("Data/Definitions/TileDefinitions.xml", TILE_COOK_VERSION, s_definitions, [](XmlElement const& element) -> TileDefinition*
 	{
-		if (std::string(element->Name()) == "TileDefinition")
-		{
-			TileDefinition* newTileDef = new TileDefinition();
-			newTileDef->LoadFromXmlElement(*element);
-			TileDefinition::s_definitions.push_back(newTileDef);
-			element = element->NextSiblingElement();
-		}
-	}
+		if (std::string(element.Name()) != "TileDefinition") return nullptr;
+		TileDefinition* newTileDef = new TileDefinition();
+		newTileDef->LoadFromXmlElement(element);
+		return newTileDef;
+	});
 }
 
 
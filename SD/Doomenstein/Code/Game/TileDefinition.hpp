@@ -3,6 +3,8 @@
 #include <string>
 
 //------------------------------------------------------------------------------------------------
+class BufferParser;
+class BufferWriter;
 class TileMaterialDefinition;
 
 //------------------------------------------------------------------------------------------------
@@ -10,6 +12,8 @@ class TileDefinition
 {
 public:
 	bool LoadFromXmlElement( const XmlElement& element );
+	void WriteCooked( BufferWriter& writer ) const;
+	void ReadCooked( BufferParser& parser );
 
 public:
 	std::string m_name;
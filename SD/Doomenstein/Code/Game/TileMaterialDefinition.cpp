@@ -1,7 +1,10 @@
 #include "Game/TileMaterialDefinition.hpp"
+#include "Engine/Core/DefinitionCache.hpp"
 
 std::vector<TileMaterialDefinition*> TileMaterialDefinition::s_definitions;
 
+constexpr uint32_t TILE_MATERIAL_COOK_VERSION = 1;
+
 bool TileMaterialDefinition::LoadFromXmlElement(const XmlElement& element)
 {
 	m_name			= ParseXmlAttribute(element, "name", "none");
@@ -21,23 +24,40 @@ bool TileMaterialDefinition::LoadFromXmlElement(const XmlElement& element)
 }
 
 
-void TileMaterialDefinition::InitializeDefinitions()
+void TileMaterialDefinition::WriteCooked(BufferWriter& writer) const
 {
-	XmlDocument doc;
-	doc.LoadFile("Data/Definitions/TileMaterialDefinitions.xml");
-	XmlElement const* root = doc.RootElement();
+	writer.AppendStringZeroTerminated(m_name);
+	writer.AppendBool(m_isVisible);
+	writer.AppendVec2(m_uv.m_mins);
+	writer.AppendVec2(m_uv.m_maxs);
+	// resources go by name and are looked up again on load
+	writer.AppendStringZeroTerminated(m_shader ? m_shader->GetName() : "");
+	writer.AppendStringZeroTerminated(m_texture ? m_texture->GetImageFilePath() : "");
+}
+
+
+void TileMaterialDefinition::ReadCooked(BufferParser& parser)
+{
+	m_name = parser.ParseStringZeroTerminated();
+	m_isVisible = parser.ParseBool();
+	m_uv.m_mins = parser.ParseVec2();
+	m_uv.m_maxs = parser.ParseVec2();
+	std::string shaderName = parser.ParseStringZeroTerminated();
+	std::string textureName = parser.ParseStringZeroTerminated();
+	if (!shaderName.empty()) m_shader = g_theRenderer->GetShaderForName(shaderName.c_str());
+	if (!textureName.empty()) m_texture = g_theRenderer->CreateOrGetTextureFromFile(textureName.c_str());
+}
 
-	XmlElement const* element = root->FirstChildElement();
-	while (element)
+
+void TileMaterialDefinition::InitializeDefinitions()
+{
+	LoadOrCookDefinitions("Data/Definitions/TileMaterialDefinitions.xml", TILE_MATERIAL_COOK_VERSION, s_definitions, [](XmlElement const& element) -> TileMaterialDefinition*
 	{
-		if (std::string(element->Name()) == "TileMaterialDefinition")
-		{
-			TileMaterialDefinition* newMaterialTileDef = new TileMaterialDefinition();
-			newMaterialTileDef->LoadFromXmlElement(*element);
-			TileMaterialDefinition::s_definitions.push_back(newMaterialTileDef);
-			element = element->NextSiblingElement();
-		}
-	}
+		if (std::string(element.Name()) != "TileMaterialDefinition") return nullptr;
+		TileMaterialDefinition* newMaterialTileDef = new TileMaterialDefinition();
+		newMaterialTileDef->LoadFromXmlElement(element);
+		return newMaterialTileDef;
+	});
 }
 
 
@@ -6,6 +6,8 @@
 #include <string>
 
 //------------------------------------------------------------------------------------------------
+class BufferParser;
+class BufferWriter;
 class Shader;
 class Texture;
 
@@ -14,6 +16,8 @@ class TileMaterialDefinition
 {
 public:
 	bool LoadFromXmlElement( const XmlElement& element );
+	void WriteCooked( BufferWriter& writer ) const;
+	void ReadCooked( BufferParser& parser );
 
 public:
 	std::string m_name;
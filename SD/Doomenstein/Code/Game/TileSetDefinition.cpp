@@ -1,8 +1,11 @@
 #include "Game/TileSetDefinition.hpp"
 #include "Game/TileDefinition.hpp"
+#include "Engine/Core/DefinitionCache.hpp"
 
 std::vector<TileSetDefinition*> TileSetDefinition::s_definitions;
 
+constexpr uint32_t TILE_SET_COOK_VERSION = 1;
+
 bool TileMapping::LoadFromXmlElement(const XmlElement& element)
 {
 	m_color					= ParseXmlAttribute(element, "color", Rgba8::WHITE);
@@ -34,6 +37,38 @@ bool TileSetDefinition::LoadFromXmlElement(const XmlElement& element)
 }
 
 
+void TileSetDefinition::WriteCooked(BufferWriter& writer) const
+{
+	writer.AppendStringZeroTerminated(m_name);
+	writer.AppendStringZeroTerminated(m_defaultTile ? m_defaultTile->m_name : "");
+	writer.AppendUint32((uint32_t)m_mappings.size());
+	for (int tileMappingIndex = 0; tileMappingIndex < (int)m_mappings.size(); tileMappingIndex++)
+	{
+		TileMapping const& tileMapping = m_mappings[tileMappingIndex];
+		writer.AppendRgba8(tileMapping.m_color);
+		writer.AppendStringZeroTerminated(tileMapping.m_tileDefinition ? tileMapping.m_tileDefinition->m_name : "");
+	}
+}
+
+
+void TileSetDefinition::ReadCooked(BufferParser& parser)
+{
+	m_name = parser.ParseStringZeroTerminated();
+	std::string defaultTileName = parser.ParseStringZeroTerminated();
+	if (!defaultTileName.empty()) m_defaultTile = TileDefinition::GetByName(defaultTileName);
+
+	int numMappings = (int)parser.ParseUint32();
+	m_mappings.resize(numMappings);
+	for (int tileMappingIndex = 0; tileMappingIndex < numMappings; tileMappingIndex++)
+	{
+		TileMapping& tileMapping = m_mappings[tileMappingIndex];
+		tileMapping.m_color = parser.ParseRgba8();
+		std::string tileName = parser.ParseStringZeroTerminated();
+		if (!tileName.empty()) tileMapping.m_tileDefinition = TileDefinition::GetByName(tileName);
+	}
+}
+
+
 const TileDefinition* TileSetDefinition::GetTileDefinitionByColor(const Rgba8& color) const
 {
 	for (int tileMappingIndex = 0; tileMappingIndex < (int)m_mappings.size(); tileMappingIndex++)
@@ -51,21 +86,13 @@ const TileDefinition* TileSetDefinition::GetTileDefinitionByColor(const Rgba8& c
 
 void TileSetDefinition::InitializeDefinitions()
 {
-	XmlDocument doc;
-	doc.LoadFile("Data/Definitions/TileSetDefinitions.xml");
-	XmlElement const* root = doc.RootElement();
-
-	XmlElement const* element = root->FirstChildElement();
-	while (element)
+	LoadOrCookDefinitions("Data/Definitions/TileSetDefinitions.xml", TILE_SET_COOK_VERSION, s_definitions, [](XmlElement const& element) -> TileSetDefinition*
 	{
-		if (std::string(element->Name()) == "TileSetDefinition")
-		{
-			TileSetDefinition* newTileSetDef = new TileSetDefinition();
-			newTileSetDef->LoadFromXmlElement(*element);
-			TileSetDefinition::s_definitions.push_back(newTileSetDef);
-			element = element->NextSiblingElement();
-		}
-	}
+		if (std::string(element.Name()) != "TileSetDefinition") return nullptr;
+		TileSetDefinition* newTileSetDef = new TileSetDefinition();
+		newTileSetDef->LoadFromXmlElement(element);
+		return newTileSetDef;
+	});
 }
 
 
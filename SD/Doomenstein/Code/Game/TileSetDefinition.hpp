@@ -4,6 +4,8 @@
 #include <string>
 
 //------------------------------------------------------------------------------------------------
+class BufferParser;
+class BufferWriter;
 class TileDefinition;
 
 //------------------------------------------------------------------------------------------------
@@ -20,6 +22,8 @@ class TileSetDefinition
 {
 public:
 	bool LoadFromXmlElement( const XmlElement& element );
+	void WriteCooked( BufferWriter& writer ) const;
+	void ReadCooked( BufferParser& parser );
 
 	const TileDefinition* GetTileDefinitionByColor( const Rgba8& color ) const;
 
@@ -45,6 +45,9 @@ AudioSystem::~AudioSystem()
 //------------------------------------------------------------------------------------------------
 void AudioSystem::Startup()
 {
+	MEMORY_TAG_SCOPE(m_config.m_memoryTag);
+	if (m_config.m_isHeadless) return;
+
 	FMOD_RESULT result;
 	result = FMOD::System_Create( &m_fmodSystem );
 	ValidateResult( result );
@@ -57,6 +60,8 @@ void AudioSystem::Startup()
 //------------------------------------------------------------------------------------------------
 void AudioSystem::Shutdown()
 {
+	if (!m_fmodSystem) return;
+
 	FMOD_RESULT result = m_fmodSystem->release();
 	ValidateResult( result );
 
@@ -67,6 +72,8 @@ void AudioSystem::Shutdown()
 //-----------------------------------------------------------------------------------------------
 void AudioSystem::BeginFrame()
 {
+	MEMORY_TAG_SCOPE(m_config.m_memoryTag);
+	if (!m_fmodSystem) return;
 	m_fmodSystem->update();
 }
 
@@ -79,12 +86,14 @@ void AudioSystem::EndFrame()
 
 void AudioSystem::SetNumListeners(int numListeners)
 {
+	if (!m_fmodSystem) return;
 	m_fmodSystem->set3DNumListeners(numListeners);
 }
 
 
 void AudioSystem::UpdateListener(int listenerIndex, const Vec3& listenerPosition, const Vec3& listenerForward, const Vec3& listenerUp)
 {
+	if (!m_fmodSystem) return;
 	FMOD_VECTOR pos = {};
 	pos.x = -listenerPosition.y;
 	pos.y = listenerPosition.z;
@@ -105,6 +114,9 @@ void AudioSystem::UpdateListener(int listenerIndex, const Vec3& listenerPosition
 //-----------------------------------------------------------------------------------------------
 SoundID AudioSystem::CreateOrGetSound( const std::string& soundFilePath )
 {
+	MEMORY_TAG_SCOPE(m_config.m_memoryTag);
+	if (!m_fmodSystem) return MISSING_SOUND_ID;
+
 	std::map< std::string, SoundID >::iterator found = m_registeredSoundIDs.find( soundFilePath );
 	if( found != m_registeredSoundIDs.end() )
 	{
@@ -197,6 +209,8 @@ SoundPlaybackID AudioSystem::StartSoundAt(SoundID soundID, const Vec3& soundPosi
 
 void AudioSystem::SetSoundPosition(SoundPlaybackID soundPlaybackID, const Vec3& soundPosition)
 {
+	if (!m_fmodSystem) return;
+
 	if (soundPlaybackID == MISSING_SOUND_ID)
 	{
 		ERROR_RECOVERABLE("WARNING: attempt to set volume on missing sound playback ID!");
@@ -236,6 +250,9 @@ bool AudioSystem::IsPlaying(SoundPlaybackID soundPlaybackID) const
 //-----------------------------------------------------------------------------------------------
 void AudioSystem::StopSound( SoundPlaybackID soundPlaybackID )
 {
+	if( !m_fmodSystem )
+		return;
+
 	if( soundPlaybackID == MISSING_SOUND_ID )
 	{
 		ERROR_RECOVERABLE( "WARNING: attempt to stop sound on missing sound playback ID!" );
@@ -252,6 +269,9 @@ void AudioSystem::StopSound( SoundPlaybackID soundPlaybackID )
 //
 void AudioSystem::SetSoundPlaybackVolume( SoundPlaybackID soundPlaybackID, float volume )
 {
+	if( !m_fmodSystem )
+		return;
+
 	if( soundPlaybackID == MISSING_SOUND_ID )
 	{
 		ERROR_RECOVERABLE( "WARNING: attempt to set volume on missing sound playback ID!" );
@@ -268,6 +288,9 @@ void AudioSystem::SetSoundPlaybackVolume( SoundPlaybackID soundPlaybackID, float
 //
 void AudioSystem::SetSoundPlaybackBalance( SoundPlaybackID soundPlaybackID, float balance )
 {
+	if( !m_fmodSystem )
+		return;
+
 	if( soundPlaybackID == MISSING_SOUND_ID )
 	{
 		ERROR_RECOVERABLE( "WARNING: attempt to set balance on missing sound playback ID!" );
@@ -286,6 +309,9 @@ void AudioSystem::SetSoundPlaybackBalance( SoundPlaybackID soundPlaybackID, floa
 //
 void AudioSystem::SetSoundPlaybackSpeed( SoundPlaybackID soundPlaybackID, float speed )
 {
+	if( !m_fmodSystem )
+		return;
+
 	if( soundPlaybackID == MISSING_SOUND_ID )
 	{
 		ERROR_RECOVERABLE( "WARNING: attempt to set speed on missing sound playback ID!" );
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/Math/Vec3.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 
 //-----------------------------------------------------------------------------------------------
 #include "ThirdParty/fmod/fmod.hpp"
@@ -21,7 +22,9 @@ class AudioSystem;
 /////////////////////////////////////////////////////////////////////////////////////////////////
 struct AudioSystemConfig
 {
-
+	MemoryTag m_memoryTag = MEMORY_TAG_AUDIO;
+	// FMOD is never started, sounds come back as MISSING_SOUND_ID and every call on them is ignored
+	bool m_isHeadless = false;
 };
 
 
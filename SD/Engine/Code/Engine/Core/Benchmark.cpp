@@ -0,0 +1,131 @@
+#include "Engine/Core/Benchmark.hpp"
+#include "Engine/Core/Clock.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+
+static double GetSortedPercentile(std::vector<double> const& sortedValues, int percentile);
+
+
+BenchmarkRecorder::BenchmarkRecorder(BenchmarkConfig const& config)
+	: m_config(config)
+{
+	m_frameMilliseconds.reserve(m_config.m_numFrames);
+}
+
+
+void BenchmarkRecorder::BeginFrame()
+{
+	// profiler history is drained a frame late, so the one warmup frame it still holds is within noise
+	if (m_frameIndex == m_config.m_numWarmupFrames && g_theProfiler)
+	{
+		g_theProfiler->ResetHistory();
+	}
+	m_frameStartSeconds = GetCurrentTimeSeconds();
+	if (m_frameIndex == m_config.m_numWarmupFrames)
+	{
+		m_timedStartSeconds = m_frameStartSeconds;
+	}
+}
+
+
+void BenchmarkRecorder::EndFrame()
+{
+	double frameEndSeconds = GetCurrentTimeSeconds();
+	if (m_frameIndex >= m_config.m_numWarmupFrames)
+	{
+		m_frameMilliseconds.push_back((frameEndSeconds - m_frameStartSeconds) * 1000.0);
+		m_timedEndSeconds = frameEndSeconds;
+	}
+	m_frameIndex++;
+}
+
+
+bool BenchmarkRecorder::IsFinished() const
+{
+	return (int)m_frameMilliseconds.size() >= m_config.m_numFrames;
+}
+
+
+int BenchmarkRecorder::GetFrameIndex() const
+{
+	return m_frameIndex;
+}
+
+
+void BenchmarkRecorder::SetCounter(std::string const& name, double value)
+{
+	for (int counterIndex = 0; counterIndex < (int)m_counters.size(); counterIndex++)
+	{
+		if (m_counters[counterIndex].m_name == name)
+		{
+			m_counters[counterIndex].m_value = value;
+			return;
+		}
+	}
+	BenchmarkCounter counter;
+	counter.m_name = name;
+	counter.m_value = value;
+	m_counters.push_back(counter);
+}
+
+
+bool BenchmarkRecorder::WriteResults() const
+{
+	std::vector<double> sortedMilliseconds = m_frameMilliseconds;
+	std::sort(sortedMilliseconds.begin(), sortedMilliseconds.end());
+	double totalMilliseconds = 0.0;
+	for (int frameIndex = 0; frameIndex < (int)sortedMilliseconds.size(); frameIndex++)
+	{
+		totalMilliseconds += sortedMilliseconds[frameIndex];
+	}
+	int numTimedFrames = (int)sortedMilliseconds.size();
+	double averageMilliseconds = numTimedFrames > 0 ? totalMilliseconds / static_cast<double>(numTimedFrames) : 0.0;
+
+	std::string json = "{\n";
+	json += Stringf("\t\"name\": \"%s\",\n", m_config.m_name.c_str());
+	json += Stringf("\t\"frames\": %d,\n", numTimedFrames);
+	json += Stringf("\t\"warmupFrames\": %d,\n", m_config.m_numWarmupFrames);
+	json += Stringf("\t\"fixedDeltaSeconds\": %.6f,\n", Clock::GetSystemFixedDeltaSeconds());
+	json += Stringf("\t\"wallSeconds\": %.3f,\n", m_timedEndSeconds - m_timedStartSeconds);
+	json += "\t\"frameMilliseconds\": {";
+	json += Stringf("\"min\": %.3f, \"average\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f},\n",
+		numTimedFrames > 0 ? sortedMilliseconds.front() : 0.0, averageMilliseconds, GetSortedPercentile(sortedMilliseconds, 50), GetSortedPercentile(sortedMilliseconds, 90),
+		GetSortedPercentile(sortedMilliseconds, 95), GetSortedPercentile(sortedMilliseconds, 99), numTimedFrames > 0 ? sortedMilliseconds.back() : 0.0);
+
+	json += "\t\"scopes\": {";
+	for (int scopeIndex = 0; scopeIndex < (int)m_config.m_profiledScopes.size(); scopeIndex++)
+	{
+		ProfileScopeStats stats;
+		if (g_theProfiler)
+		{
+			stats = g_theProfiler->GetScopeStats(m_config.m_profiledScopes[scopeIndex].c_str());
+		}
+		json += Stringf("%s\n\t\t\"%s\": {\"frames\": %d, \"calls\": %d, \"min\": %.3f, \"average\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+			scopeIndex == 0 ? "" : ",", m_config.m_profiledScopes[scopeIndex].c_str(), stats.m_numberFrames, stats.m_numberCalls,
+			stats.m_minMilliseconds, stats.m_averageMilliseconds, stats.m_p99Milliseconds, stats.m_maxMilliseconds);
+	}
+	json += m_config.m_profiledScopes.empty() ? "},\n" : "\n\t},\n";
+
+	json += "\t\"counters\": {";
+	for (int counterIndex = 0; counterIndex < (int)m_counters.size(); counterIndex++)
+	{
+		json += Stringf("%s\n\t\t\"%s\": %.3f", counterIndex == 0 ? "" : ",", m_counters[counterIndex].m_name.c_str(), m_counters[counterIndex].m_value);
+	}
+	json += m_counters.empty() ? "}\n" : "\n\t}\n";
+	json += "}\n";
+
+	std::vector<uint8_t> buffer(json.begin(), json.end());
+	return FileWriteFromBuffer(buffer, m_config.m_outputFilePath) == 0;
+}
+
+
+static double GetSortedPercentile(std::vector<double> const& sortedValues, int percentile)
+{
+	if (sortedValues.empty()) return 0.0;
+	return sortedValues[((int)sortedValues.size() - 1) * percentile / 100];
+}
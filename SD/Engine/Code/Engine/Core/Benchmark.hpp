@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+
+struct BenchmarkConfig
+{
+	std::string m_name = "Benchmark";
+	int m_numFrames = 600;
+	// run but not timed, lets first frame loads and the first wave of jobs settle
+	int m_numWarmupFrames = 60;
+	std::string m_outputFilePath = "Benchmark.json";
+	// profiler scopes reported as per frame totals, needs a profiler whose history holds every timed frame
+	std::vector<std::string> m_profiledScopes;
+};
+
+
+// times whole frames for a fixed number of frames and writes the result as JSON,
+// BeginFrame/EndFrame go around everything the app does in a frame
+class BenchmarkRecorder
+{
+public:
+	BenchmarkRecorder(BenchmarkConfig const& config);
+
+	void BeginFrame();
+	void EndFrame();
+	bool IsFinished() const;
+	int GetFrameIndex() const;
+
+	// end of run values worth keeping next to the timings, e.g. how many chunks or actors the scenario got to
+	void SetCounter(std::string const& name, double value);
+
+	bool WriteResults() const;
+
+private:
+	struct BenchmarkCounter
+	{
+		std::string m_name;
+		double m_value = 0.0;
+	};
+
+	BenchmarkConfig m_config;
+	int m_frameIndex = 0;
+	double m_frameStartSeconds = 0.0;
+	double m_timedStartSeconds = 0.0;
+	double m_timedEndSeconds = 0.0;
+	std::vector<double> m_frameMilliseconds;
+	std::vector<BenchmarkCounter> m_counters;
+};
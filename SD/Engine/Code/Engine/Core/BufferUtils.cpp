@@ -1,5 +1,9 @@
 #include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Core/Compression.hpp"
 
+#include <emmintrin.h>
+#include <math.h>
+#include <string.h>
 #include <utility>
 //
 // buffer writer
@@ -27,6 +31,12 @@ void BufferWriter::AppendChar(char data)
 }
 
 
+void BufferWriter::AppendBytes(void const* data, int numBytes)
+{
+	memcpy(GrowBy(numBytes), data, numBytes);
+}
+
+
 void BufferWriter::AppendByte(unsigned char data)
 {
 	m_buffer.push_back(data);
@@ -90,11 +100,8 @@ void BufferWriter::AppendBool(bool data)
 
 void BufferWriter::AppendStringZeroTerminated(std::string const& data)
 {
-	for (int index = 0; index < (int)data.size(); index++)
-	{
-		m_buffer.push_back(data[index]);
-	}
-	m_buffer.push_back('\0');
+	// c_str includes the terminator
+	AppendBytes(data.c_str(), (int)data.size() + 1);
 }
 
 
@@ -102,65 +109,172 @@ void BufferWriter::AppendStringAfter32BitLength(std::string const& data)
 {
 	uint32_t size = (uint32_t)data.size();
 	AppendUint32(size);
-	for (int index = 0; index < (int)size; index++)
-	{
-		m_buffer.push_back(data[index]);
-	}
+	AppendBytes(data.data(), (int)size);
 }
 
 
 void BufferWriter::AppendVec2(Vec2 const& data)
 {
-	AppendFloat(data.x);
-	AppendFloat(data.y);
+	AppendArray(&data, 1);
 }
 
 
 void BufferWriter::AppendVec3(Vec3 const& data)
 {
-	AppendFloat(data.x);
-	AppendFloat(data.y);
-	AppendFloat(data.z);
+	AppendArray(&data, 1);
 }
 
 
 void BufferWriter::AppendIntVec2(IntVec2 const& data)
 {
-	AppendInt32(data.x);
-	AppendInt32(data.y);
+	AppendArray(&data, 1);
 }
 
 
 void BufferWriter::AppendIntVec3(IntVec3 const& data)
 {
-	AppendInt32(data.x);
-	AppendInt32(data.y);
-	AppendInt32(data.z);
+	AppendArray(&data, 1);
 }
 
 
 void BufferWriter::AppendRgb8(Rgba8 const& data)
 {
-	AppendByte(data.r);
-	AppendByte(data.g);
-	AppendByte(data.b);
+	AppendBytes(&data, 3);
 }
 
 
 void BufferWriter::AppendRgba8(Rgba8 const& data)
 {
-	AppendByte(data.r);
-	AppendByte(data.g);
-	AppendByte(data.b);
-	AppendByte(data.a);
+	AppendBytes(&data, 4);
 }
 
 
+// position, color and uvs back to back, the same bytes as the struct when the endianess matches
+static_assert(sizeof(Vertex_PCU) == 24, "Vertex_PCU is written as its memory, padding would change the format");
+
 void BufferWriter::AppendVertexPCU(Vertex_PCU const& data)
 {
-	AppendVec3(data.m_position);
-	AppendRgba8(data.m_color);
-	AppendVec2(data.m_uvTexCoords);
+	AppendVertexPCUArray(&data, 1);
+}
+
+
+void BufferWriter::AppendVertexPCUArray(Vertex_PCU const* data, int count)
+{
+	if (!m_isOppositeEndianess)
+	{
+		AppendBytes(data, count * (int)sizeof(Vertex_PCU));
+		return;
+	}
+
+	unsigned char* vertexBytes = GrowBy(count * (int)sizeof(Vertex_PCU));
+	memcpy(vertexBytes, data, count * sizeof(Vertex_PCU));
+	for (int vertexIndex = 0; vertexIndex < count; vertexIndex++)
+	{
+		unsigned char* vertex = vertexBytes + vertexIndex * sizeof(Vertex_PCU);
+		SwapBytesInPlace(vertex, 3, 4);
+		SwapBytesInPlace(vertex + 16, 2, 4);
+	}
+}
+
+
+void BufferWriter::Reserve(int numBytes)
+{
+	size_t requiredCapacity = m_buffer.size() + numBytes;
+	if (m_buffer.capacity() >= requiredCapacity) return;
+
+	// never less than doubling, so reserving in small steps does not cost a copy each time
+	size_t doubledCapacity = m_buffer.capacity() * 2;
+	m_buffer.reserve(requiredCapacity > doubledCapacity ? requiredCapacity : doubledCapacity);
+}
+
+
+void BufferWriter::AppendVarUint32(uint32_t data)
+{
+	AppendVarUint64(data);
+}
+
+
+void BufferWriter::AppendVarUint64(uint64_t data)
+{
+	// a 64 bit value takes at most 10 bytes, built on the stack and appended in one go
+	unsigned char bytes[10];
+	int numBytes = 0;
+	while (data >= 0x80)
+	{
+		bytes[numBytes] = (unsigned char)(data | 0x80);
+		data >>= 7;
+		numBytes++;
+	}
+	bytes[numBytes] = (unsigned char)data;
+	numBytes++;
+	AppendBytes(bytes, numBytes);
+}
+
+
+void BufferWriter::AppendVarInt32(int32_t data)
+{
+	AppendVarUint64(ZigZagEncode32(data));
+}
+
+
+void BufferWriter::AppendVarInt64(int64_t data)
+{
+	AppendVarUint64(ZigZagEncode64(data));
+}
+
+
+void BufferWriter::AppendVarIntVec2(IntVec2 const& data)
+{
+	AppendVarInt32(data.x);
+	AppendVarInt32(data.y);
+}
+
+
+void BufferWriter::AppendVarIntVec3(IntVec3 const& data)
+{
+	AppendVarInt32(data.x);
+	AppendVarInt32(data.y);
+	AppendVarInt32(data.z);
+}
+
+
+void BufferWriter::AppendDeltaUint32Array(uint32_t const* data, int count)
+{
+	AppendVarUint32((uint32_t)count);
+	uint32_t previousValue = 0;
+	for (int valueIndex = 0; valueIndex < count; valueIndex++)
+	{
+		// unsigned wrap around, so a value smaller than the one before still round trips, it just takes 5 bytes
+		AppendVarUint32(data[valueIndex] - previousValue);
+		previousValue = data[valueIndex];
+	}
+}
+
+
+void BufferWriter::AppendQuantizedFloat(float data, float precision)
+{
+	AppendVarInt64(llround((double)data / (double)precision));
+}
+
+
+void BufferWriter::AppendQuantizedVec2(Vec2 const& data, float precision)
+{
+	AppendQuantizedFloat(data.x, precision);
+	AppendQuantizedFloat(data.y, precision);
+}
+
+
+void BufferWriter::AppendQuantizedVec3(Vec3 const& data, float precision)
+{
+	AppendQuantizedFloat(data.x, precision);
+	AppendQuantizedFloat(data.y, precision);
+	AppendQuantizedFloat(data.z, precision);
+}
+
+
+void BufferWriter::AppendCompressed(void const* data, int numBytes)
+{
+	CompressFrame(data, numBytes, m_buffer);
 }
 
 
@@ -202,9 +316,7 @@ void BufferWriter::AppendTwoBytes(unsigned short& data)
 	{
 		SwapTwoBytesInPlace(data);
 	}
-	unsigned char* value = (unsigned char*) &data;
-	m_buffer.push_back(value[0]);
-	m_buffer.push_back(value[1]);
+	memcpy(GrowBy(2), &data, 2);
 }
 
 
@@ -214,11 +326,7 @@ void BufferWriter::AppendFourBytes(uint32_t& data)
 	{
 		SwapFourBytesInPlace(data);
 	}
-	unsigned char* value = (unsigned char*) &data;
-	m_buffer.push_back(value[0]);
-	m_buffer.push_back(value[1]);
-	m_buffer.push_back(value[2]);
-	m_buffer.push_back(value[3]);
+	memcpy(GrowBy(4), &data, 4);
 }
 
 
@@ -228,15 +336,26 @@ void BufferWriter::AppendEightBytes(uint64_t& data)
 	{
 		SwapEightBytesInPlace(data);
 	}
-	unsigned char* value = (unsigned char*) &data;
-	m_buffer.push_back(value[0]);
-	m_buffer.push_back(value[1]);
-	m_buffer.push_back(value[2]);
-	m_buffer.push_back(value[3]);
-	m_buffer.push_back(value[4]);
-	m_buffer.push_back(value[5]);
-	m_buffer.push_back(value[6]);
-	m_buffer.push_back(value[7]);
+	memcpy(GrowBy(8), &data, 8);
+}
+
+
+void BufferWriter::AppendArrayBytes(void const* data, int numBytes, int swapSize)
+{
+	unsigned char* destination = GrowBy(numBytes);
+	memcpy(destination, data, numBytes);
+	if (m_isOppositeEndianess && swapSize > 1)
+	{
+		SwapBytesInPlace(destination, numBytes / swapSize, swapSize);
+	}
+}
+
+
+unsigned char* BufferWriter::GrowBy(int numBytes)
+{
+	size_t oldSize = m_buffer.size();
+	m_buffer.resize(oldSize + numBytes);
+	return m_buffer.data() + oldSize;
 }
 
 
@@ -244,8 +363,19 @@ void BufferWriter::AppendEightBytes(uint64_t& data)
 //	buffer parser
 //
 
-BufferParser::BufferParser(std::vector<unsigned char>& buffer)
-	:m_buffer(buffer)
+BufferParser::BufferParser(std::vector<unsigned char> const& buffer)
+	:m_bufferData(buffer.data())
+	,m_bufferSize((int)buffer.size())
+{
+	m_currentOffset = 0;
+	m_nativeEndianess = GetNativeEndianess();
+	m_endianMode = m_nativeEndianess;
+}
+
+
+BufferParser::BufferParser(unsigned char const* data, int size)
+	:m_bufferData(data)
+	,m_bufferSize(size)
 {
 	m_currentOffset = 0;
 	m_nativeEndianess = GetNativeEndianess();
@@ -262,7 +392,7 @@ void BufferParser::SetEndianMode(eBufferEndian endianMode)
 
 char BufferParser::ParseChar()
 {
-	char out = (char)m_buffer[m_currentOffset];
+	char out = (char)m_bufferData[m_currentOffset];
 	m_currentOffset++;
 	return out;
 }
@@ -270,7 +400,7 @@ char BufferParser::ParseChar()
 
 unsigned char BufferParser::ParseByte()
 {
-	unsigned char out = m_buffer[m_currentOffset];
+	unsigned char out = m_bufferData[m_currentOffset];
 	m_currentOffset++;
 	return out;
 }
@@ -328,7 +458,7 @@ double BufferParser::ParseDouble()
 
 bool BufferParser::ParseBool()
 {
-	char out = (char)m_buffer[m_currentOffset];
+	char out = (char)m_bufferData[m_currentOffset];
 	m_currentOffset++;
 	return out ? true : false;
 }
@@ -336,13 +466,9 @@ bool BufferParser::ParseBool()
 
 std::string BufferParser::ParseStringZeroTerminated()
 {
-	std::string out = "";
-	while (m_buffer[m_currentOffset] != '\0')
-	{
-		out.push_back(m_buffer[m_currentOffset]);
-		m_currentOffset++;
-	}
-	m_currentOffset++;
+	char const* start = (char const*)m_bufferData + m_currentOffset;
+	std::string out(start);
+	m_currentOffset += (uint32_t)out.size() + 1;
 	return out;
 }
 
@@ -351,7 +477,7 @@ std::string BufferParser::ParseStringAfter32BitLength()
 {
 	uint32_t size = ParseUint32();
 	std::string out;
-	out.assign(&m_buffer[m_currentOffset], &m_buffer[m_currentOffset] + size);
+	out.assign((char const*)m_bufferData + m_currentOffset, size);
 	m_currentOffset += size;
 	return out;
 }
@@ -359,35 +485,33 @@ std::string BufferParser::ParseStringAfter32BitLength()
 
 Vec2 BufferParser::ParseVec2()
 {
-	float x = ParseFloat();
-	float y = ParseFloat();
-	return Vec2(x, y);
+	Vec2 out;
+	ParseArray(&out, 1);
+	return out;
 }
 
 
 Vec3 BufferParser::ParseVec3()
 {
-	float x = ParseFloat();
-	float y = ParseFloat();
-	float z = ParseFloat();
-	return Vec3(x, y, z);
+	Vec3 out;
+	ParseArray(&out, 1);
+	return out;
 }
 
 
 IntVec2 BufferParser::ParseIntVec2()
 {
-	int x = ParseInt32();
-	int y = ParseInt32();
-	return IntVec2(x, y);
+	IntVec2 out;
+	ParseArray(&out, 1);
+	return out;
 }
 
 
 IntVec3 BufferParser::ParseIntVec3()
 {
-	int x = ParseInt32();
-	int y = ParseInt32();
-	int z = ParseInt32();
-	return IntVec3(x, y, z);
+	IntVec3 out;
+	ParseArray(&out, 1);
+	return out;
 }
 
 
@@ -412,10 +536,135 @@ Rgba8 BufferParser::ParseRgba8()
 
 Vertex_PCU BufferParser::ParseVertexPCU()
 {
-	Vec3 position = ParseVec3();
-	Rgba8 color = ParseRgba8();
-	Vec2 uvs = ParseVec2();
-	return Vertex_PCU(position, color, uvs);
+	Vertex_PCU out;
+	ParseVertexPCUArray(&out, 1);
+	return out;
+}
+
+
+void BufferParser::ParseVertexPCUArray(Vertex_PCU* outData, int count)
+{
+	ParseBytes(outData, count * (int)sizeof(Vertex_PCU));
+	if (!m_isOppositeEndianess) return;
+
+	for (int vertexIndex = 0; vertexIndex < count; vertexIndex++)
+	{
+		unsigned char* vertex = (unsigned char*)&outData[vertexIndex];
+		SwapBytesInPlace(vertex, 3, 4);
+		SwapBytesInPlace(vertex + 16, 2, 4);
+	}
+}
+
+
+void BufferParser::ParseBytes(void* outData, int numBytes)
+{
+	memcpy(outData, m_bufferData + m_currentOffset, numBytes);
+	m_currentOffset += numBytes;
+}
+
+
+uint32_t BufferParser::ParseVarUint32()
+{
+	return (uint32_t)ParseVarUint64();
+}
+
+
+uint64_t BufferParser::ParseVarUint64()
+{
+	uint64_t out = 0;
+	int shift = 0;
+	// stops at the end of the buffer, so a cut off value cannot read past it
+	while (m_currentOffset < (uint32_t)m_bufferSize && shift < 64)
+	{
+		unsigned char byte = m_bufferData[m_currentOffset];
+		m_currentOffset++;
+		out |= (uint64_t)(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0) break;
+		shift += 7;
+	}
+	return out;
+}
+
+
+int32_t BufferParser::ParseVarInt32()
+{
+	return ZigZagDecode32((uint32_t)ParseVarUint64());
+}
+
+
+int64_t BufferParser::ParseVarInt64()
+{
+	return ZigZagDecode64(ParseVarUint64());
+}
+
+
+IntVec2 BufferParser::ParseVarIntVec2()
+{
+	int x = ParseVarInt32();
+	int y = ParseVarInt32();
+	return IntVec2(x, y);
+}
+
+
+IntVec3 BufferParser::ParseVarIntVec3()
+{
+	int x = ParseVarInt32();
+	int y = ParseVarInt32();
+	int z = ParseVarInt32();
+	return IntVec3(x, y, z);
+}
+
+
+bool BufferParser::ParseDeltaUint32Array(std::vector<uint32_t>& outData)
+{
+	uint32_t count = ParseVarUint32();
+	// every gap takes at least a byte, so a longer count is corrupt and would resize to gigabytes
+	if (count > (uint32_t)GetRemainingSize())
+	{
+		outData.clear();
+		return false;
+	}
+	outData.resize(count);
+	uint32_t value = 0;
+	for (uint32_t valueIndex = 0; valueIndex < count; valueIndex++)
+	{
+		value += ParseVarUint32();
+		outData[valueIndex] = value;
+	}
+	return true;
+}
+
+
+float BufferParser::ParseQuantizedFloat(float precision)
+{
+	return (float)((double)ParseVarInt64() * (double)precision);
+}
+
+
+Vec2 BufferParser::ParseQuantizedVec2(float precision)
+{
+	float x = ParseQuantizedFloat(precision);
+	float y = ParseQuantizedFloat(precision);
+	return Vec2(x, y);
+}
+
+
+Vec3 BufferParser::ParseQuantizedVec3(float precision)
+{
+	float x = ParseQuantizedFloat(precision);
+	float y = ParseQuantizedFloat(precision);
+	float z = ParseQuantizedFloat(precision);
+	return Vec3(x, y, z);
+}
+
+
+bool BufferParser::ParseCompressed(std::vector<unsigned char>& outData)
+{
+	outData.clear();
+	int frameSize = DecompressFrame(m_bufferData + m_currentOffset, GetRemainingSize(), outData);
+	if (frameSize < 0) return false;
+	m_currentOffset += frameSize;
+	return true;
 }
 
 
@@ -427,14 +676,14 @@ void BufferParser::SetCurrentOffset(uint32_t offset)
 
 int BufferParser::GetRemainingSize() const
 {
-	return (int)m_buffer.size() - m_currentOffset;
+	return m_bufferSize - (int)m_currentOffset;
 }
 
 
 unsigned short BufferParser::ParseTwoBytes()
 {
 	unsigned short out;
-	memcpy(&out, &m_buffer[m_currentOffset], sizeof(unsigned short));
+	memcpy(&out, &m_bufferData[m_currentOffset], sizeof(unsigned short));
 	m_currentOffset += 2;
 	if (m_isOppositeEndianess)
 	{
@@ -447,7 +696,7 @@ unsigned short BufferParser::ParseTwoBytes()
 uint32_t BufferParser::ParseFourBytes()
 {
 	uint32_t out;
-	memcpy(&out, &m_buffer[m_currentOffset], sizeof(uint32_t));
+	memcpy(&out, &m_bufferData[m_currentOffset], sizeof(uint32_t));
 	m_currentOffset += 4;
 	if (m_isOppositeEndianess)
 	{
@@ -460,7 +709,7 @@ uint32_t BufferParser::ParseFourBytes()
 uint64_t BufferParser::ParseEightBytes()
 {
 	uint64_t out;
-	memcpy(&out, &m_buffer[m_currentOffset], sizeof(uint64_t));
+	memcpy(&out, &m_bufferData[m_currentOffset], sizeof(uint64_t));
 	m_currentOffset += 8;
 	if (m_isOppositeEndianess)
 	{
@@ -470,6 +719,16 @@ uint64_t BufferParser::ParseEightBytes()
 }
 
 
+void BufferParser::ParseArrayBytes(void* outData, int numBytes, int swapSize)
+{
+	ParseBytes(outData, numBytes);
+	if (m_isOppositeEndianess && swapSize > 1)
+	{
+		SwapBytesInPlace((unsigned char*)outData, numBytes / swapSize, swapSize);
+	}
+}
+
+
 eBufferEndian GetNativeEndianess()
 {
 	union IntChars
@@ -516,3 +775,62 @@ void SwapEightBytesInPlace(uint64_t& data)
 }
 
 
+// reverses the bytes inside each 16 bit lane
+static __m128i SwapBytesInLanes(__m128i data)
+{
+	return _mm_or_si128(_mm_slli_epi16(data, 8), _mm_srli_epi16(data, 8));
+}
+
+
+void SwapBytesInPlace(unsigned char* data, int numElements, int elementSize)
+{
+	// 16 bytes at a time with SSE2, which every x86 and x64 target has, the tail goes through the scalar swaps
+	int numBytes = numElements * elementSize;
+	int numVectorBytes = numBytes & ~15;
+	for (int byteIndex = 0; byteIndex < numVectorBytes; byteIndex += 16)
+	{
+		__m128i block = _mm_loadu_si128((__m128i const*)(data + byteIndex));
+		if (elementSize == 4)
+		{
+			block = _mm_shufflehi_epi16(_mm_shufflelo_epi16(block, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+		}
+		else if (elementSize == 8)
+		{
+			block = _mm_shufflehi_epi16(_mm_shufflelo_epi16(block, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+		}
+		_mm_storeu_si128((__m128i*)(data + byteIndex), SwapBytesInLanes(block));
+	}
+
+	for (int byteIndex = numVectorBytes; byteIndex < numBytes; byteIndex += elementSize)
+	{
+		unsigned char* element = data + byteIndex;
+		for (int swapIndex = 0; swapIndex < elementSize / 2; swapIndex++)
+		{
+			std::swap(element[swapIndex], element[elementSize - 1 - swapIndex]);
+		}
+	}
+}
+
+
+uint32_t ZigZagEncode32(int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+
+uint64_t ZigZagEncode64(int64_t value)
+{
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+
+int32_t ZigZagDecode32(uint32_t value)
+{
+	return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+
+int64_t ZigZagDecode64(uint64_t value)
+{
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <string>
+#include <type_traits>
 
 enum class eBufferEndian
 {
@@ -16,6 +17,21 @@ enum class eBufferEndian
 	BIG,
 };
 
+
+// AppendArray and ParseArray copy these as they sit in memory, SWAP_SIZE is the size of the fields swapped for the opposite endianess
+template <typename T>
+struct BufferElementTraits
+{
+	static_assert(std::is_arithmetic<T>::value, "AppendArray and ParseArray need a number type or a type with BufferElementTraits");
+	static constexpr int SWAP_SIZE = (int)sizeof(T);
+};
+
+template <> struct BufferElementTraits<Vec2>		{ static constexpr int SWAP_SIZE = 4; };
+template <> struct BufferElementTraits<Vec3>		{ static constexpr int SWAP_SIZE = 4; };
+template <> struct BufferElementTraits<IntVec2>		{ static constexpr int SWAP_SIZE = 4; };
+template <> struct BufferElementTraits<IntVec3>		{ static constexpr int SWAP_SIZE = 4; };
+template <> struct BufferElementTraits<Rgba8>		{ static constexpr int SWAP_SIZE = 1; };
+
 class BufferWriter
 {
 public:
@@ -43,6 +59,41 @@ public:
 	void AppendRgb8(Rgba8 const& data);
 	void AppendRgba8(Rgba8 const& data);
 	void AppendVertexPCU(Vertex_PCU const& data);
+	void AppendVertexPCUArray(Vertex_PCU const* data, int count);
+	void AppendBytes(void const* data, int numBytes);
+
+	// one copy for the whole array when the endianess matches, swapped with SSE2 when it does not
+	template <typename T>
+	inline void AppendArray(T const* data, int count)
+	{
+		AppendArrayBytes(data, count * (int)sizeof(T), BufferElementTraits<T>::SWAP_SIZE);
+	}
+
+	template <typename T>
+	inline void AppendArray(std::vector<T> const& data)
+	{
+		AppendArray(data.data(), (int)data.size());
+	}
+
+	// room for this many more bytes, so a writer that knows its size up front grows the buffer once
+	void Reserve(int numBytes);
+
+	// LEB128, 7 bits a byte so values below 128 take one byte, the same bytes in either endian mode
+	void AppendVarUint32(uint32_t data);
+	void AppendVarUint64(uint64_t data);
+	// zigzag encoded first, so small negative values stay short too
+	void AppendVarInt32(int32_t data);
+	void AppendVarInt64(int64_t data);
+	void AppendVarIntVec2(IntVec2 const& data);
+	void AppendVarIntVec3(IntVec3 const& data);
+	// the count, the first value, then the gap to each next value, ascending values keep the gaps short
+	void AppendDeltaUint32Array(uint32_t const* data, int count);
+	// rounded to a multiple of precision and written as a zigzag varint, 0.01 keeps a position to a centimeter
+	void AppendQuantizedFloat(float data, float precision);
+	void AppendQuantizedVec2(Vec2 const& data, float precision);
+	void AppendQuantizedVec3(Vec3 const& data, float precision);
+	// a compressed frame from Compression.hpp, its sizes are little endian in either endian mode
+	void AppendCompressed(void const* data, int numBytes);
 
 	void UpdateUInt32AtOffset(uint32_t& data, uint32_t offset);
 	int GetAppendedSize() const;
@@ -53,6 +104,8 @@ private:
 	void AppendTwoBytes(unsigned short& data);
 	void AppendFourBytes(uint32_t& data);
 	void AppendEightBytes(uint64_t& data);
+	void AppendArrayBytes(void const* data, int numBytes, int swapSize);
+	unsigned char* GrowBy(int numBytes);
 
 protected:
 	std::vector<unsigned char>& m_buffer;
@@ -65,7 +118,9 @@ protected:
 class BufferParser
 {
 public:
-	BufferParser(std::vector<unsigned char>& buffer);
+	BufferParser(std::vector<unsigned char> const& buffer);
+	// any memory that outlives the parser, such as a MappedFile or a received packet
+	BufferParser(unsigned char const* data, int size);
 	~BufferParser() {}
 	
 	void			SetEndianMode(eBufferEndian endianMode);
@@ -89,6 +144,42 @@ public:
 	Rgba8			ParseRgb8();
 	Rgba8			ParseRgba8();
 	Vertex_PCU		ParseVertexPCU();
+	void			ParseVertexPCUArray(Vertex_PCU* outData, int count);
+	void			ParseBytes(void* outData, int numBytes);
+	uint32_t		ParseVarUint32();
+	uint64_t		ParseVarUint64();
+	int32_t			ParseVarInt32();
+	int64_t			ParseVarInt64();
+	IntVec2			ParseVarIntVec2();
+	IntVec3			ParseVarIntVec3();
+	// false and outData cleared if the count is larger than what is left of the buffer
+	bool			ParseDeltaUint32Array(std::vector<uint32_t>& outData);
+	// precision has to match the one the value was written with
+	float			ParseQuantizedFloat(float precision);
+	Vec2			ParseQuantizedVec2(float precision);
+	Vec3			ParseQuantizedVec3(float precision);
+	// replaces outData with the frame, false and nothing parsed if it is cut off or fails its checksum
+	bool			ParseCompressed(std::vector<unsigned char>& outData);
+
+	template <typename T>
+	inline void ParseArray(T* outData, int count)
+	{
+		ParseArrayBytes(outData, count * (int)sizeof(T), BufferElementTraits<T>::SWAP_SIZE);
+	}
+
+	// false and outData cleared if count elements do not fit in what is left of the buffer
+	template <typename T>
+	inline bool ParseArray(std::vector<T>& outData, int count)
+	{
+		if (count < 0 || (size_t)count * sizeof(T) > (size_t)GetRemainingSize())
+		{
+			outData.clear();
+			return false;
+		}
+		outData.resize(count);
+		ParseArray(outData.data(), count);
+		return true;
+	}
 
 	void SetCurrentOffset(uint32_t offset);
 	int GetRemainingSize() const;
@@ -97,9 +188,11 @@ private:
 	unsigned short ParseTwoBytes();
 	uint32_t ParseFourBytes();
 	uint64_t ParseEightBytes();
+	void ParseArrayBytes(void* outData, int numBytes, int swapSize);
 
 protected:
-	std::vector<unsigned char>& m_buffer;
+	unsigned char const* m_bufferData = nullptr;
+	int m_bufferSize = 0;
 	uint32_t m_currentOffset = 0;
 	eBufferEndian m_nativeEndianess = eBufferEndian::NATIVE;
 	eBufferEndian m_endianMode = eBufferEndian::NATIVE;
@@ -111,5 +204,12 @@ eBufferEndian GetNativeEndianess();
 void SwapTwoBytesInPlace(unsigned short& data);
 void SwapFourBytesInPlace(uint32_t& data);
 void SwapEightBytesInPlace(uint64_t& data);
+// reverses the bytes of each of numElements elements of elementSize 2, 4 or 8 bytes
+void SwapBytesInPlace(unsigned char* data, int numElements, int elementSize);
+// maps 0, -1, 1, -2, 2 ... to 0, 1, 2, 3, 4 ...
+uint32_t ZigZagEncode32(int32_t value);
+uint64_t ZigZagEncode64(int64_t value);
+int32_t ZigZagDecode32(uint32_t value);
+int64_t ZigZagDecode64(uint64_t value);
 
 
@@ -2,6 +2,7 @@
 #include "Engine/Core/Time.hpp"
 
 Clock g_systemClock;
+static double s_systemFixedDeltaSeconds = 0.0;
 
 Clock::Clock()
 {
@@ -101,10 +102,28 @@ double Clock::GetTimeDilation() const
 
 void Clock::SystemBeginFrame()
 {
+	if (s_systemFixedDeltaSeconds > 0.0)
+	{
+		g_systemClock.m_lastUpdateTime = GetCurrentTimeSeconds();
+		g_systemClock.Advance(s_systemFixedDeltaSeconds);
+		return;
+	}
 	g_systemClock.Tick();
 }
 
 
+void Clock::SetSystemFixedDeltaSeconds(double fixedDeltaSeconds)
+{
+	s_systemFixedDeltaSeconds = fixedDeltaSeconds;
+}
+
+
+double Clock::GetSystemFixedDeltaSeconds()
+{
+	return s_systemFixedDeltaSeconds;
+}
+
+
 Clock& Clock::GetSystemClock()
 {
 	return g_systemClock;
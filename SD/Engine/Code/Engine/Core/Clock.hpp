@@ -26,6 +26,9 @@ public:
 public:
 	static void	SystemBeginFrame();
 	static Clock& GetSystemClock();
+	// every system frame advances by exactly this much instead of the measured time, 0 goes back to real time
+	static void	SetSystemFixedDeltaSeconds(double fixedDeltaSeconds);
+	static double GetSystemFixedDeltaSeconds();
 
 protected:
 	void		Tick();
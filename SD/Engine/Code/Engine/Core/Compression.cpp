@@ -0,0 +1,598 @@
+#include "Engine/Core/Compression.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <string.h>
+
+// a match is a 16 bit offset, so it reaches back 64KB at most
+constexpr int COMPRESSION_MAX_OFFSET = 65535;
+constexpr int COMPRESSION_HASH_BITS = 12;
+// the block always ends in literals, and no match starts this close to the end, so the decoder can copy in whole words
+constexpr int COMPRESSION_LAST_LITERALS = 5;
+constexpr int COMPRESSION_MATCH_SEARCH_LIMIT = 12;
+
+constexpr unsigned char COMPRESSION_FRAME_VERSION = 1;
+constexpr int COMPRESSION_FRAME_HEADER_SIZE = 4;
+// stored size, raw size and checksum
+constexpr int COMPRESSION_BLOCK_HEADER_SIZE = 12;
+constexpr uint32_t COMPRESSION_STORED_RAW_FLAG = 0x80000000u;
+
+static unsigned char const s_frameMagic[COMPRESSION_FRAME_HEADER_SIZE] = { 'E', 'C', 'Z', COMPRESSION_FRAME_VERSION };
+
+
+static inline uint32_t ReadNativeUint32(unsigned char const* data)
+{
+	uint32_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+
+static inline uint64_t ReadNativeUint64(unsigned char const* data)
+{
+	uint64_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+
+static inline uint32_t ReadLittleEndianUint32(unsigned char const* data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+
+static inline void WriteLittleEndianUint32(unsigned char* data, uint32_t value)
+{
+	data[0] = (unsigned char)value;
+	data[1] = (unsigned char)(value >> 8);
+	data[2] = (unsigned char)(value >> 16);
+	data[3] = (unsigned char)(value >> 24);
+}
+
+
+static inline uint32_t HashSequence(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - COMPRESSION_HASH_BITS);
+}
+
+
+static inline uint32_t RotateLeft32(uint32_t value, int bits)
+{
+	return (value << bits) | (value >> (32 - bits));
+}
+
+
+//
+//	block
+//
+
+int GetMaxCompressedSize(int inputSize)
+{
+	return inputSize + inputSize / 255 + 16;
+}
+
+
+// lengths of 15 and up go on in extra bytes of 255 until one is less
+static inline unsigned char* WriteLengthExtension(unsigned char* output, int length)
+{
+	while (length >= 255)
+	{
+		*output++ = 255;
+		length -= 255;
+	}
+	*output++ = (unsigned char)length;
+	return output;
+}
+
+
+// a token with both lengths, the literals, then the offset of the match, a match length of 0 is the last sequence
+static unsigned char* WriteSequence(unsigned char* output, unsigned char const* outputEnd, unsigned char const* literals, int numLiterals, int offset, int matchLength)
+{
+	int neededSize = 1 + numLiterals + numLiterals / 255 + 1;
+	if (matchLength > 0)
+	{
+		neededSize += 2 + (matchLength - COMPRESSION_MIN_MATCH) / 255 + 1;
+	}
+	if (outputEnd - output < neededSize) return nullptr;
+
+	int matchCode = matchLength > 0 ? matchLength - COMPRESSION_MIN_MATCH : 0;
+	unsigned char* token = output++;
+	*token = (unsigned char)(((numLiterals < 15 ? numLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+	if (numLiterals >= 15)
+	{
+		output = WriteLengthExtension(output, numLiterals - 15);
+	}
+	if (numLiterals > 0)
+	{
+		memcpy(output, literals, numLiterals);
+		output += numLiterals;
+	}
+
+	if (matchLength > 0)
+	{
+		*output++ = (unsigned char)offset;
+		*output++ = (unsigned char)(offset >> 8);
+		if (matchCode >= 15)
+		{
+			output = WriteLengthExtension(output, matchCode - 15);
+		}
+	}
+	return output;
+}
+
+
+int CompressBlock(unsigned char const* input, int inputSize, unsigned char* output, int outputCapacity)
+{
+	if (inputSize < 0 || outputCapacity <= 0) return 0;
+
+	unsigned char* outputPosition = output;
+	unsigned char const* outputEnd = output + outputCapacity;
+	int anchor = 0;
+
+	if (inputSize > COMPRESSION_MATCH_SEARCH_LIMIT)
+	{
+		// last position each hashed 4 bytes were seen, one probe and no chains, that is what keeps it fast
+		int hashTable[1 << COMPRESSION_HASH_BITS];
+		memset(hashTable, 0xff, sizeof(hashTable));
+
+		int matchSearchEnd = inputSize - COMPRESSION_MATCH_SEARCH_LIMIT;
+		int matchEnd = inputSize - COMPRESSION_LAST_LITERALS;
+		int position = 0;
+		int numMisses = 0;
+		while (position < matchSearchEnd)
+		{
+			uint32_t sequence = ReadNativeUint32(input + position);
+			uint32_t hash = HashSequence(sequence);
+			int candidate = hashTable[hash];
+			hashTable[hash] = position;
+			if (candidate < 0 || position - candidate > COMPRESSION_MAX_OFFSET || ReadNativeUint32(input + candidate) != sequence)
+			{
+				// steps further the longer nothing matches, so data that does not compress goes by quickly
+				position += 1 + (numMisses++ >> 6);
+				continue;
+			}
+			numMisses = 0;
+
+			// the match may have started before the bytes that were hashed
+			while (position > anchor && candidate > 0 && input[position - 1] == input[candidate - 1])
+			{
+				position--;
+				candidate--;
+			}
+
+			int matchLength = COMPRESSION_MIN_MATCH;
+			while (position + matchLength + 8 <= matchEnd && ReadNativeUint64(input + position + matchLength) == ReadNativeUint64(input + candidate + matchLength))
+			{
+				matchLength += 8;
+			}
+			while (position + matchLength < matchEnd && input[position + matchLength] == input[candidate + matchLength])
+			{
+				matchLength++;
+			}
+
+			outputPosition = WriteSequence(outputPosition, outputEnd, input + anchor, position - anchor, position - candidate, matchLength);
+			if (!outputPosition) return 0;
+			position += matchLength;
+			anchor = position;
+
+			// matches tend to follow matches, so the end of this one is worth remembering
+			if (position - 2 < matchSearchEnd)
+			{
+				hashTable[HashSequence(ReadNativeUint32(input + position - 2))] = position - 2;
+			}
+		}
+	}
+
+	outputPosition = WriteSequence(outputPosition, outputEnd, input + anchor, inputSize - anchor, 0, 0);
+	if (!outputPosition) return 0;
+	return (int)(outputPosition - output);
+}
+
+
+static inline bool ReadLengthExtension(unsigned char const*& input, unsigned char const* inputEnd, size_t& length)
+{
+	unsigned char byte = 0;
+	do
+	{
+		if (input >= inputEnd) return false;
+		byte = *input++;
+		length += byte;
+	} while (byte == 255);
+	return true;
+}
+
+
+int DecompressBlock(unsigned char const* input, int inputSize, unsigned char* output, int outputCapacity)
+{
+	if (inputSize < 0 || outputCapacity < 0) return -1;
+
+	unsigned char const* inputPosition = input;
+	unsigned char const* inputEnd = input + inputSize;
+	unsigned char* outputPosition = output;
+	unsigned char* outputEnd = output + outputCapacity;
+
+	while (inputPosition < inputEnd)
+	{
+		unsigned char token = *inputPosition++;
+
+		size_t numLiterals = token >> 4;
+		if (numLiterals == 15 && !ReadLengthExtension(inputPosition, inputEnd, numLiterals)) return -1;
+		if (numLiterals > (size_t)(inputEnd - inputPosition) || numLiterals > (size_t)(outputEnd - outputPosition)) return -1;
+		// most runs are short, one 16 byte copy covers them when both buffers have room past the run
+		if (numLiterals <= 16 && inputEnd - inputPosition >= 16 && outputEnd - outputPosition >= 16)
+		{
+			memcpy(outputPosition, inputPosition, 16);
+		}
+		else if (numLiterals > 0)
+		{
+			memcpy(outputPosition, inputPosition, numLiterals);
+		}
+		inputPosition += numLiterals;
+		outputPosition += numLiterals;
+
+		// only the last sequence has no match
+		if (inputPosition == inputEnd) break;
+
+		if (inputEnd - inputPosition < 2) return -1;
+		size_t offset = (size_t)inputPosition[0] | ((size_t)inputPosition[1] << 8);
+		inputPosition += 2;
+		if (offset == 0 || offset > (size_t)(outputPosition - output)) return -1;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadLengthExtension(inputPosition, inputEnd, matchLength)) return -1;
+		matchLength += COMPRESSION_MIN_MATCH;
+		if (matchLength > (size_t)(outputEnd - outputPosition)) return -1;
+
+		unsigned char const* match = outputPosition - offset;
+		unsigned char* matchOutputEnd = outputPosition + matchLength;
+		if (offset >= 8 && (size_t)(outputEnd - outputPosition) >= matchLength + 8)
+		{
+			// 8 bytes at a time may run up to 7 past the match, which the next sequence writes over anyway
+			do
+			{
+				memcpy(outputPosition, match, 8);
+				outputPosition += 8;
+				match += 8;
+			} while (outputPosition < matchOutputEnd);
+			outputPosition = matchOutputEnd;
+		}
+		else
+		{
+			// a close match overlaps what it is copying, which is how a run of one byte repeats
+			while (outputPosition < matchOutputEnd)
+			{
+				*outputPosition++ = *match++;
+			}
+		}
+	}
+	return (int)(outputPosition - output);
+}
+
+
+uint32_t ComputeChecksum32(void const* data, int size, uint32_t seed)
+{
+	uint32_t const PRIME_1 = 2654435761u;
+	uint32_t const PRIME_2 = 2246822519u;
+	uint32_t const PRIME_3 = 3266489917u;
+	uint32_t const PRIME_4 = 668265263u;
+	uint32_t const PRIME_5 = 374761393u;
+
+	unsigned char const* bytes = static_cast<unsigned char const*>(data);
+	unsigned char const* bytesEnd = bytes + size;
+	uint32_t hash = 0;
+
+	if (size >= 16)
+	{
+		// four independent lanes so the multiplies overlap
+		uint32_t lane0 = seed + PRIME_1 + PRIME_2;
+		uint32_t lane1 = seed + PRIME_2;
+		uint32_t lane2 = seed;
+		uint32_t lane3 = seed - PRIME_1;
+		unsigned char const* stripesEnd = bytesEnd - 16;
+		do
+		{
+			lane0 = RotateLeft32(lane0 + ReadLittleEndianUint32(bytes) * PRIME_2, 13) * PRIME_1;
+			lane1 = RotateLeft32(lane1 + ReadLittleEndianUint32(bytes + 4) * PRIME_2, 13) * PRIME_1;
+			lane2 = RotateLeft32(lane2 + ReadLittleEndianUint32(bytes + 8) * PRIME_2, 13) * PRIME_1;
+			lane3 = RotateLeft32(lane3 + ReadLittleEndianUint32(bytes + 12) * PRIME_2, 13) * PRIME_1;
+			bytes += 16;
+		} while (bytes <= stripesEnd);
+		hash = RotateLeft32(lane0, 1) + RotateLeft32(lane1, 7) + RotateLeft32(lane2, 12) + RotateLeft32(lane3, 18);
+	}
+	else
+	{
+		hash = seed + PRIME_5;
+	}
+
+	hash += (uint32_t)size;
+	while (bytesEnd - bytes >= 4)
+	{
+		hash = RotateLeft32(hash + ReadLittleEndianUint32(bytes) * PRIME_3, 17) * PRIME_4;
+		bytes += 4;
+	}
+	while (bytes < bytesEnd)
+	{
+		hash = RotateLeft32(hash + (*bytes) * PRIME_5, 11) * PRIME_1;
+		bytes++;
+	}
+
+	hash ^= hash >> 15;
+	hash *= PRIME_2;
+	hash ^= hash >> 13;
+	hash *= PRIME_3;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+
+//
+//	frame
+//
+
+CompressionStream::CompressionStream(std::vector<unsigned char>& outFrame)
+	:m_frame(outFrame)
+{
+	m_frame.insert(m_frame.end(), s_frameMagic, s_frameMagic + COMPRESSION_FRAME_HEADER_SIZE);
+}
+
+
+CompressionStream::~CompressionStream()
+{
+	Finish();
+}
+
+
+void CompressionStream::Write(void const* data, int numBytes)
+{
+	if (m_isFinished) return;
+
+	unsigned char const* bytes = static_cast<unsigned char const*>(data);
+	while (numBytes > 0)
+	{
+		// whole blocks go straight from the caller when nothing is waiting
+		if (m_pendingBytes.empty() && numBytes >= COMPRESSION_BLOCK_SIZE)
+		{
+			WriteBlock(bytes, COMPRESSION_BLOCK_SIZE);
+			bytes += COMPRESSION_BLOCK_SIZE;
+			numBytes -= COMPRESSION_BLOCK_SIZE;
+			continue;
+		}
+
+		int numPendingBytes = (int)m_pendingBytes.size();
+		int numCopied = COMPRESSION_BLOCK_SIZE - numPendingBytes;
+		if (numCopied > numBytes)
+		{
+			numCopied = numBytes;
+		}
+		m_pendingBytes.insert(m_pendingBytes.end(), bytes, bytes + numCopied);
+		bytes += numCopied;
+		numBytes -= numCopied;
+
+		if ((int)m_pendingBytes.size() == COMPRESSION_BLOCK_SIZE)
+		{
+			WriteBlock(m_pendingBytes.data(), COMPRESSION_BLOCK_SIZE);
+			m_pendingBytes.clear();
+		}
+	}
+}
+
+
+void CompressionStream::Finish()
+{
+	if (m_isFinished) return;
+
+	if (!m_pendingBytes.empty())
+	{
+		WriteBlock(m_pendingBytes.data(), (int)m_pendingBytes.size());
+		m_pendingBytes.clear();
+	}
+
+	// a stored size of 0 ends the frame
+	unsigned char endMark[4] = {};
+	m_frame.insert(m_frame.end(), endMark, endMark + 4);
+	m_isFinished = true;
+}
+
+
+void CompressionStream::WriteBlock(unsigned char const* data, int numBytes)
+{
+	int maxCompressedSize = GetMaxCompressedSize(numBytes);
+	size_t headerOffset = m_frame.size();
+	m_frame.resize(headerOffset + COMPRESSION_BLOCK_HEADER_SIZE + maxCompressedSize);
+	unsigned char* header = m_frame.data() + headerOffset;
+	unsigned char* blockData = header + COMPRESSION_BLOCK_HEADER_SIZE;
+
+	int blockSize = CompressBlock(data, numBytes, blockData, maxCompressedSize);
+	uint32_t storedSize = (uint32_t)blockSize;
+	if (blockSize == 0 || blockSize >= numBytes)
+	{
+		memcpy(blockData, data, numBytes);
+		blockSize = numBytes;
+		storedSize = (uint32_t)numBytes | COMPRESSION_STORED_RAW_FLAG;
+	}
+
+	WriteLittleEndianUint32(header, storedSize);
+	WriteLittleEndianUint32(header + 4, (uint32_t)numBytes);
+	WriteLittleEndianUint32(header + 8, ComputeChecksum32(data, numBytes));
+	m_frame.resize(headerOffset + COMPRESSION_BLOCK_HEADER_SIZE + blockSize);
+}
+
+
+void CompressFrame(void const* data, int size, std::vector<unsigned char>& outFrame)
+{
+	CompressionStream stream(outFrame);
+	stream.Write(data, size);
+	stream.Finish();
+}
+
+
+// adds up the raw sizes in the block headers, so the output grows once instead of a block at a time
+static size_t GetFrameDecompressedSize(unsigned char const* frame, int frameSize)
+{
+	size_t decompressedSize = 0;
+	int offset = COMPRESSION_FRAME_HEADER_SIZE;
+	while (frameSize - offset >= COMPRESSION_BLOCK_HEADER_SIZE)
+	{
+		uint32_t storedSize = ReadLittleEndianUint32(frame + offset) & ~COMPRESSION_STORED_RAW_FLAG;
+		uint32_t rawSize = ReadLittleEndianUint32(frame + offset + 4);
+		if (storedSize == 0 || storedSize > (uint32_t)(frameSize - offset - COMPRESSION_BLOCK_HEADER_SIZE) || rawSize > (uint32_t)COMPRESSION_BLOCK_SIZE) break;
+		decompressedSize += rawSize;
+		offset += COMPRESSION_BLOCK_HEADER_SIZE + (int)storedSize;
+	}
+	return decompressedSize;
+}
+
+
+static int DecompressFrameBlocks(unsigned char const* frame, int frameSize, std::vector<unsigned char>& outData)
+{
+	if (frameSize < COMPRESSION_FRAME_HEADER_SIZE || memcmp(frame, s_frameMagic, COMPRESSION_FRAME_HEADER_SIZE) != 0) return -1;
+
+	int offset = COMPRESSION_FRAME_HEADER_SIZE;
+	while (true)
+	{
+		if (frameSize - offset < 4) return -1;
+		uint32_t storedSize = ReadLittleEndianUint32(frame + offset);
+		offset += 4;
+		if (storedSize == 0) return offset;
+
+		if (frameSize - offset < COMPRESSION_BLOCK_HEADER_SIZE - 4) return -1;
+		uint32_t rawSize = ReadLittleEndianUint32(frame + offset);
+		uint32_t checksum = ReadLittleEndianUint32(frame + offset + 4);
+		offset += COMPRESSION_BLOCK_HEADER_SIZE - 4;
+
+		bool isStoredRaw = (storedSize & COMPRESSION_STORED_RAW_FLAG) != 0;
+		storedSize &= ~COMPRESSION_STORED_RAW_FLAG;
+		if (storedSize > (uint32_t)(frameSize - offset) || rawSize > (uint32_t)COMPRESSION_BLOCK_SIZE) return -1;
+
+		size_t outOffset = outData.size();
+		outData.resize(outOffset + rawSize);
+		unsigned char* block = outData.data() + outOffset;
+		if (isStoredRaw)
+		{
+			if (storedSize != rawSize) return -1;
+			memcpy(block, frame + offset, rawSize);
+		}
+		else if (DecompressBlock(frame + offset, (int)storedSize, block, (int)rawSize) != (int)rawSize)
+		{
+			return -1;
+		}
+
+		if (ComputeChecksum32(block, (int)rawSize) != checksum) return -1;
+		offset += (int)storedSize;
+	}
+}
+
+
+int DecompressFrame(unsigned char const* frame, int frameSize, std::vector<unsigned char>& outData)
+{
+	size_t originalSize = outData.size();
+	if (frameSize >= COMPRESSION_FRAME_HEADER_SIZE)
+	{
+		outData.reserve(originalSize + GetFrameDecompressedSize(frame, frameSize));
+	}
+	int frameBytesRead = DecompressFrameBlocks(frame, frameSize, outData);
+	if (frameBytesRead < 0)
+	{
+		outData.resize(originalSize);
+	}
+	return frameBytesRead;
+}
+
+
+//
+//	benchmark
+//
+
+bool Command_BenchmarkCompression(EventArgs& args)
+{
+	std::string folder = args.GetValue("folder", "Saves");
+	std::string pattern = args.GetValue("files", "*.chunk");
+
+	Strings filenames;
+	FindFilesInFolder(folder, pattern, filenames, true);
+
+	// every file is its own frame, the way a chunk save uses it
+	std::vector<std::vector<unsigned char>> files;
+	files.reserve(filenames.size());
+	size_t totalSize = 0;
+	for (std::string const& filename : filenames)
+	{
+		std::vector<unsigned char> fileData;
+		if (FileReadToBuffer(fileData, filename) == 0 && !fileData.empty())
+		{
+			totalSize += fileData.size();
+			files.push_back(std::move(fileData));
+		}
+	}
+	if (files.empty())
+	{
+		g_theDevConsole->AddLine(DevConsole::INFO_ERROR, Stringf("No %s files in %s", pattern.c_str(), folder.c_str()));
+		return false;
+	}
+
+	std::vector<std::vector<unsigned char>> frames(files.size());
+	std::vector<unsigned char> decompressed;
+
+	// repeated until it has run long enough to time, small files take well under a millisecond
+	double const MIN_SECONDS = 0.25;
+	int numCompressPasses = 0;
+	double compressStartTime = GetCurrentTimeSeconds();
+	double compressSeconds = 0.0;
+	do
+	{
+		for (int fileIndex = 0; fileIndex < (int)files.size(); fileIndex++)
+		{
+			frames[fileIndex].clear();
+			CompressFrame(files[fileIndex].data(), (int)files[fileIndex].size(), frames[fileIndex]);
+		}
+		numCompressPasses++;
+		compressSeconds = GetCurrentTimeSeconds() - compressStartTime;
+	} while (compressSeconds < MIN_SECONDS);
+
+	int numDecompressPasses = 0;
+	bool isRoundTripValid = true;
+	double decompressStartTime = GetCurrentTimeSeconds();
+	double decompressSeconds = 0.0;
+	do
+	{
+		for (int fileIndex = 0; fileIndex < (int)files.size(); fileIndex++)
+		{
+			decompressed.clear();
+			if (DecompressFrame(frames[fileIndex].data(), (int)frames[fileIndex].size(), decompressed) != (int)frames[fileIndex].size())
+			{
+				isRoundTripValid = false;
+			}
+		}
+		numDecompressPasses++;
+		decompressSeconds = GetCurrentTimeSeconds() - decompressStartTime;
+	} while (decompressSeconds < MIN_SECONDS);
+
+	size_t compressedSize = 0;
+	for (int fileIndex = 0; fileIndex < (int)files.size(); fileIndex++)
+	{
+		compressedSize += frames[fileIndex].size();
+		decompressed.clear();
+		DecompressFrame(frames[fileIndex].data(), (int)frames[fileIndex].size(), decompressed);
+		if (decompressed != files[fileIndex])
+		{
+			isRoundTripValid = false;
+		}
+	}
+
+	double const BYTES_PER_MB = 1024.0 * 1024.0;
+	double compressMBPerSecond = (double)totalSize * numCompressPasses / BYTES_PER_MB / compressSeconds;
+	double decompressMBPerSecond = (double)totalSize * numDecompressPasses / BYTES_PER_MB / decompressSeconds;
+
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, Stringf("## Compression benchmark, %d files, %.1fKB ##", (int)files.size(), totalSize / 1024.0));
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("Compressed   %10.1fKB  %.1f%%", compressedSize / 1024.0, 100.0 * compressedSize / totalSize));
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("Compress     %10.1fMB/s", compressMBPerSecond));
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("Decompress   %10.1fMB/s", decompressMBPerSecond));
+	if (!isRoundTripValid)
+	{
+		g_theDevConsole->AddLine(DevConsole::INFO_ERROR, "Decompressed data does not match the files");
+	}
+	return true;
+}
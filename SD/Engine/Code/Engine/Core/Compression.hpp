@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+class NamedProperties;
+
+// LZ4 style codec, a block is a run of literals and back references into the last 64KB, decoding is only copies
+constexpr int COMPRESSION_BLOCK_SIZE = 64 * 1024;
+constexpr int COMPRESSION_MIN_MATCH = 4;
+
+// the most CompressBlock can write for this many input bytes, data that does not compress grows a little
+int GetMaxCompressedSize(int inputSize);
+// returns the compressed size, 0 when output is too small, blocks over COMPRESSION_BLOCK_SIZE still work but reach back no further
+int CompressBlock(unsigned char const* input, int inputSize, unsigned char* output, int outputCapacity);
+// returns the decompressed size, -1 for a block that is corrupt or does not fit, it never reads or writes outside either buffer
+int DecompressBlock(unsigned char const* input, int inputSize, unsigned char* output, int outputCapacity);
+
+// xxHash32, fast enough to check every block
+uint32_t ComputeChecksum32(void const* data, int size, uint32_t seed = 0);
+
+
+// a frame is a header, then blocks of at most COMPRESSION_BLOCK_SIZE each with its sizes and checksum, then an end mark
+// blocks that would not shrink are stored as they are
+class CompressionStream
+{
+public:
+	// appends the frame to outFrame, which has to outlive the stream
+	explicit CompressionStream(std::vector<unsigned char>& outFrame);
+	~CompressionStream();
+	CompressionStream(CompressionStream const& copy) = delete;
+	CompressionStream& operator=(CompressionStream const& copy) = delete;
+
+	// full blocks are compressed as they fill up
+	void Write(void const* data, int numBytes);
+	// compresses what is left and writes the end mark, further writes are ignored
+	void Finish();
+
+private:
+	void WriteBlock(unsigned char const* data, int numBytes);
+
+private:
+	std::vector<unsigned char>& m_frame;
+	std::vector<unsigned char> m_pendingBytes;
+	bool m_isFinished = false;
+};
+
+
+// compresses a whole buffer as one frame appended to outFrame
+void CompressFrame(void const* data, int size, std::vector<unsigned char>& outFrame);
+// appends the data of the frame at the start of frame to outData and returns how many bytes the frame took
+// -1 if it is cut off, corrupt or fails a checksum, outData is left as it was
+int DecompressFrame(unsigned char const* frame, int frameSize, std::vector<unsigned char>& outData);
+
+// benchmarkCompression folder=Saves files=*.chunk, MB/s and ratio over every matching file, folders below included
+bool Command_BenchmarkCompression(NamedProperties& args);
@@ -0,0 +1,127 @@
+#include "Engine/Core/DefinitionCache.hpp"
+#include "Engine/Core/Compression.hpp"
+
+// layout of the header, the payload after it is up to the caller
+constexpr uint32_t DEFINITION_CACHE_FORMAT_VERSION = 1;
+constexpr int DEFINITION_CACHE_HEADER_SIZE = 28;
+
+
+DefinitionCache::DefinitionCache(std::string const& sourcePath, uint32_t version)
+	:m_sourcePath(sourcePath)
+	,m_cookedPath(sourcePath + ".cooked")
+	,m_version(version)
+	,m_cookWriter(m_cookBuffer)
+{
+	// little endian on disk whatever the machine, the same file reads back anywhere
+	m_cookWriter.SetEndianMode(eBufferEndian::LITTLE);
+}
+
+
+bool DefinitionCache::OpenCooked()
+{
+	if (!ReadSourceKey()) return false;
+	if (!m_cookedFile.Open(m_cookedPath)) return false;
+	if (m_cookedFile.GetSize() < DEFINITION_CACHE_HEADER_SIZE)
+	{
+		m_cookedFile.Close();
+		return false;
+	}
+
+	BufferParser header(m_cookedFile.GetData(), DEFINITION_CACHE_HEADER_SIZE);
+	header.SetEndianMode(eBufferEndian::LITTLE);
+	uint8_t d = header.ParseByte();
+	uint8_t e = header.ParseByte();
+	uint8_t f = header.ParseByte();
+	uint8_t c = header.ParseByte();
+	uint32_t formatVersion = header.ParseUint32();
+	uint32_t version = header.ParseUint32();
+	uint32_t sourceSize = header.ParseUint32();
+	uint32_t sourceHash = header.ParseUint32();
+	uint32_t payloadSize = header.ParseUint32();
+	uint32_t payloadChecksum = header.ParseUint32();
+
+	unsigned char const* payload = m_cookedFile.GetData() + DEFINITION_CACHE_HEADER_SIZE;
+	bool isHeaderValid = d == 'D' && e == 'E' && f == 'F' && c == 'C' && formatVersion == DEFINITION_CACHE_FORMAT_VERSION && version == m_version;
+	bool isSourceSame = sourceSize == m_sourceSize && sourceHash == m_sourceHash;
+	// a cut off or damaged payload would have the parser read past the mapping, so it is checked whole before any of it is used
+	bool isPayloadValid = payloadSize == m_cookedFile.GetSize() - DEFINITION_CACHE_HEADER_SIZE && ComputeChecksum32(payload, (int)payloadSize) == payloadChecksum;
+	if (!isHeaderValid || !isSourceSame || !isPayloadValid)
+	{
+		// closed so SaveCooked can write over it
+		m_cookedFile.Close();
+		return false;
+	}
+
+	m_isCookedOpen = true;
+	return true;
+}
+
+
+BufferParser DefinitionCache::GetCookedParser() const
+{
+	if (!m_isCookedOpen)
+	{
+		return BufferParser(nullptr, 0);
+	}
+
+	BufferParser parser(m_cookedFile.GetData() + DEFINITION_CACHE_HEADER_SIZE, (int)m_cookedFile.GetSize() - DEFINITION_CACHE_HEADER_SIZE);
+	parser.SetEndianMode(eBufferEndian::LITTLE);
+	return parser;
+}
+
+
+BufferWriter& DefinitionCache::GetCookWriter()
+{
+	return m_cookWriter;
+}
+
+
+bool DefinitionCache::SaveCooked()
+{
+	if (!ReadSourceKey()) return false;
+
+	std::vector<unsigned char> cookedFile;
+	BufferWriter writer(cookedFile);
+	writer.SetEndianMode(eBufferEndian::LITTLE);
+	writer.Reserve(DEFINITION_CACHE_HEADER_SIZE + (int)m_cookBuffer.size());
+	writer.AppendByte('D');
+	writer.AppendByte('E');
+	writer.AppendByte('F');
+	writer.AppendByte('C');
+	writer.AppendUint32(DEFINITION_CACHE_FORMAT_VERSION);
+	writer.AppendUint32(m_version);
+	writer.AppendUint32(m_sourceSize);
+	writer.AppendUint32(m_sourceHash);
+	writer.AppendUint32((uint32_t)m_cookBuffer.size());
+	writer.AppendUint32(ComputeChecksum32(m_cookBuffer.data(), (int)m_cookBuffer.size()));
+	writer.AppendBytes(m_cookBuffer.data(), (int)m_cookBuffer.size());
+
+	// nothing reads it again this launch, so it can go out on the file I/O thread
+	if (g_theFileIOQueue)
+	{
+		g_theFileIOQueue->WriteFileAsync(m_cookedPath, std::move(cookedFile));
+		return true;
+	}
+	return FileWriteFromBuffer(cookedFile, m_cookedPath) == 0;
+}
+
+
+std::string const& DefinitionCache::GetCookedPath() const
+{
+	return m_cookedPath;
+}
+
+
+bool DefinitionCache::ReadSourceKey()
+{
+	if (m_hasSourceKey) return true;
+
+	// hashing the mapped XML costs a fraction of parsing it
+	MappedFile sourceFile(m_sourcePath);
+	if (!sourceFile.IsOpen()) return false;
+
+	m_sourceSize = (uint32_t)sourceFile.GetSize();
+	m_sourceHash = ComputeChecksum32(sourceFile.GetData(), (int)sourceFile.GetSize());
+	m_hasSourceKey = true;
+	return true;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// a table of parsed definitions cooked to a binary file next to its XML, so later launches read values instead of parsing text
+// the cooked file is keyed by a hash of the XML, an edited XML no longer matches and the table is parsed and cooked again
+// only values are cooked, pointers to other definitions and resources are written as names and looked up again on load
+class DefinitionCache
+{
+public:
+	// version is the layout of what the caller writes, bump it whenever that changes
+	DefinitionCache(std::string const& sourcePath, uint32_t version);
+	~DefinitionCache() {}
+	DefinitionCache(DefinitionCache const& copy) = delete;
+	DefinitionCache& operator=(DefinitionCache const& copy) = delete;
+
+	// maps the cooked file, false when it is missing, damaged, or was cooked from other XML or another version
+	bool OpenCooked();
+	// reads the mapped payload, valid while the cache is alive
+	BufferParser GetCookedParser() const;
+
+	// the caller appends the definitions it parsed from the XML, then SaveCooked writes them out
+	BufferWriter& GetCookWriter();
+	bool SaveCooked();
+
+	std::string const& GetCookedPath() const;
+
+private:
+	bool ReadSourceKey();
+
+private:
+	std::string m_sourcePath;
+	std::string m_cookedPath;
+	uint32_t m_version = 0;
+
+	bool m_hasSourceKey = false;
+	uint32_t m_sourceSize = 0;
+	uint32_t m_sourceHash = 0;
+
+	MappedFile m_cookedFile;
+	bool m_isCookedOpen = false;
+
+	std::vector<unsigned char> m_cookBuffer;
+	BufferWriter m_cookWriter;
+};
+
+
+// fills definitions from the cooked copy of xmlPath, or parses the XML and cooks what it added when there is no valid cooked copy
+// parseElementFn takes each child of the root and returns a new T, or nullptr to skip it, T also needs WriteCooked and ReadCooked
+// cookVersion is the layout those two read and write, bump it whenever either changes and older cooked files are parsed from XML again
+template <typename T, typename ParseElementFn>
+void LoadOrCookDefinitions(char const* xmlPath, uint32_t cookVersion, std::vector<T*>& definitions, ParseElementFn parseElementFn)
+{
+	DefinitionCache cache(xmlPath, cookVersion);
+	if (cache.OpenCooked())
+	{
+		BufferParser parser = cache.GetCookedParser();
+		int numDefinitions = (int)parser.ParseUint32();
+		for (int defIndex = 0; defIndex < numDefinitions; defIndex++)
+		{
+			T* newDef = new T();
+			newDef->ReadCooked(parser);
+			definitions.push_back(newDef);
+		}
+		return;
+	}
+
+	// the list may already hold definitions from other files, only what this file adds is cooked
+	int firstDefIndex = (int)definitions.size();
+	XmlDocument doc;
+	doc.LoadFile(xmlPath);
+	XmlElement const* root = doc.RootElement();
+
+	XmlElement const* element = root ? root->FirstChildElement() : nullptr;
+	while (element)
+	{
+		T* newDef = parseElementFn(*element);
+		if (newDef)
+		{
+			definitions.push_back(newDef);
+		}
+		element = element->NextSiblingElement();
+	}
+
+	BufferWriter& writer = cache.GetCookWriter();
+	writer.AppendUint32((uint32_t)(definitions.size() - firstDefIndex));
+	for (int defIndex = firstDefIndex; defIndex < (int)definitions.size(); defIndex++)
+	{
+		definitions[defIndex]->WriteCooked(writer);
+	}
+	cache.SaveCooked();
+}
@@ -1,5 +1,8 @@
 #include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Compression.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
+#include "Engine/Math/MathBenchmark.hpp"
 #include "Engine/Net/RemoteConsole.hpp"
 
 DevConsole* g_theDevConsole;
@@ -33,6 +36,9 @@ void DevConsole::Startup()
 	SubscribeEventCallbackFunction("clear", Command_Clear);
 	SubscribeEventCallbackFunction("help", Command_Help);
 	SubscribeEventCallbackFunction("executeCommandScript", Command_ExecuteCommandFromFile);
+	SubscribeEventCallbackFunction("mathBenchmark", Command_MathBenchmark);
+	SubscribeEventCallbackFunction("benchmarkStringParsing", Command_BenchmarkStringParsing);
+	SubscribeEventCallbackFunction("benchmarkCompression", Command_BenchmarkCompression);
 
 	if (m_config.m_hasRemoteConsole)
 	{
@@ -126,8 +132,9 @@ void DevConsole::Execute(std::string const& consoleCommandText)
 				argumentPairs.SetValue(argumentPair[0], argumentPair[1]);
 			}
 		}
-		FireEvent(commandName, argumentPairs);
-		CallHandler(commandName, argumentPairs);
+		EventId commandId(commandName);
+		FireEvent(commandId, argumentPairs);
+		CallHandler(commandId, argumentPairs);
 	}
 }
 
@@ -306,7 +313,8 @@ void DevConsole::Render_OpenFull(AABB2 const& bounds, Renderer& renderer, Bitmap
 	//draw console box
 	Vec2 boxDimensions = bounds.GetDimensions();
 	float cellHeight = boxDimensions.y / m_config.m_consoleLines;
-	std::vector<Vertex_PCU> pauseVertexArray;
+	FrameVector<Vertex_PCU> pauseVertexArray;
+	pauseVertexArray.reserve(12);
 	AABB2 screenBox(bounds.m_mins, bounds.m_maxs);
 	AddVertsForAABB2D(pauseVertexArray, screenBox, Rgba8(150, 150, 150, 50));
 	AABB2 inputLineBox(Vec2(0.f, 0.f), Vec2(boxDimensions.x, cellHeight));
@@ -315,10 +323,16 @@ void DevConsole::Render_OpenFull(AABB2 const& bounds, Renderer& renderer, Bitmap
 	renderer.DrawVertexArray(int(pauseVertexArray.size()), pauseVertexArray.data());
 
 	//draw each console line   
-	std::vector<Vertex_PCU> consoleVerts;
+	size_t numberGlyphs = m_inputLine.size();
+	for (int lineIndex = 0; lineIndex < int(m_lines.size()); lineIndex++)
+	{
+		numberGlyphs += m_lines[lineIndex].m_text.size();
+	}
+	FrameVector<Vertex_PCU> consoleVerts;
+	consoleVerts.reserve(6 * numberGlyphs);
 	for (int lineIndex = int(m_lines.size()) - 1; lineIndex >= 0; lineIndex--)
 	{
-		DevConsoleLine line = m_lines[lineIndex];
+		DevConsoleLine const& line = m_lines[lineIndex];
 		AABB2 lineBox(Vec2(0.f, cellHeight * static_cast<float>(m_lines.size() - lineIndex)), Vec2(boxDimensions.x, cellHeight * static_cast<float>(m_lines.size() - lineIndex + 1)));
 		font.AddVertsForTextInBox2D(consoleVerts, lineBox, cellHeight, line.m_text, line.m_tint, fontAspect, Vec2(0.f, 0.5f), TextBoxMode::SHRINK_TO_FIT);
 	}
@@ -330,7 +344,8 @@ void DevConsole::Render_OpenFull(AABB2 const& bounds, Renderer& renderer, Bitmap
 
 	if (m_caretVisible)
 	{
-		std::vector<Vertex_PCU> caretVerts;
+		FrameVector<Vertex_PCU> caretVerts;
+		caretVerts.reserve(6);
 		float caretPosX = font.GetTextWidth(cellHeight, m_inputLine.substr(0, m_caretPosition), fontAspect);
 		//float caretPosX = cellHeight * fontAspect * m_caretPosition;
 		LineSegment2 caretLine(Vec2(caretPosX + .5f, 0.f), Vec2(caretPosX + .5f, cellHeight));
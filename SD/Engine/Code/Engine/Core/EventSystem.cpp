@@ -1,7 +1,54 @@
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+#include <map>
 
 EventSystem* g_theEventSystem;
 
+static uint64_t GetCaseFoldedEventHash(char const* eventName);
+static bool IsEventNameLess(std::string const& a, std::string const& b);
+static void DeleteQueuedEvents(QueuedEvent* head);
+
+// recycled events a posting thread takes from without any atomics, nodes are interchangeable between event systems
+struct QueuedEventCache
+{
+	~QueuedEventCache()
+	{
+		DeleteQueuedEvents(m_firstFreeEvent);
+	}
+
+	QueuedEvent* m_firstFreeEvent = nullptr;
+};
+
+static thread_local QueuedEventCache t_queuedEventCache;
+
+
+EventId::EventId(char const* eventName)
+	: m_hash(GetCaseFoldedEventHash(eventName))
+{
+}
+
+
+EventId::EventId(std::string const& eventName)
+	: m_hash(GetCaseFoldedEventHash(eventName.c_str()))
+{
+}
+
+
+bool EventId::operator==(EventId const& other) const
+{
+	return m_hash == other.m_hash;
+}
+
+
+bool EventId::operator!=(EventId const& other) const
+{
+	return m_hash != other.m_hash;
+}
+
+
 EventSystem::EventSystem(EventSystemConfig const& config)
 	:m_config(config)
 {
@@ -14,13 +61,13 @@ EventSystem::~EventSystem()
 
 void EventSystem::Startup()
 {
-
+	SubscribeEventCallbackFunction("benchmarkFireEvent", Command_BenchmarkFireEvent);
 }
 
 
 void EventSystem::BeginFrame()
 {
-
+	DispatchQueuedEvents();
 }
 
 
@@ -32,7 +79,11 @@ void EventSystem::EndFrame()
 
 void EventSystem::ShutDown()
 {
-
+	// whatever was posted after the last BeginFrame is dropped
+	DeleteQueuedEvents(m_queuedEvents.exchange(nullptr, std::memory_order_acquire));
+	DeleteQueuedEvents(m_freeQueuedEvents.exchange(nullptr, std::memory_order_acquire));
+	DeleteQueuedEvents(t_queuedEventCache.m_firstFreeEvent);
+	t_queuedEventCache.m_firstFreeEvent = nullptr;
 }
 
 
@@ -40,40 +91,31 @@ void EventSystem::SubscribeEventCallbackFunction(std::string const& eventName, E
 {
 	EventSubscription subscription;
 	subscription.m_function = functionPtr;
-	std::map<std::string, SubscriptionList>::iterator iter = m_subscriptionListsByEventName.find(eventName);
+	int entryIndex = m_subscriptionListsByEventName.FindOrAdd(EventId(eventName), eventName);
 
-	if (iter == m_subscriptionListsByEventName.end()) 
-	{
-		SubscriptionList list;
-		list.push_back(subscription);
-		m_subscriptionListsByEventName[eventName] = list;
-	}
-	else
+	SubscriptionList& list = m_subscriptionListsByEventName.GetEntry(entryIndex).m_list;
+	for (int subscriber = 0; subscriber < int(list.size()); subscriber++)
 	{
-		SubscriptionList& list = iter->second;
-		for (int subscriber = 0; subscriber < int(list.size()); subscriber++)
+		if (list[subscriber].m_function == functionPtr)
 		{
-			if (list[subscriber].m_function == functionPtr)
-			{
-				return;
-			}
+			return;
 		}
-		list.push_back(subscription);
 	}
+	list.push_back(subscription);
 }
 
 
 void EventSystem::UnsubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction functionPtr)
 {
-	std::map<std::string, SubscriptionList>::iterator iter = m_subscriptionListsByEventName.find(eventName);
+	int entryIndex = m_subscriptionListsByEventName.Find(EventId(eventName));
 
-	if (iter == m_subscriptionListsByEventName.end())
+	if (entryIndex < 0)
 	{
 		//ERROR_AND_DIE("No such event exist");
 	}
 	else
 	{
-		SubscriptionList& list = iter->second;
+		SubscriptionList& list = m_subscriptionListsByEventName.GetEntry(entryIndex).m_list;
 		for (int subscriber = 0; subscriber < int(list.size()); subscriber++)
 		{
 			if (list[subscriber].m_function == functionPtr)
@@ -91,74 +133,201 @@ void EventSystem::UnsubscribeEventCallbackFunction(std::string const& eventName,
 
 void EventSystem::FireEvent(std::string const& eventName, EventArgs& args)
 {
-	std::map<std::string, SubscriptionList>::iterator iter = m_subscriptionListsByEventName.find(eventName);
+	FireEvent(EventId(eventName), args);
+}
+
+
+void EventSystem::FireEvent(std::string const& eventName)
+{
+	EventArgs args;
+	FireEvent(EventId(eventName), args);
+}
+
 
-	if (iter == m_subscriptionListsByEventName.end())
+void EventSystem::FireEvent(EventId eventId, EventArgs& args)
+{
+	int entryIndex = m_subscriptionListsByEventName.Find(eventId);
+
+	if (entryIndex < 0)
 	{
 		//ERROR_AND_DIE("No such event exist");
 	}
 	else
 	{
-		SubscriptionList& list = iter->second;
-		for (int subscriber = 0; subscriber < int(list.size()); subscriber++)
+		// a callback may subscribe to a new event and grow the table, so the list is fetched again for every call
+		for (int subscriber = 0; subscriber < int(m_subscriptionListsByEventName.GetEntry(entryIndex).m_list.size()); subscriber++)
 		{
-			list[subscriber].m_function(args);
+			EventSubscription subscription = m_subscriptionListsByEventName.GetEntry(entryIndex).m_list[subscriber];
+			if (subscription.m_handler)
+			{
+				subscription.m_handler->CallFunction(args);
+			}
+			else
+			{
+				subscription.m_function(args);
+			}
 		}
 	}
 }
 
 
-void EventSystem::FireEvent(std::string const& eventName)
+void EventSystem::FireEvent(EventId eventId)
 {
 	EventArgs args;
-	FireEvent(eventName, args);
+	FireEvent(eventId, args);
+}
+
+
+void EventSystem::QueueEvent(std::string const& eventName, EventArgs const& args, bool coalesce)
+{
+	QueueEvent(EventId(eventName), args, coalesce);
+}
+
+
+void EventSystem::QueueEvent(EventId eventId, EventArgs const& args, bool coalesce)
+{
+	QueuedEvent* queuedEvent = AcquireQueuedEvent();
+	queuedEvent->m_eventId = eventId;
+	queuedEvent->m_args = args;
+	queuedEvent->m_isCoalesced = coalesce;
+	queuedEvent->m_isSuperseded = false;
+
+	QueuedEvent* head = m_queuedEvents.load(std::memory_order_relaxed);
+	do
+	{
+		queuedEvent->m_nextQueuedEvent = head;
+	} while (!m_queuedEvents.compare_exchange_weak(head, queuedEvent, std::memory_order_release, std::memory_order_relaxed));
+}
+
+
+void EventSystem::DispatchQueuedEvents()
+{
+	// anything posted from here on, including by the callbacks below, waits for the next frame
+	QueuedEvent* head = m_queuedEvents.exchange(nullptr, std::memory_order_acquire);
+	if (!head)
+	{
+		return;
+	}
+
+	// the stack is newest first, so the first posting of a coalesced event met here is its latest and the older ones are skipped
+	m_numberDispatches++;
+	for (QueuedEvent* queuedEvent = head; queuedEvent; queuedEvent = queuedEvent->m_nextQueuedEvent)
+	{
+		if (!queuedEvent->m_isCoalesced) continue;
+
+		int& lastDispatch = m_coalescedEventDispatches.GetEntry(m_coalescedEventDispatches.FindOrAdd(queuedEvent->m_eventId)).m_list;
+		queuedEvent->m_isSuperseded = lastDispatch == m_numberDispatches;
+		lastDispatch = m_numberDispatches;
+	}
+
+	// reversed to fire in posting order
+	QueuedEvent* reversedHead = nullptr;
+	QueuedEvent* reversedTail = head;
+	while (head)
+	{
+		QueuedEvent* next = head->m_nextQueuedEvent;
+		head->m_nextQueuedEvent = reversedHead;
+		reversedHead = head;
+		head = next;
+	}
+
+	for (QueuedEvent* queuedEvent = reversedHead; queuedEvent; queuedEvent = queuedEvent->m_nextQueuedEvent)
+	{
+		if (queuedEvent->m_isSuperseded) continue;
+		FireEvent(queuedEvent->m_eventId, queuedEvent->m_args);
+	}
+
+	ReleaseQueuedEvents(reversedHead, reversedTail);
+}
+
+
+QueuedEvent* EventSystem::AcquireQueuedEvent()
+{
+	QueuedEventCache& cache = t_queuedEventCache;
+	if (!cache.m_firstFreeEvent)
+	{
+		// the shared stack is only ever taken whole, so no thread pops a node another one is recycling
+		cache.m_firstFreeEvent = m_freeQueuedEvents.exchange(nullptr, std::memory_order_acquire);
+	}
+
+	QueuedEvent* queuedEvent = cache.m_firstFreeEvent;
+	if (!queuedEvent)
+	{
+		return new QueuedEvent();
+	}
+	cache.m_firstFreeEvent = queuedEvent->m_nextQueuedEvent;
+	return queuedEvent;
+}
+
+
+void EventSystem::ReleaseQueuedEvents(QueuedEvent* head, QueuedEvent* tail)
+{
+	QueuedEvent* freeHead = m_freeQueuedEvents.load(std::memory_order_relaxed);
+	do
+	{
+		tail->m_nextQueuedEvent = freeHead;
+	} while (!m_freeQueuedEvents.compare_exchange_weak(freeHead, head, std::memory_order_release, std::memory_order_relaxed));
 }
 
 
 void EventSystem::GetRegisteredEventNames(std::vector<std::string>& outNames) const
 {
-	for (std::map<std::string, SubscriptionList>::const_iterator iter = m_subscriptionListsByEventName.begin(); iter != m_subscriptionListsByEventName.end(); iter++)
+	for (int entryIndex = 0; entryIndex < m_subscriptionListsByEventName.GetNumEntries(); entryIndex++)
 	{
-		SubscriptionList const& list = iter->second;
-		if (list.size() > 0)
+		EventIdTable<SubscriptionList>::Entry const& entry = m_subscriptionListsByEventName.GetEntry(entryIndex);
+		if (entry.m_list.size() > 0)
 		{
-			outNames.push_back(iter->first);
+			outNames.push_back(entry.m_name);
 		}
 	}
+	// the table keeps insertion order, listings stay alphabetical like they were
+	std::sort(outNames.begin(), outNames.end(), IsEventNameLess);
 }
 
 
 void EventSystem::CallHandler(std::string const& handleName)
 {
-	std::map<std::string, EventHandleList>::iterator iter = m_handleList.find(handleName);
-	if (iter == m_handleList.end())
+	CallHandler(EventId(handleName));
+}
+
+
+void EventSystem::CallHandler(std::string const& handleName, EventArgs& args)
+{
+	CallHandler(EventId(handleName), args);
+}
+
+
+void EventSystem::CallHandler(EventId handleId)
+{
+	int entryIndex = m_handleList.Find(handleId);
+	if (entryIndex < 0)
 	{
 		//ERROR_AND_DIE("No such event exist");
 	}
 	else
 	{
-		EventHandleList& list = iter->second;
-		for (int subscriber = 0; subscriber < int(list.size()); subscriber++)
+		// each handler gets the args it was registered with
+		for (int subscriber = 0; subscriber < int(m_handleList.GetEntry(entryIndex).m_list.size()); subscriber++)
 		{
-			list[subscriber].handler->CallFunction(list[subscriber].args);
+			HandlerSubscription& subscription = m_handleList.GetEntry(entryIndex).m_list[subscriber];
+			subscription.handler->CallFunction(subscription.args);
 		}
 	}
 }
 
 
-void EventSystem::CallHandler(std::string const& handleName, EventArgs& args)
+void EventSystem::CallHandler(EventId handleId, EventArgs& args)
 {
-	std::map<std::string, EventHandleList>::iterator iter = m_handleList.find(handleName);
-	if (iter == m_handleList.end())
+	int entryIndex = m_handleList.Find(handleId);
+	if (entryIndex < 0)
 	{
 		//ERROR_AND_DIE("No such event exist");
 	}
 	else
 	{
-		EventHandleList& list = iter->second;
-		for (int subscriber = 0; subscriber < int(list.size()); subscriber++)
+		for (int subscriber = 0; subscriber < int(m_handleList.GetEntry(entryIndex).m_list.size()); subscriber++)
 		{
-			list[subscriber].handler->CallFunction(args);
+			m_handleList.GetEntry(entryIndex).m_list[subscriber].handler->CallFunction(args);
 		}
 	}
 }
@@ -166,14 +335,15 @@ void EventSystem::CallHandler(std::string const& handleName, EventArgs& args)
 
 void EventSystem::UnregisterEventHandler(std::string const& handleName)
 {
-	std::map<std::string, EventHandleList>::iterator iter = m_handleList.find(handleName);
-	if (iter == m_handleList.end())
+	int entryIndex = m_handleList.Find(EventId(handleName));
+	if (entryIndex < 0)
 	{
 		//ERROR_AND_DIE("No such event exist");
 	}
 	else
 	{
-		EventHandleList& list = iter->second;
+		// the entry itself stays, an empty list reads the same as a missing one
+		EventHandleList& list = m_handleList.GetEntry(entryIndex).m_list;
 		for (auto itemIter = list.begin(); itemIter != list.end();)
 		{
 			auto& item = *itemIter;
@@ -181,16 +351,15 @@ void EventSystem::UnregisterEventHandler(std::string const& handleName)
 			item.handler = nullptr;
 			itemIter = list.erase(itemIter);
 		}
-		m_handleList.erase(handleName);
 	}
 }
 
 
 void EventSystem::UnregisterAllEventsForObject(void* obj)
 {
-	for (auto& pair : m_handleList)
+	for (int entryIndex = 0; entryIndex < m_handleList.GetNumEntries(); entryIndex++)
 	{
-		EventHandleList& list = pair.second;
+		EventHandleList& list = m_handleList.GetEntry(entryIndex).m_list;
 		for (auto iter = list.begin(); iter != list.end();)
 		{
 			auto& item = *iter;
@@ -211,14 +380,142 @@ void EventSystem::UnregisterAllEventsForObject(void* obj)
 
 void EventSystem::GetRegisterHandlerNames(std::vector<std::string>& outNames) const
 {
-	for (std::map<std::string, EventHandleList>::const_iterator iter = m_handleList.begin(); iter != m_handleList.end(); iter++)
+	for (int entryIndex = 0; entryIndex < m_handleList.GetNumEntries(); entryIndex++)
 	{
-		EventHandleList const& list = iter->second;
-		if (list.size() > 0)
+		EventIdTable<EventHandleList>::Entry const& entry = m_handleList.GetEntry(entryIndex);
+		if (entry.m_list.size() > 0)
 		{
-			outNames.push_back(iter->first);
+			outNames.push_back(entry.m_name);
 		}
 	}
+	// the table keeps insertion order, listings stay alphabetical like they were
+	std::sort(outNames.begin(), outNames.end(), IsEventNameLess);
+}
+
+
+// the lookup EventIdTable replaced, kept here as the reference the benchmark measures against
+struct CaseInsensitiveComparator
+{
+	struct CaseInsensitiveCharCompare
+	{
+		inline bool operator()(unsigned char const& a, unsigned char const& b) const
+		{
+			return std::tolower(a) < std::tolower(b);
+		}
+	};
+
+	inline bool operator()(std::string const& a, std::string const& b) const
+	{
+		return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), CaseInsensitiveCharCompare());
+	}
+};
+
+
+static int s_numBenchmarkEventCalls = 0;
+
+static bool Event_BenchmarkCounter(EventArgs& args)
+{
+	UNUSED(args)
+	s_numBenchmarkEventCalls++;
+	return false;
+}
+
+
+bool EventSystem::Command_BenchmarkFireEvent(EventArgs& args)
+{
+	int numEvents = args.GetParsedValue("events", 200);
+	int numFires = args.GetParsedValue("fires", 1000000);
+	if (numEvents <= 0 || numFires <= 0) return false;
+
+	// a private system, so none of the real subscribers see the benchmark events
+	EventSystemConfig config;
+	EventSystem eventSystem(config);
+	std::map<std::string, SubscriptionList, CaseInsensitiveComparator> referenceLists;
+	std::vector<std::string> eventNames;
+	std::vector<EventId> eventIds;
+	for (int eventIndex = 0; eventIndex < numEvents; eventIndex++)
+	{
+		// shared prefix like real event names, which is the worst case for the string compares
+		std::string eventName = Stringf("debugBenchmarkEvent%d", eventIndex);
+		eventSystem.SubscribeEventCallbackFunction(eventName, Event_BenchmarkCounter);
+		EventSubscription subscription;
+		subscription.m_function = Event_BenchmarkCounter;
+		referenceLists[eventName].push_back(subscription);
+		eventNames.push_back(eventName);
+		eventIds.push_back(EventId(eventName));
+	}
+
+	EventArgs fireArgs;
+	s_numBenchmarkEventCalls = 0;
+	double startTime = GetCurrentTimeSeconds();
+	for (int fireIndex = 0; fireIndex < numFires; fireIndex++)
+	{
+		std::map<std::string, SubscriptionList, CaseInsensitiveComparator>::iterator iter = referenceLists.find(eventNames[fireIndex % numEvents]);
+		SubscriptionList& list = iter->second;
+		for (int subscriber = 0; subscriber < int(list.size()); subscriber++)
+		{
+			list[subscriber].m_function(fireArgs);
+		}
+	}
+	double mapSeconds = GetCurrentTimeSeconds() - startTime;
+
+	startTime = GetCurrentTimeSeconds();
+	for (int fireIndex = 0; fireIndex < numFires; fireIndex++)
+	{
+		eventSystem.FireEvent(eventNames[fireIndex % numEvents], fireArgs);
+	}
+	double nameSeconds = GetCurrentTimeSeconds() - startTime;
+
+	startTime = GetCurrentTimeSeconds();
+	for (int fireIndex = 0; fireIndex < numFires; fireIndex++)
+	{
+		eventSystem.FireEvent(eventIds[fireIndex % numEvents], fireArgs);
+	}
+	double idSeconds = GetCurrentTimeSeconds() - startTime;
+
+	if (!g_theDevConsole) return false;
+
+	double secondsToNanosecondsPerFire = 1000000000.0 / static_cast<double>(numFires);
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, Stringf("## FireEvent, %d events x %d fires, %d callbacks ##", numEvents, numFires, s_numBenchmarkEventCalls));
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("case insensitive map  %7.1fns/fire", mapSeconds * secondsToNanosecondsPerFire));
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("FireEvent(name)       %7.1fns/fire  %.2fx", nameSeconds * secondsToNanosecondsPerFire, mapSeconds / nameSeconds));
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("FireEvent(EventId)    %7.1fns/fire  %.2fx", idSeconds * secondsToNanosecondsPerFire, mapSeconds / idSeconds));
+	return false;
+}
+
+
+static bool IsEventNameLess(std::string const& a, std::string const& b)
+{
+	return _stricmp(a.c_str(), b.c_str()) < 0;
+}
+
+
+static uint64_t GetCaseFoldedEventHash(char const* eventName)
+{
+	// FNV-1a over the lowercased name, "KeyPressed" and "keypressed" stay the same event like they were in the old map
+	uint64_t hash = 14695981039346656037ull;
+	for (char const* character = eventName; *character != '\0'; character++)
+	{
+		unsigned char foldedCharacter = (unsigned char)*character;
+		if (foldedCharacter >= 'A' && foldedCharacter <= 'Z')
+		{
+			foldedCharacter = (unsigned char)(foldedCharacter - 'A' + 'a');
+		}
+		hash ^= foldedCharacter;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+
+static void DeleteQueuedEvents(QueuedEvent* head)
+{
+	while (head)
+	{
+		QueuedEvent* next = head->m_nextQueuedEvent;
+		delete head;
+		head = next;
+	}
 }
 
 
@@ -262,6 +559,46 @@ void FireEvent(std::string const& eventName)
 }
 
 
+void FireEvent(EventId eventId, EventArgs& args)
+{
+	if (!g_theEventSystem)
+	{
+		return;
+	}
+	g_theEventSystem->FireEvent(eventId, args);
+}
+
+
+void FireEvent(EventId eventId)
+{
+	if (!g_theEventSystem)
+	{
+		return;
+	}
+	g_theEventSystem->FireEvent(eventId);
+}
+
+
+void QueueEvent(std::string const& eventName, EventArgs const& args, bool coalesce)
+{
+	if (!g_theEventSystem)
+	{
+		return;
+	}
+	g_theEventSystem->QueueEvent(eventName, args, coalesce);
+}
+
+
+void QueueEvent(EventId eventId, EventArgs const& args, bool coalesce)
+{
+	if (!g_theEventSystem)
+	{
+		return;
+	}
+	g_theEventSystem->QueueEvent(eventId, args, coalesce);
+}
+
+
 void CallHandler(std::string const& handleName)
 {
 	if (!g_theEventSystem)
@@ -282,6 +619,26 @@ void CallHandler(std::string const& handleName, EventArgs& args)
 }
 
 
+void CallHandler(EventId handleId)
+{
+	if (!g_theEventSystem)
+	{
+		return;
+	}
+	g_theEventSystem->CallHandler(handleId);
+}
+
+
+void CallHandler(EventId handleId, EventArgs& args)
+{
+	if (!g_theEventSystem)
+	{
+		return;
+	}
+	g_theEventSystem->CallHandler(handleId, args);
+}
+
+
 void UnregisterEventHandler(std::string const& handleName)
 {
 	if (!g_theEventSystem)
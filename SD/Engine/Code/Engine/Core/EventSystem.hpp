@@ -2,6 +2,11 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/EventHandler.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <string.h>
+#include <vector>
+
 class InputSystem;
 
 using namespace std;
@@ -10,26 +15,26 @@ typedef bool (*EventCallbackFunction)(EventArgs& args);
 
 template <class T> using ObjectMemberFunc = bool (T::*)(EventArgs& args);
 
-struct CaseInsensitiveComparator
+// case folded hash of an event name, build one once and keep it wherever the same event is fired over and over
+struct EventId
 {
-	struct CaseInsensitiveCharCompare
-	{
-		inline bool operator()(unsigned char const& a, unsigned char const& b) const
-		{
-			return std::tolower(a) < std::tolower(b);
-		}
-	};
+public:
+	EventId() {}
+	explicit EventId(char const* eventName);
+	explicit EventId(std::string const& eventName);
 
-	inline bool operator()(std::string const& a, std::string const& b) const
-	{
-		bool result = std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), CaseInsensitiveCharCompare());
-		return result;
-	}
+	bool operator==(EventId const& other) const;
+	bool operator!=(EventId const& other) const;
+
+public:
+	uint64_t m_hash = 0;
 };
 
 struct EventSubscription
 {
-	EventCallbackFunction m_function;
+	EventCallbackFunction m_function = nullptr;
+	// set instead of m_function for an object's member function, owned by the subscription list
+	EventHandlerBase* m_handler = nullptr;
 };
 
 struct HandlerSubscription
@@ -46,10 +51,123 @@ public:
 	EventArgs args;
 };
 
+// posted from any thread, fired on the main thread at the next BeginFrame
+struct QueuedEvent
+{
+	EventId m_eventId;
+	EventArgs m_args;
+	bool m_isCoalesced = false;
+	// a later posting of the same coalesced event is in the same dispatch
+	bool m_isSuperseded = false;
+	QueuedEvent* m_nextQueuedEvent = nullptr;
+};
+
 typedef std::vector<EventSubscription> SubscriptionList;
 
 typedef std::vector<HandlerSubscription> EventHandleList;
 
+
+// flat open addressed table from EventId to a list, entries are never removed so an entry index stays good,
+// the first name an event was added under is kept for listing
+template <typename T>
+class EventIdTable
+{
+public:
+	struct Entry
+	{
+		EventId m_id;
+		std::string m_name;
+		T m_list;
+	};
+
+	// -1 when the event was never added
+	int Find(EventId id) const
+	{
+		if (m_slots.empty()) return -1;
+
+		int slotMask = (int)m_slots.size() - 1;
+		for (int slotIndex = (int)(id.m_hash & slotMask); ; slotIndex = (slotIndex + 1) & slotMask)
+		{
+			int entryIndex = m_slots[slotIndex];
+			if (entryIndex < 0 || m_entries[entryIndex].m_id == id)
+			{
+				return entryIndex;
+			}
+		}
+	}
+
+	int FindOrAdd(EventId id, std::string const& name)
+	{
+		int entryIndex = Find(id);
+		if (entryIndex >= 0)
+		{
+			if (_stricmp(m_entries[entryIndex].m_name.c_str(), name.c_str()) != 0)
+			{
+				ERROR_RECOVERABLE(Stringf("Event names \"%s\" and \"%s\" hash to the same EventId", m_entries[entryIndex].m_name.c_str(), name.c_str()));
+			}
+			return entryIndex;
+		}
+		return Add(id, name);
+	}
+
+	// for tables that are only ever looked up by id, the entry has no name to list or check
+	int FindOrAdd(EventId id)
+	{
+		int entryIndex = Find(id);
+		if (entryIndex >= 0)
+		{
+			return entryIndex;
+		}
+		return Add(id, std::string());
+	}
+
+	int GetNumEntries() const					{ return (int)m_entries.size(); }
+	Entry& GetEntry(int entryIndex)				{ return m_entries[entryIndex]; }
+	Entry const& GetEntry(int entryIndex) const	{ return m_entries[entryIndex]; }
+
+private:
+	int Add(EventId id, std::string const& name)
+	{
+		// kept at most half full so probes stay short
+		if (((int)m_entries.size() + 1) * 2 > (int)m_slots.size())
+		{
+			Rehash(m_slots.empty() ? 64 : (int)m_slots.size() * 2);
+		}
+
+		int entryIndex = (int)m_entries.size();
+		Entry entry = Entry();
+		entry.m_id = id;
+		entry.m_name = name;
+		m_entries.push_back(entry);
+		InsertSlot(id, entryIndex);
+		return entryIndex;
+	}
+
+	void Rehash(int numSlots)
+	{
+		m_slots.assign(numSlots, -1);
+		for (int entryIndex = 0; entryIndex < (int)m_entries.size(); entryIndex++)
+		{
+			InsertSlot(m_entries[entryIndex].m_id, entryIndex);
+		}
+	}
+
+	void InsertSlot(EventId id, int entryIndex)
+	{
+		int slotMask = (int)m_slots.size() - 1;
+		int slotIndex = (int)(id.m_hash & slotMask);
+		while (m_slots[slotIndex] >= 0)
+		{
+			slotIndex = (slotIndex + 1) & slotMask;
+		}
+		m_slots[slotIndex] = entryIndex;
+	}
+
+private:
+	std::vector<Entry> m_entries;
+	std::vector<int> m_slots;
+};
+
 struct EventSystemConfig
 {
 	InputSystem* input = nullptr;
@@ -68,8 +186,56 @@ public:
 	// event function
 	void SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction functionPtr);
 	void UnsubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction functionPtr);
+	template <class T>
+	inline void SubscribeEventCallbackObjectMethod(std::string const& eventName, T* obj, ObjectMemberFunc<T> funcPtr)
+	{
+		int entryIndex = m_subscriptionListsByEventName.FindOrAdd(EventId(eventName), eventName);
+		SubscriptionList& list = m_subscriptionListsByEventName.GetEntry(entryIndex).m_list;
+		for (int subscriber = 0; subscriber < int(list.size()); subscriber++)
+		{
+			EventHandler<T>* handler = (EventHandler<T>*)list[subscriber].m_handler;
+			if (handler && handler->GetHandler() == obj && handler->GetFunction() == funcPtr)
+			{
+				return;
+			}
+		}
+
+		EventSubscription subscription;
+		subscription.m_handler = new EventHandler<T>(obj, funcPtr);
+		list.push_back(subscription);
+	}
+
+	template <class T>
+	inline void UnsubscribeEventCallbackObjectMethod(std::string const& eventName, T* obj, ObjectMemberFunc<T> funcPtr)
+	{
+		int entryIndex = m_subscriptionListsByEventName.Find(EventId(eventName));
+		if (entryIndex < 0)
+		{
+			return;
+		}
+
+		SubscriptionList& list = m_subscriptionListsByEventName.GetEntry(entryIndex).m_list;
+		for (int subscriber = 0; subscriber < int(list.size()); subscriber++)
+		{
+			EventHandler<T>* handler = (EventHandler<T>*)list[subscriber].m_handler;
+			if (handler && handler->GetHandler() == obj && handler->GetFunction() == funcPtr)
+			{
+				delete handler;
+				list.erase(list.begin() + subscriber);
+				return;
+			}
+		}
+	}
+
 	void FireEvent(std::string const& eventName, EventArgs& args);
 	void FireEvent(std::string const& eventName);
+	void FireEvent(EventId eventId, EventArgs& args);
+	void FireEvent(EventId eventId);
+	// the only calls that are safe off the main thread, the event is fired in the next BeginFrame in posting order,
+	// a coalesced event fires once per frame with the args it was last posted with
+	void QueueEvent(std::string const& eventName, EventArgs const& args, bool coalesce = false);
+	void QueueEvent(EventId eventId, EventArgs const& args, bool coalesce = false);
+	void DispatchQueuedEvents();
 	void GetRegisteredEventNames(std::vector<std::string>& outNames) const;
 
 	//custom event handle
@@ -86,20 +252,23 @@ public:
 	{
 		EventHandlerBase* eventHandler = new EventHandler<T>(obj, funcPtr);
 
-		EventHandleList& list = m_handleList[handleName];
+		int entryIndex = m_handleList.FindOrAdd(EventId(handleName), handleName);
+		EventHandleList& list = m_handleList.GetEntry(entryIndex).m_list;
 		list.emplace_back(eventHandler, args);
 	}
 
 	void CallHandler(std::string const& handleName);
 	void CallHandler(std::string const& handleName, EventArgs& args);
+	void CallHandler(EventId handleId);
+	void CallHandler(EventId handleId, EventArgs& args);
 	void UnregisterEventHandler(std::string const& handleName);
 	void UnregisterAllEventsForObject(void* obj);
 	template <class T>
 	inline void UnregisterEventForObject(void* obj, ObjectMemberFunc<T> funcPtr)
 	{
-		for (auto& pair : m_handleList)
+		for (int entryIndex = 0; entryIndex < m_handleList.GetNumEntries(); entryIndex++)
 		{
-			EventHandleList& list = pair.second;
+			EventHandleList& list = m_handleList.GetEntry(entryIndex).m_list;
 			for (auto iter = list.begin(); iter != list.end();)
 			{
 				auto& item = *iter;
@@ -119,18 +288,56 @@ public:
 	}
 	void GetRegisterHandlerNames(std::vector<std::string>& outNames) const;
 
+	static bool Command_BenchmarkFireEvent(EventArgs& args);
+
 protected:
-	EventSystemConfig m_config;
-	std::map<std::string, SubscriptionList, CaseInsensitiveComparator> m_subscriptionListsByEventName;
+	QueuedEvent* AcquireQueuedEvent();
+	void ReleaseQueuedEvents(QueuedEvent* head, QueuedEvent* tail);
 
-	std::map<std::string, EventHandleList, CaseInsensitiveComparator> m_handleList;
+protected:
+	EventSystemConfig m_config;
+	EventIdTable<SubscriptionList> m_subscriptionListsByEventName;
+	// newest first, swapped out whole by DispatchQueuedEvents
+	std::atomic<QueuedEvent*> m_queuedEvents = nullptr;
+	// dispatched events come back here instead of being freed, a posting thread takes the whole stack when its own runs dry
+	std::atomic<QueuedEvent*> m_freeQueuedEvents = nullptr;
+	// the last dispatch each coalesced event was posted in
+	EventIdTable<int> m_coalescedEventDispatches;
+	int m_numberDispatches = 0;
+
+	EventIdTable<EventHandleList> m_handleList;
 };
 
 
 void SubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction functionPtr);
 void UnsubscribeEventCallbackFunction(std::string const& eventName, EventCallbackFunction functionPtr);
+
+template <class T>
+inline void SubscribeEventCallbackObjectMethod(std::string const& eventName, T* obj, ObjectMemberFunc<T> funcPtr)
+{
+	if (!g_theEventSystem)
+	{
+		return;
+	}
+	g_theEventSystem->SubscribeEventCallbackObjectMethod(eventName, obj, funcPtr);
+}
+
+template <class T>
+inline void UnsubscribeEventCallbackObjectMethod(std::string const& eventName, T* obj, ObjectMemberFunc<T> funcPtr)
+{
+	if (!g_theEventSystem)
+	{
+		return;
+	}
+	g_theEventSystem->UnsubscribeEventCallbackObjectMethod(eventName, obj, funcPtr);
+}
+
 void FireEvent(std::string const& eventName, EventArgs& args);
 void FireEvent(std::string const& eventName);
+void FireEvent(EventId eventId, EventArgs& args);
+void FireEvent(EventId eventId);
+void QueueEvent(std::string const& eventName, EventArgs const& args, bool coalesce = false);
+void QueueEvent(EventId eventId, EventArgs const& args, bool coalesce = false);
 
 template <class T>
 inline void RegisterEventHandler(std::string const& handleName, T* obj, ObjectMemberFunc<T> funcPtr)
@@ -154,6 +361,8 @@ inline void RegisterEventHandler(std::string const& handleName, T* obj, ObjectMe
 
 void CallHandler(std::string const& handleName);
 void CallHandler(std::string const& handleName, EventArgs& args);
+void CallHandler(EventId handleId);
+void CallHandler(EventId handleId, EventArgs& args);
 void UnregisterEventHandler(std::string const& handleName);
 void UnregisterAllEventsForObject(void* obj);
 template <class T>
@@ -1,7 +1,15 @@
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Compression.hpp"
+#include "Engine/Core/JobSystem.hpp"
 
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <string.h>
+
+FileIOQueue* g_theFileIOQueue = nullptr;
 
 bool FileExists(const std::string& filename)
 {
@@ -12,11 +20,17 @@ bool FileExists(const std::string& filename)
 
 
 int FileWriteFromBuffer(std::vector<uint8_t>& inBuffer, const std::string& filename)
+{
+	return FileWriteFromBuffer(inBuffer.data(), inBuffer.size(), filename);
+}
+
+
+int FileWriteFromBuffer(uint8_t const* data, size_t size, const std::string& filename)
 {
 	std::ofstream file(filename, std::ofstream::out | std::ofstream::binary);
 	if (file.is_open())
 	{
-		file.write((char*)inBuffer.data(), inBuffer.size());
+		file.write((char const*)data, size);
 		file.close();
 		return 0;
 	}
@@ -44,7 +58,6 @@ int FileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filenam
 
 int FileReadToString(std::string& outString, const std::string& filename)
 {
-	std::vector<uint8_t> outBuffer;
 	std::ifstream file(filename, std::ifstream::in);
 	if (file.is_open())
 	{
@@ -52,13 +65,319 @@ int FileReadToString(std::string& outString, const std::string& filename)
 		int size = (int)file.tellg();
 		file.seekg(0, file.beg);
 
-		outBuffer.resize(size);
-		file.read(reinterpret_cast<char*>(outBuffer.data()), outBuffer.size());
+		// read straight into the string, text mode drops the \r of each line so it ends up shorter than the file
+		outString.resize(size);
+		file.read(&outString[0], size);
+		outString.resize((size_t)file.gcount());
 		file.close();
-		outString = (char*)outBuffer.data() + '\0';
 		return 0;
 	}
 	return -1;
 }
 
 
+int FileWriteCompressedFromBuffer(std::vector<uint8_t> const& inBuffer, const std::string& filename)
+{
+	std::vector<uint8_t> frame;
+	CompressFrame(inBuffer.data(), (int)inBuffer.size(), frame);
+	return FileWriteFromBuffer(frame, filename);
+}
+
+
+int FileReadCompressedToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename)
+{
+	// decompressed straight out of the mapping, the compressed bytes are never copied
+	MappedFile file(filename);
+	if (!file.IsOpen()) return -1;
+
+	outBuffer.clear();
+	if (DecompressFrame(file.GetData(), (int)file.GetSize(), outBuffer) < 0) return -1;
+	return 0;
+}
+
+
+void FindFilesInFolder(std::string const& folder, std::string const& pattern, std::vector<std::string>& outFilenames, bool includeSubfolders)
+{
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA((folder + "/" + pattern).c_str(), &findData);
+	if (findHandle != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+			{
+				outFilenames.push_back(folder + "/" + findData.cFileName);
+			}
+		} while (FindNextFileA(findHandle, &findData));
+		FindClose(findHandle);
+	}
+
+	if (!includeSubfolders) return;
+
+	// the pattern only applies to files, every folder is searched
+	findHandle = FindFirstFileA((folder + "/*").c_str(), &findData);
+	if (findHandle == INVALID_HANDLE_VALUE) return;
+	do
+	{
+		bool isFolder = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+		if (isFolder && strcmp(findData.cFileName, ".") != 0 && strcmp(findData.cFileName, "..") != 0)
+		{
+			FindFilesInFolder(folder + "/" + findData.cFileName, pattern, outFilenames, true);
+		}
+	} while (FindNextFileA(findHandle, &findData));
+	FindClose(findHandle);
+}
+
+
+MappedFile::MappedFile(std::string const& filename)
+{
+	Open(filename);
+}
+
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+
+bool MappedFile::Open(std::string const& filename)
+{
+	Close();
+
+	HANDLE fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize))
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	m_fileHandle = fileHandle;
+	m_isOpen = true;
+
+	// an empty file cannot be mapped, it opens with no data instead
+	if (fileSize.QuadPart == 0) return true;
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle)
+	{
+		Close();
+		return false;
+	}
+	m_mappingHandle = mappingHandle;
+
+	m_data = static_cast<uint8_t const*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!m_data)
+	{
+		Close();
+		return false;
+	}
+	m_size = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+
+void MappedFile::Close()
+{
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mappingHandle)
+	{
+		CloseHandle(m_mappingHandle);
+	}
+	if (m_fileHandle)
+	{
+		CloseHandle(m_fileHandle);
+	}
+
+	m_fileHandle = nullptr;
+	m_mappingHandle = nullptr;
+	m_data = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+}
+
+
+bool MappedFile::IsOpen() const
+{
+	return m_isOpen;
+}
+
+
+uint8_t const* MappedFile::GetData() const
+{
+	return m_data;
+}
+
+
+size_t MappedFile::GetSize() const
+{
+	return m_size;
+}
+
+
+uint8_t const* MappedFile::begin() const
+{
+	return m_data;
+}
+
+
+uint8_t const* MappedFile::end() const
+{
+	return m_data + m_size;
+}
+
+
+FileIOQueue::~FileIOQueue()
+{
+	ShutDown();
+}
+
+
+void FileIOQueue::Startup()
+{
+	m_isQuitting = false;
+	m_thread = new std::thread(&FileIOQueue::FileIOThreadMain, this);
+}
+
+
+void FileIOQueue::ShutDown()
+{
+	if (!m_thread) return;
+
+	// queued writes still go to disk, the thread only quits once the queue is empty
+	m_requestsMutex.lock();
+	m_isQuitting = true;
+	m_requestsMutex.unlock();
+	m_requestsCondition.notify_all();
+
+	if (m_thread->joinable())
+	{
+		m_thread->join();
+	}
+	delete m_thread;
+	m_thread = nullptr;
+}
+
+
+void FileIOQueue::ReadFileAsync(std::string const& filename, std::function<void(FileIORequest& request)> const& onCompleted)
+{
+	FileIORequest* request = new FileIORequest();
+	request->m_type = FileIORequestType::READ;
+	request->m_filename = filename;
+	request->m_onCompleted = onCompleted;
+	QueueRequest(request);
+}
+
+
+void FileIOQueue::WriteFileAsync(std::string const& filename, std::vector<uint8_t>&& buffer, std::function<void(FileIORequest& request)> const& onCompleted)
+{
+	FileIORequest* request = new FileIORequest();
+	request->m_type = FileIORequestType::WRITE;
+	request->m_filename = filename;
+	request->m_buffer = std::move(buffer);
+	request->m_onCompleted = onCompleted;
+	QueueRequest(request);
+}
+
+
+void FileIOQueue::WaitForFile(std::string const& filename)
+{
+	std::unique_lock<std::mutex> lock(m_requestsMutex);
+	m_requestDoneCondition.wait(lock, [this, &filename]() { return m_numberPendingRequestsByFile.find(filename) == m_numberPendingRequestsByFile.end(); });
+}
+
+
+void FileIOQueue::WaitForAll()
+{
+	std::unique_lock<std::mutex> lock(m_requestsMutex);
+	m_requestDoneCondition.wait(lock, [this]() { return m_numberPendingRequests == 0; });
+}
+
+
+int FileIOQueue::GetNumberPendingRequests() const
+{
+	m_requestsMutex.lock();
+	int numberPendingRequests = m_numberPendingRequests;
+	m_requestsMutex.unlock();
+	return numberPendingRequests;
+}
+
+
+void FileIOQueue::QueueRequest(FileIORequest* request)
+{
+	// without the thread running the request is done right away on the calling thread
+	if (!m_thread)
+	{
+		ExecuteRequest(request);
+		return;
+	}
+
+	m_requestsMutex.lock();
+	m_requests.push_back(request);
+	m_numberPendingRequestsByFile[request->m_filename]++;
+	m_numberPendingRequests++;
+	m_requestsMutex.unlock();
+	m_requestsCondition.notify_one();
+}
+
+
+void FileIOQueue::FileIOThreadMain()
+{
+	while (true)
+	{
+		FileIORequest* request = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_requestsMutex);
+			m_requestsCondition.wait(lock, [this]() { return !m_requests.empty() || m_isQuitting; });
+			if (m_requests.empty()) return;
+			request = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		std::string filename = request->m_filename;
+		ExecuteRequest(request);
+
+		m_requestsMutex.lock();
+		std::map<std::string, int>::iterator pendingItr = m_numberPendingRequestsByFile.find(filename);
+		pendingItr->second--;
+		if (pendingItr->second == 0)
+		{
+			m_numberPendingRequestsByFile.erase(pendingItr);
+		}
+		m_numberPendingRequests--;
+		m_requestsMutex.unlock();
+		m_requestDoneCondition.notify_all();
+	}
+}
+
+
+void FileIOQueue::ExecuteRequest(FileIORequest* request)
+{
+	if (request->m_type == FileIORequestType::READ)
+	{
+		request->m_result = FileReadToBuffer(request->m_buffer, request->m_filename);
+	}
+	else
+	{
+		request->m_result = FileWriteFromBuffer(request->m_buffer, request->m_filename);
+	}
+
+	if (!request->m_onCompleted || !g_theJobSystem)
+	{
+		delete request;
+		return;
+	}
+
+	// the buffer travels with the request, the callback can swap it out instead of copying
+	std::shared_ptr<FileIORequest> completedRequest(request);
+	g_theJobSystem->RunOnMainThread([completedRequest]()
+	{
+		completedRequest->m_onCompleted(*completedRequest);
+	});
+}
@@ -1,10 +1,111 @@
 #pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+class FileIOQueue;
+
+extern FileIOQueue* g_theFileIOQueue;
+
 bool FileExists(const std::string& filename);
 int FileWriteFromBuffer(std::vector<uint8_t>& inBuffer, const std::string& filename);
+int FileWriteFromBuffer(uint8_t const* data, size_t size, const std::string& filename);
 int FileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename);
 int FileReadToString(std::string& outString, const std::string& filename);
+// the buffer is written as one compressed frame, see Compression.hpp
+int FileWriteCompressedFromBuffer(std::vector<uint8_t> const& inBuffer, const std::string& filename);
+// -1 for a missing file or one that is not a whole frame
+int FileReadCompressedToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename);
+// paths of the files in folder that match a pattern such as *.chunk, appended to outFilenames
+void FindFilesInFolder(std::string const& folder, std::string const& pattern, std::vector<std::string>& outFilenames, bool includeSubfolders = false);
+
+
+// read only view of a file mapped into memory, the OS pages it in on first touch and nothing is copied
+class MappedFile
+{
+public:
+	MappedFile() {}
+	explicit MappedFile(std::string const& filename);
+	~MappedFile();
+	MappedFile(MappedFile const& copy) = delete;
+	MappedFile& operator=(MappedFile const& copy) = delete;
+
+	bool Open(std::string const& filename);
+	void Close();
+
+	bool IsOpen() const;
+	// valid until Close, null for a missing or empty file
+	uint8_t const* GetData() const;
+	size_t GetSize() const;
+	uint8_t const* begin() const;
+	uint8_t const* end() const;
+
+private:
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+	uint8_t const* m_data = nullptr;
+	size_t m_size = 0;
+	bool m_isOpen = false;
+};
+
+
+enum class FileIORequestType
+{
+	READ,
+	WRITE,
+};
+
+
+struct FileIORequest
+{
+	FileIORequestType m_type = FileIORequestType::READ;
+	std::string m_filename;
+	// filled by a read, handed over by a write
+	std::vector<uint8_t> m_buffer;
+	// 0 on success, like FileReadToBuffer
+	int m_result = -1;
+	std::function<void(FileIORequest& request)> m_onCompleted;
+};
+
+
+// one thread does every queued read and write in order, so a file read right after a write sees the new data
+class FileIOQueue
+{
+public:
+	FileIOQueue() {}
+	~FileIOQueue();
+	void Startup();
+	void ShutDown();
+
+	// the callback runs on the main thread in the next JobSystem::BeginFrame and may take the buffer
+	void ReadFileAsync(std::string const& filename, std::function<void(FileIORequest& request)> const& onCompleted);
+	// the buffer is moved in, the callback is optional
+	void WriteFileAsync(std::string const& filename, std::vector<uint8_t>&& buffer, std::function<void(FileIORequest& request)> const& onCompleted = nullptr);
+
+	// blocks until every request queued for this file is done
+	void WaitForFile(std::string const& filename);
+	void WaitForAll();
+	int GetNumberPendingRequests() const;
+
+private:
+	void QueueRequest(FileIORequest* request);
+	void FileIOThreadMain();
+	void ExecuteRequest(FileIORequest* request);
 
+private:
+	std::thread* m_thread = nullptr;
+	bool m_isQuitting = false;
 
+	std::deque<FileIORequest*> m_requests;
+	// counts queued and running requests, so WaitForFile does not return while one is still being written
+	std::map<std::string, int> m_numberPendingRequestsByFile;
+	int m_numberPendingRequests = 0;
+	mutable std::mutex m_requestsMutex;
+	std::condition_variable m_requestsCondition;
+	std::condition_variable m_requestDoneCondition;
+};
@@ -0,0 +1,171 @@
+#include "Engine/Core/FrameAllocator.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystem.hpp"
+
+#include <atomic>
+#include <malloc.h>
+
+constexpr size_t FRAME_ARENA_ALIGNMENT = 64;
+
+struct FrameArena
+{
+	unsigned char* m_memory = nullptr;
+	size_t m_capacityBytes = 0;
+	std::atomic<size_t> m_usedBytes{ 0 };
+	// what went to the heap while this arena was current, the arena grows by this much when it is rewound
+	std::atomic<size_t> m_overflowBytes{ 0 };
+};
+
+static FrameArena s_frameArenas[2];
+static std::atomic<int> s_currentFrameArena{ 0 };
+static std::atomic<int> s_frameAllocations{ 0 };
+static std::atomic<size_t> s_frameBytes{ 0 };
+static std::atomic<int> s_frameHeapFallbacks{ 0 };
+static FrameArenaStats s_frameArenaStats;
+
+static bool Command_FrameArena(EventArgs& args);
+
+
+static bool IsInFrameArena(FrameArena const& arena, unsigned char const* memory)
+{
+	return arena.m_memory && memory >= arena.m_memory && memory < arena.m_memory + arena.m_capacityBytes;
+}
+
+
+void FrameArenaStartup(size_t bytesPerFrame)
+{
+	for (int arenaIndex = 0; arenaIndex < 2; arenaIndex++)
+	{
+		FrameArena& arena = s_frameArenas[arenaIndex];
+		arena.m_memory = static_cast<unsigned char*>(_aligned_malloc(bytesPerFrame, FRAME_ARENA_ALIGNMENT));
+		arena.m_capacityBytes = bytesPerFrame;
+		arena.m_usedBytes = 0;
+		arena.m_overflowBytes = 0;
+	}
+	s_currentFrameArena = 0;
+
+	SubscribeEventCallbackFunction("frameArena", Command_FrameArena);
+}
+
+
+void FrameArenaShutdown()
+{
+	for (int arenaIndex = 0; arenaIndex < 2; arenaIndex++)
+	{
+		FrameArena& arena = s_frameArenas[arenaIndex];
+		_aligned_free(arena.m_memory);
+		arena.m_memory = nullptr;
+		arena.m_capacityBytes = 0;
+		arena.m_usedBytes = 0;
+		arena.m_overflowBytes = 0;
+	}
+}
+
+
+void FrameArenaBeginFrame()
+{
+	s_frameArenaStats.m_frameBytes = s_frameBytes.exchange(0);
+	s_frameArenaStats.m_frameAllocations = s_frameAllocations.exchange(0);
+	s_frameArenaStats.m_frameHeapFallbacks = s_frameHeapFallbacks.exchange(0);
+	s_frameArenaStats.m_totalHeapFallbacks += s_frameArenaStats.m_frameHeapFallbacks;
+	if (s_frameArenaStats.m_frameBytes > s_frameArenaStats.m_peakFrameBytes)
+	{
+		s_frameArenaStats.m_peakFrameBytes = s_frameArenaStats.m_frameBytes;
+	}
+
+	// the other arena was last written two frames ago, so it is safe to rewind and, if it overflowed, to grow
+	int nextArenaIndex = 1 - s_currentFrameArena;
+	FrameArena& nextArena = s_frameArenas[nextArenaIndex];
+	if (nextArena.m_memory && nextArena.m_overflowBytes > 0)
+	{
+		size_t neededBytes = nextArena.m_usedBytes + nextArena.m_overflowBytes;
+		size_t newCapacity = nextArena.m_capacityBytes;
+		while (newCapacity < neededBytes)
+		{
+			newCapacity *= 2;
+		}
+		_aligned_free(nextArena.m_memory);
+		nextArena.m_memory = static_cast<unsigned char*>(_aligned_malloc(newCapacity, FRAME_ARENA_ALIGNMENT));
+		nextArena.m_capacityBytes = newCapacity;
+	}
+	nextArena.m_usedBytes = 0;
+	nextArena.m_overflowBytes = 0;
+	s_currentFrameArena = nextArenaIndex;
+}
+
+
+void* FrameArenaAllocate(size_t numBytes, size_t alignment)
+{
+	s_frameAllocations++;
+	s_frameBytes += numBytes;
+	FrameArena& arena = s_frameArenas[s_currentFrameArena];
+	if (arena.m_memory)
+	{
+		size_t usedBytes = arena.m_usedBytes.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			size_t alignedOffset = (usedBytes + alignment - 1) & ~(alignment - 1);
+			size_t newUsedBytes = alignedOffset + numBytes;
+			if (newUsedBytes > arena.m_capacityBytes)
+			{
+				break;
+			}
+			if (arena.m_usedBytes.compare_exchange_weak(usedBytes, newUsedBytes, std::memory_order_relaxed))
+			{
+				return arena.m_memory + alignedOffset;
+			}
+		}
+	}
+
+	arena.m_overflowBytes += numBytes + alignment;
+	s_frameHeapFallbacks++;
+	return _aligned_malloc(numBytes, alignment);
+}
+
+
+void FrameArenaFree(void* memory, size_t numBytes)
+{
+	if (!memory) return;
+
+	unsigned char* bytes = static_cast<unsigned char*>(memory);
+	for (int arenaIndex = 0; arenaIndex < 2; arenaIndex++)
+	{
+		FrameArena& arena = s_frameArenas[arenaIndex];
+		if (IsInFrameArena(arena, bytes))
+		{
+			// popping the top lets a vector that is cleared and rebuilt in the same frame reuse its space
+			if (arenaIndex == s_currentFrameArena)
+			{
+				size_t offset = bytes - arena.m_memory;
+				size_t expectedUsedBytes = offset + numBytes;
+				arena.m_usedBytes.compare_exchange_strong(expectedUsedBytes, offset, std::memory_order_relaxed);
+			}
+			return;
+		}
+	}
+
+	_aligned_free(memory);
+}
+
+
+FrameArenaStats GetFrameArenaStats()
+{
+	FrameArenaStats stats = s_frameArenaStats;
+	stats.m_capacityBytes = s_frameArenas[s_currentFrameArena].m_capacityBytes;
+	return stats;
+}
+
+
+static bool Command_FrameArena(EventArgs& args)
+{
+	UNUSED(args)
+
+	FrameArenaStats stats = GetFrameArenaStats();
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, "## Frame arena ##");
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("capacity %.2fMB per frame, last frame %.2fMB in %i allocations, peak %.2fMB",
+		static_cast<double>(stats.m_capacityBytes) / (1024.0 * 1024.0), static_cast<double>(stats.m_frameBytes) / (1024.0 * 1024.0), stats.m_frameAllocations,
+		static_cast<double>(stats.m_peakFrameBytes) / (1024.0 * 1024.0)));
+	Rgba8 fallbackColor = stats.m_frameHeapFallbacks > 0 ? DevConsole::INFO_WARNING : DevConsole::INFO_MINOR;
+	g_theDevConsole->AddLine(fallbackColor, Stringf("heap fallbacks %i last frame, %i total", stats.m_frameHeapFallbacks, stats.m_totalHeapFallbacks));
+	return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// transient per frame memory, two linear arenas that swap at FrameArenaBeginFrame,
+// so anything allocated this frame stays valid until the end of the next one
+struct FrameArenaStats
+{
+	size_t m_capacityBytes = 0;
+	// last completed frame, bytes is everything requested including what was handed back
+	size_t m_frameBytes = 0;
+	int m_frameAllocations = 0;
+	// allocations that did not fit and went to the heap instead, the arena grows to cover them
+	int m_frameHeapFallbacks = 0;
+	size_t m_peakFrameBytes = 0;
+	int m_totalHeapFallbacks = 0;
+};
+
+
+// Setup
+void FrameArenaStartup(size_t bytesPerFrame = 4 * 1024 * 1024);
+void FrameArenaShutdown();
+// flips to the other arena and rewinds it, nothing allocated two frames ago may still be in use
+void FrameArenaBeginFrame();
+
+// thread safe, falls back to the heap when the arena is full or was never started
+void* FrameArenaAllocate(size_t numBytes, size_t alignment = alignof(std::max_align_t));
+// only the most recent allocation is actually given back, everything else waits for the rewind
+void FrameArenaFree(void* memory, size_t numBytes);
+FrameArenaStats GetFrameArenaStats();
+
+
+// stateless STL allocator on top of the frame arena
+template <typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+
+	FrameAllocator() = default;
+	template <typename U>
+	FrameAllocator(FrameAllocator<U> const&) {}
+
+	T* allocate(size_t count)
+	{
+		return static_cast<T*>(FrameArenaAllocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* memory, size_t count)
+	{
+		FrameArenaFree(memory, count * sizeof(T));
+	}
+};
+
+template <typename T, typename U>
+bool operator==(FrameAllocator<T> const&, FrameAllocator<U> const&) { return true; }
+template <typename T, typename U>
+bool operator!=(FrameAllocator<T> const&, FrameAllocator<U> const&) { return false; }
+
+
+// for geometry and scratch lists built and drawn in the same frame, reserve up front since every regrowth leaves the old block behind until the rewind
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
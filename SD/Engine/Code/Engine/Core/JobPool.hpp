@@ -0,0 +1,115 @@
+#pragma once
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class JobPoolBase
+{
+public:
+	virtual ~JobPoolBase() {}
+	virtual void ReleaseJob(Job* job) = 0;
+
+	// slabs allocated by every pool, jobStats and the benchmarks report it
+	static int GetTotalHeapAllocations()	{ return s_totalHeapAllocations; }
+
+protected:
+	void SetOwningPool(Job* job)
+	{
+		job->m_pool = this;
+	}
+
+protected:
+	static std::atomic<int> s_totalHeapAllocations;
+};
+
+
+// recycles jobs of one type out of slabs, the heap is only touched when every slot is in use
+template <typename T>
+class JobPool : public JobPoolBase
+{
+	static_assert(alignof(T) <= alignof(std::max_align_t), "JobPool slabs only guarantee default new alignment");
+
+public:
+	explicit JobPool(int jobsPerSlab = 64)
+		: m_jobsPerSlab(jobsPerSlab > 0 ? jobsPerSlab : 1)
+	{
+	}
+
+	~JobPool()
+	{
+		// a worker may still hold a live job, freeing its slab would leave it running on freed memory
+		GUARANTEE_OR_DIE(m_numberLiveJobs == 0, "JobPool destroyed while jobs are still in use");
+		for (int slabIndex = 0; slabIndex < (int)m_slabs.size(); slabIndex++)
+		{
+			delete[] m_slabs[slabIndex];
+		}
+		m_slabs.clear();
+	}
+
+	JobPool(JobPool const& copy) = delete;
+
+	template <typename... Args>
+	inline T* Acquire(Args&&... args)
+	{
+		m_mutex.lock();
+		if (m_freeSlots.empty())
+		{
+			AllocateSlab();
+		}
+		void* slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+		m_numberLiveJobs++;
+		m_numberAcquires++;
+		m_mutex.unlock();
+
+		T* job = new (slot) T(std::forward<Args>(args)...);
+		SetOwningPool(job);
+		return job;
+	}
+
+	virtual void ReleaseJob(Job* job) override
+	{
+		T* typedJob = static_cast<T*>(job);
+		typedJob->~T();
+
+		m_mutex.lock();
+		m_freeSlots.push_back(typedJob);
+		m_numberLiveJobs--;
+		m_mutex.unlock();
+	}
+
+	int GetNumberHeapAllocations() const	{ return m_numberHeapAllocations; }
+	int GetNumberLiveJobs() const			{ return m_numberLiveJobs; }
+	int GetNumberAcquires() const			{ return m_numberAcquires; }
+
+private:
+	void AllocateSlab()
+	{
+		unsigned char* slab = new unsigned char[sizeof(T) * m_jobsPerSlab];
+		m_slabs.push_back(slab);
+		m_numberHeapAllocations++;
+		s_totalHeapAllocations++;
+
+		// sized for every slot up front so ReleaseJob never grows the free list
+		m_freeSlots.reserve(m_slabs.size() * m_jobsPerSlab);
+		for (int slotIndex = m_jobsPerSlab - 1; slotIndex >= 0; slotIndex--)
+		{
+			m_freeSlots.push_back(slab + slotIndex * sizeof(T));
+		}
+	}
+
+private:
+	int m_jobsPerSlab = 64;
+	std::vector<unsigned char*> m_slabs;
+	std::vector<void*> m_freeSlots;
+	std::mutex m_mutex;
+
+	std::atomic<int> m_numberHeapAllocations = 0;
+	std::atomic<int> m_numberLiveJobs = 0;
+	std::atomic<int> m_numberAcquires = 0;
+};
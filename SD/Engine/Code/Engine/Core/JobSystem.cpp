@@ -1,4 +1,95 @@
 #include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/JobPool.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <cfloat>
+
+JobSystem* g_theJobSystem = nullptr;
+
+std::mutex Job::s_dependencyMutex;
+
+thread_local JobWorkerThread* t_currentWorkerThread = nullptr;
+std::atomic<int> JobPoolBase::s_totalHeapAllocations(0);
+
+
+struct ParallelForState
+{
+	std::function<void(int, int)> const* m_batchFunction = nullptr;
+	JobSystem* m_jobSystem = nullptr;
+	// the caller and every helper job hold one, a helper that starts late finds no batches left but still reads the counters
+	std::atomic<int> m_numberReferences = 0;
+	int m_begin = 0;
+	int m_end = 0;
+	int m_grainSize = 1;
+	int m_numberBatches = 0;
+	std::atomic<int> m_nextBatch = 0;
+	std::atomic<int> m_numberBatchesDone = 0;
+
+	void RunBatches()
+	{
+		int batchIndex = m_nextBatch++;
+		while (batchIndex < m_numberBatches)
+		{
+			int batchBegin = m_begin + batchIndex * m_grainSize;
+			int batchEnd = batchBegin + m_grainSize < m_end ? batchBegin + m_grainSize : m_end;
+			(*m_batchFunction)(batchBegin, batchEnd);
+			m_numberBatchesDone++;
+			batchIndex = m_nextBatch++;
+		}
+	}
+};
+
+
+class ParallelForJob : public Job
+{
+public:
+	ParallelForJob(ParallelForState* state)
+		: Job(JOB_TYPE_ANY)
+		, m_state(state)
+	{
+		SetDeleteOnCompletion(true);
+	}
+
+	// a discarded helper never executes, so the state is let go of here rather than in Execute
+	~ParallelForJob()
+	{
+		m_state->m_jobSystem->ReleaseParallelForState(m_state);
+	}
+
+private:
+	virtual void Execute() override
+	{
+		m_state->RunBatches();
+	}
+
+	virtual void OnFinished() override
+	{
+	}
+
+private:
+	ParallelForState* m_state = nullptr;
+};
+
+
+bool JobCounter::IsDone() const
+{
+	return m_numberUnfinishedJobs == 0;
+}
+
+
+int JobCounter::GetNumberUnfinishedJobs() const
+{
+	return m_numberUnfinishedJobs;
+}
+
 
 Job::Job(uint8_t jobType, int jobIndex)
 	: m_jobType(jobType)
@@ -31,81 +122,450 @@ JobState Job::GetJobState() const
 }
 
 
-JobWorkerThread::JobWorkerThread(JobSystem* jobSystem, int workerThreadID)
+uint8_t Job::GetJobType() const
+{
+	return m_jobType;
+}
+
+
+bool Job::IsPooled() const
+{
+	return m_pool != nullptr;
+}
+
+
+void Job::SetDeleteOnCompletion(bool deleteOnCompletion)
+{
+	m_deleteOnCompletion = deleteOnCompletion;
+}
+
+
+void Job::Cancel()
+{
+	m_isCancelled = true;
+}
+
+
+bool Job::IsCancelled() const
+{
+	return m_isCancelled;
+}
+
+
+bool Job::IsPrioritized() const
+{
+	return m_isPrioritized;
+}
+
+
+float Job::GetPriority() const
+{
+	return m_priority;
+}
+
+
+void Job::AddDependency(Job* dependency)
+{
+	s_dependencyMutex.lock();
+	dependency->m_dependentJobsMutex.lock();
+	if (!dependency->m_isFinished)
+	{
+		if (dependency->m_numberDependentJobs < NUM_INLINE_DEPENDENT_JOBS)
+		{
+			dependency->m_inlineDependentJobs[dependency->m_numberDependentJobs] = this;
+		}
+		else
+		{
+			dependency->m_extraDependentJobs.push_back(this);
+		}
+		dependency->m_numberDependentJobs++;
+		m_numberUnfinishedDependencies++;
+		m_dependencyJobs.push_back(dependency);
+	}
+	dependency->m_dependentJobsMutex.unlock();
+	s_dependencyMutex.unlock();
+}
+
+
+void Job::MarkFinished()
+{
+	// once finished no dependents can be added, so the list can be read without the lock afterwards
+	m_dependentJobsMutex.lock();
+	m_isFinished = true;
+	m_dependentJobsMutex.unlock();
+}
+
+
+int Job::GetNumberDependentJobs() const
+{
+	return m_numberDependentJobs;
+}
+
+
+Job* Job::GetDependentJob(int index) const
+{
+	if (index < NUM_INLINE_DEPENDENT_JOBS)
+	{
+		return m_inlineDependentJobs[index];
+	}
+	return m_extraDependentJobs[index - NUM_INLINE_DEPENDENT_JOBS];
+}
+
+
+bool Job::RemoveDependentJob(Job* dependentJob)
+{
+	// a finished job is already releasing its dependents, it has to be left to do so
+	bool wasRemoved = false;
+	m_dependentJobsMutex.lock();
+	if (!m_isFinished)
+	{
+		for (int jobIndex = 0; jobIndex < m_numberDependentJobs; jobIndex++)
+		{
+			if (GetDependentJob(jobIndex) != dependentJob)
+			{
+				continue;
+			}
+
+			Job* lastJob = GetDependentJob(m_numberDependentJobs - 1);
+			if (jobIndex < NUM_INLINE_DEPENDENT_JOBS)
+			{
+				m_inlineDependentJobs[jobIndex] = lastJob;
+			}
+			else
+			{
+				m_extraDependentJobs[jobIndex - NUM_INLINE_DEPENDENT_JOBS] = lastJob;
+			}
+			m_numberDependentJobs--;
+			if (m_numberDependentJobs >= NUM_INLINE_DEPENDENT_JOBS)
+			{
+				m_extraDependentJobs.pop_back();
+			}
+			wasRemoved = true;
+			break;
+		}
+	}
+	m_dependentJobsMutex.unlock();
+	return wasRemoved;
+}
+
+
+void Job::RemoveDependency(Job* dependency)
+{
+	for (int jobIndex = 0; jobIndex < (int)m_dependencyJobs.size(); jobIndex++)
+	{
+		if (m_dependencyJobs[jobIndex] == dependency)
+		{
+			m_dependencyJobs[jobIndex] = m_dependencyJobs.back();
+			m_dependencyJobs.pop_back();
+			return;
+		}
+	}
+}
+
+
+void Job::ClearDependentJobs()
+{
+	m_numberDependentJobs = 0;
+	m_extraDependentJobs.clear();
+}
+
+
+JobWorkerThread::JobWorkerThread(JobSystem* jobSystem, JobWorkerPool* pool, int workerThreadID, int coreIndex)
 	: m_jobSystem(jobSystem)
+	, m_pool(pool)
 	, m_workerThreadID(workerThreadID)
+	, m_jobMask(pool->GetJobTypes())
+	, m_coreIndex(coreIndex)
 {
-	m_thread = new std::thread(&JobWorkerThread::JobWorkerMain, this);
 }
 
 
 JobWorkerThread::~JobWorkerThread()
 {
+	delete m_thread;
+	m_thread = nullptr;
+}
+
+
+void JobWorkerThread::Start()
+{
+	m_thread = new std::thread(&JobWorkerThread::JobWorkerMain, this);
+	// an affinity mask only reaches the cores of the first processor group, anything past it stays unpinned
+	if (m_coreIndex >= 0 && m_coreIndex < (int)(sizeof(DWORD_PTR) * 8))
+	{
+		SetThreadAffinityMask(m_thread->native_handle(), static_cast<DWORD_PTR>(1) << m_coreIndex);
+	}
 }
 
 
 void JobWorkerThread::JobWorkerMain()
 {
+	t_currentWorkerThread = this;
+	if (g_theProfiler)
+	{
+		g_theProfiler->SetCurrentThreadName(m_jobSystem->GetWorkerThreadName(m_workerThreadID));
+	}
 	while (!m_isQuitting)
 	{
-		Job* jobToExecute = m_jobSystem->SendJobToExecute();
-		if (jobToExecute != nullptr && (jobToExecute->m_jobType & m_jobMask) != 0)
+		Job* jobToExecute = m_jobSystem->SendJobToExecute(m_workerThreadID);
+		if (jobToExecute == nullptr)
 		{
-			jobToExecute->Execute();
-			m_jobSystem->MoveJobToCompletedList(jobToExecute);
+			jobToExecute = SpinForJob();
 		}
-		else
+
+		if (jobToExecute == nullptr)
+		{
+			// publish the parked flag before the last look so a concurrent submit either sees it or is seen here
+			m_isParked = true;
+			jobToExecute = m_jobSystem->SendJobToExecute(m_workerThreadID);
+			if (jobToExecute == nullptr)
+			{
+				WaitForWake();
+				continue;
+			}
+			m_isParked = false;
+		}
+
+		m_jobSystem->ExecuteJob(jobToExecute, m_workerThreadID);
+	}
+}
+
+
+Job* JobWorkerThread::SpinForJob()
+{
+	int spinMicroseconds = m_jobSystem->GetWorkerSpinMicroseconds();
+	if (spinMicroseconds <= 0)
+	{
+		return nullptr;
+	}
+
+	double spinSeconds = static_cast<double>(spinMicroseconds) * 0.000001;
+	double startTime = GetCurrentTimeSeconds();
+	double elapsedTime = 0.0;
+	Job* job = nullptr;
+	while (!m_isQuitting && elapsedTime < spinSeconds)
+	{
+		std::this_thread::yield();
+		job = m_jobSystem->SendJobToExecute(m_workerThreadID);
+		elapsedTime = GetCurrentTimeSeconds() - startTime;
+		if (job)
 		{
-			std::this_thread::sleep_for(std::chrono::microseconds(1));
+			break;
 		}
 	}
+
+	m_spinMicroseconds += static_cast<int64_t>(elapsedTime * 1000000.0);
+	return job;
+}
+
+
+void JobWorkerThread::WaitForWake()
+{
+	m_numberParks++;
+
+	std::unique_lock<std::mutex> lock(m_parkMutex);
+	m_parkCondition.wait(lock, [this]() { return m_wakeRequested || m_isQuitting; });
+	if (m_wakeRequested)
+	{
+		m_numberWakeups++;
+	}
+	m_wakeRequested = false;
+	m_isParked = false;
 }
 
 
-void JobWorkerThread::SetAllowedJobTypes(uint8_t jobMask)
+void JobWorkerThread::Wake()
 {
-	m_jobMask = jobMask;
+	m_parkMutex.lock();
+	m_wakeRequested = true;
+	m_parkMutex.unlock();
+	m_parkCondition.notify_one();
 }
 
 
-void JobWorkerThread::AddAllowedJobTypes(uint8_t jobMask)
+bool JobWorkerThread::CanExecuteJob(Job const* job) const
 {
-	m_jobMask |= jobMask;
+	return (job->m_jobType & m_jobMask) != 0;
 }
 
 
 void JobWorkerThread::Quit()
 {
+	m_parkMutex.lock();
 	m_isQuitting = true;
+	m_parkMutex.unlock();
+	m_parkCondition.notify_one();
+}
+
+
+void JobWorkerThread::SubmitJob(Job* job)
+{
+	Job* head = m_submittedJobs.load(std::memory_order_relaxed);
+	do
+	{
+		job->m_nextSubmittedJob = head;
+	} while (!m_submittedJobs.compare_exchange_weak(head, job, std::memory_order_seq_cst, std::memory_order_relaxed));
+}
+
+
+bool JobWorkerThread::MoveSubmittedJobsTo(WorkStealingQueue& queue)
+{
+	Job* head = m_submittedJobs.exchange(nullptr, std::memory_order_seq_cst);
+	if (!head)
+	{
+		return false;
+	}
+
+	Job* reversedHead = nullptr;
+	while (head)
+	{
+		Job* next = head->m_nextSubmittedJob;
+		head->m_nextSubmittedJob = reversedHead;
+		reversedHead = head;
+		head = next;
+	}
+
+	while (reversedHead)
+	{
+		Job* next = reversedHead->m_nextSubmittedJob;
+		reversedHead->m_nextSubmittedJob = nullptr;
+		queue.Push(reversedHead);
+		reversedHead = next;
+	}
+	return true;
+}
+
+
+JobWorkerPool::JobWorkerPool(JobWorkerPoolConfig const& config, int poolIndex)
+	: m_config(config)
+	, m_poolIndex(poolIndex)
+{
+}
+
+
+std::string const& JobWorkerPool::GetName() const
+{
+	return m_config.m_name;
+}
+
+
+uint8_t JobWorkerPool::GetJobTypes() const
+{
+	return m_config.m_jobTypes;
+}
+
+
+int JobWorkerPool::GetNumberWorkerThreads() const
+{
+	return (int)m_workerThreads.size();
 }
 
 
 JobSystem::JobSystem(JobSystemConfig const& config)
 	: m_config(config)
 {
+	m_telemetry = new JobTelemetry(m_config.m_maxTraceEvents);
+	m_parallelForJobPool = new JobPool<ParallelForJob>();
+	m_freeParallelForStates.reserve(64);
 }
 
 
 JobSystem::~JobSystem()
 {
+	delete m_parallelForJobPool;
+	m_parallelForJobPool = nullptr;
+	for (int stateIndex = 0; stateIndex < (int)m_freeParallelForStates.size(); stateIndex++)
+	{
+		delete m_freeParallelForStates[stateIndex];
+	}
+	m_freeParallelForStates.clear();
 
+	delete m_telemetry;
+	m_telemetry = nullptr;
 }
 
 
 void JobSystem::Startup()
 {
-	m_workerThreads.reserve(m_config.m_numberWorkerThreads);
-	for (int workerIndex = 0; workerIndex < m_config.m_numberWorkerThreads; workerIndex++)
+	std::vector<JobWorkerPoolConfig> poolConfigs = m_config.m_workerPools;
+	if (poolConfigs.empty())
+	{
+		JobWorkerPoolConfig defaultPoolConfig;
+		defaultPoolConfig.m_numberWorkerThreads = m_config.m_numberWorkerThreads;
+		poolConfigs.push_back(defaultPoolConfig);
+	}
+
+	m_unroutedJobs.reserve(256);
+	m_waitingJobs.reserve(256);
+
+	int numCores = (int)std::thread::hardware_concurrency();
+	for (int poolIndex = 0; poolIndex < (int)poolConfigs.size(); poolIndex++)
+	{
+		JobWorkerPoolConfig const& poolConfig = poolConfigs[poolIndex];
+		JobWorkerPool* newPool = new JobWorkerPool(poolConfig, poolIndex);
+		newPool->m_prioritizedJobs.reserve(256);
+		m_workerPools.push_back(newPool);
+
+		for (int poolWorkerIndex = 0; poolWorkerIndex < poolConfig.m_numberWorkerThreads; poolWorkerIndex++)
+		{
+			int coreIndex = -1;
+			if (poolConfig.m_firstCoreIndex >= 0 && numCores > 0)
+			{
+				coreIndex = (poolConfig.m_firstCoreIndex + poolWorkerIndex) % numCores;
+			}
+
+			JobWorkerThread* newWorkerThread = new JobWorkerThread(this, newPool, (int)m_workerThreads.size(), coreIndex);
+			newPool->m_workerThreads.push_back(newWorkerThread);
+			m_workerThreads.push_back(newWorkerThread);
+		}
+	}
+
+	// each job type value goes to exactly one pool, so no worker ever receives a job it cannot run
+	m_poolIndexForJobType[0] = -1;
+	for (int jobType = 1; jobType < 256; jobType++)
+	{
+		m_poolIndexForJobType[jobType] = -1;
+		for (int poolIndex = 0; poolIndex < (int)m_workerPools.size(); poolIndex++)
+		{
+			JobWorkerPool const* pool = m_workerPools[poolIndex];
+			if ((pool->GetJobTypes() & jobType) != 0 && pool->GetNumberWorkerThreads() > 0)
+			{
+				m_poolIndexForJobType[jobType] = poolIndex;
+				break;
+			}
+		}
+	}
+
+	for (int workerIndex = 0; workerIndex < (int)m_workerThreads.size(); workerIndex++)
+	{
+		m_workerThreads[workerIndex]->Start();
+	}
+
+	m_statsStartTime = GetCurrentTimeSeconds();
+
+	if (g_theEventSystem)
 	{
-		JobWorkerThread* newWorkerThread = new JobWorkerThread(this, workerIndex);
-		m_workerThreads.push_back(newWorkerThread);
+		SubscribeEventCallbackFunction("benchmarkParallelFor", Command_BenchmarkParallelFor);
+		SubscribeEventCallbackFunction("jobStats", Command_JobStats);
+		SubscribeEventCallbackFunction("jobTrace", Command_JobTrace);
 	}
 }
 
 
 void JobSystem::BeginFrame()
 {
-	
+	m_numberJobPathAllocations += GetMemoryTagStats(MEMORY_TAG_JOBS).m_frameAllocations;
+
+	// swapped with a member rather than a local, so neither vector gives up its capacity
+	m_mainThreadCallbacksMutex.lock();
+	m_mainThreadCallbacksToRun.swap(m_mainThreadCallbacks);
+	m_mainThreadCallbacksMutex.unlock();
+
+	for (int callbackIndex = 0; callbackIndex < (int)m_mainThreadCallbacksToRun.size(); callbackIndex++)
+	{
+		m_mainThreadCallbacksToRun[callbackIndex]();
+	}
+	m_mainThreadCallbacksToRun.clear();
 }
 
 
@@ -117,125 +577,1183 @@ void JobSystem::EndFrame()
 
 void JobSystem::ShutDown()
 {
-	for (int workerIndex = 0; workerIndex < m_config.m_numberWorkerThreads; workerIndex++)
+	for (int workerIndex = 0; workerIndex < (int)m_workerThreads.size(); workerIndex++)
 	{
 		JobWorkerThread* workerThread = m_workerThreads[workerIndex];
 		workerThread->Quit();
 	}
 
+	for (int workerIndex = 0; workerIndex < (int)m_workerThreads.size(); workerIndex++)
+	{
+		JobWorkerThread* workerThread = m_workerThreads[workerIndex];
+		if (workerThread->m_thread && workerThread->m_thread->joinable())
+		{
+			workerThread->m_thread->join();
+		}
+	}
+
 	ClearAllJobs();
+
+	m_mainThreadCallbacksMutex.lock();
+	m_mainThreadCallbacks.clear();
+	m_mainThreadCallbacksMutex.unlock();
+
+	for (int workerIndex = 0; workerIndex < (int)m_workerThreads.size(); workerIndex++)
+	{
+		delete m_workerThreads[workerIndex];
+	}
+	m_workerThreads.clear();
+
+	for (int poolIndex = 0; poolIndex < (int)m_workerPools.size(); poolIndex++)
+	{
+		delete m_workerPools[poolIndex];
+	}
+	m_workerPools.clear();
 }
 
 
-void JobSystem::SetJobTypeForWorker(int workerThreadID, uint8_t jobType)
+void JobSystem::QueueJob(Job* jobToExecute, JobCounter* completionCounter)
 {
-	m_workerThreads[workerThreadID]->SetAllowedJobTypes(jobType);
+	jobToExecute->m_isPrioritized = false;
+	EnqueueJob(jobToExecute, completionCounter);
 }
 
 
-void JobSystem::QueueJob(Job* jobToExecute)
+void JobSystem::QueuePrioritizedJob(Job* jobToExecute, float priority, JobCounter* completionCounter)
 {
-	m_queuedJobsMutex.lock();
-	jobToExecute->SetJobState(JobState::QUEUEING);
-	m_queuedJobs.push_back(jobToExecute);
-	m_queuedJobsMutex.unlock();
+	jobToExecute->m_isPrioritized = true;
+	jobToExecute->m_priority = priority;
+	EnqueueJob(jobToExecute, completionCounter);
 }
 
 
-Job* JobSystem::SendJobToExecute()
+void JobSystem::SetJobPriority(Job* job, float priority)
 {
-	m_queuedJobsMutex.lock();
-	Job* newJob = nullptr;
-	if (!m_queuedJobs.empty())
-	{
-		newJob = m_queuedJobs.front();
-		newJob->SetJobState(JobState::EXECUTING);
-		m_queuedJobs.pop_front();
-	}
-	m_queuedJobsMutex.unlock();
+	job->m_priority = priority;
+}
 
-	if (!newJob)
+
+bool JobSystem::CancelJob(Job* job)
+{
+	JobState state = job->GetJobState();
+	if (state == JobState::COMPLETED || state == JobState::RETRIVED)
 	{
-		return newJob;
+		return false;
 	}
 
-	m_numberWorkingThread++;
-
-	m_executingJobsMutex.lock();
-	for (int index = 0; index < (int)m_executingJobs.size(); index++)
+	job->Cancel();
+	if (job->m_isPrioritized && RemovePrioritizedJob(job))
 	{
-		Job*& currentJob = m_executingJobs[index];
-		if (!currentJob)
-		{
-			currentJob = newJob;
-			newJob->SetJobIndex(index);
-			m_executingJobsMutex.unlock();
-			return currentJob;
-		}
+		m_numberCancelledJobs++;
+		CompleteJob(job);
+		return true;
 	}
-	
-	m_executingJobs.push_back(newJob);
-	newJob->SetJobIndex((int)m_executingJobs.size() - 1);
-	m_executingJobsMutex.unlock();
-	return newJob;
+	return false;
 }
 
 
-void JobSystem::MoveJobToCompletedList(Job* completedJob)
+void JobSystem::EnqueueJob(Job* jobToExecute, JobCounter* completionCounter)
 {
-	m_executingJobsMutex.lock();
-	int jobIndex = completedJob->GetJobIndex();
-	m_executingJobs[jobIndex] = nullptr;
-	completedJob->SetJobState(JobState::COMPLETED);
-	m_executingJobsMutex.unlock();
-
-	m_numberWorkingThread--;
-
-	m_completedJobsMutex.lock();
-	m_completedJobs.push_back(completedJob);
-	m_completedJobsMutex.unlock();
-}
+	MEMORY_TAG_SCOPE(MEMORY_TAG_JOBS);
+	if (jobToExecute->GetJobState() == JobState::RETRIVED)
+	{
+		jobToExecute->m_isCancelled = false;
+	}
 
+	jobToExecute->m_completionCounter = completionCounter;
+	if (completionCounter)
+	{
+		completionCounter->m_numberUnfinishedJobs++;
+	}
+	m_numberPendingJobs++;
+	AddPendingJob(jobToExecute->GetJobType());
 
-Job* JobSystem::RetrieveCompletedJob()
-{
-	m_completedJobsMutex.lock();
-	Job* completedJob = nullptr;
-	if (!m_completedJobs.empty())
+	jobToExecute->SetJobState(JobState::WAITING);
+	// listed before the count can reach zero, so ClearAllJobs finds it even when a dependency is never queued
+	if (jobToExecute->m_numberUnfinishedDependencies > 1)
 	{
-		completedJob = m_completedJobs.front();
-		completedJob->SetJobState(JobState::RETRIVED);
-		m_completedJobs.pop_front();
+		AddWaitingJob(jobToExecute);
+	}
+	if (--jobToExecute->m_numberUnfinishedDependencies == 0)
+	{
+		RemoveWaitingJob(jobToExecute);
+		jobToExecute->SetJobState(JobState::QUEUEING);
+		RouteJob(jobToExecute);
 	}
-	m_completedJobsMutex.unlock();
-	return completedJob;
 }
 
 
-void JobSystem::ClearAllJobs()
+Job* JobSystem::SendJobToExecute(int workerThreadID)
 {
-	m_queuedJobsMutex.lock();
-	while (!m_queuedJobs.empty())
-	{
-		Job* job = m_queuedJobs.front();
-		m_queuedJobs.pop_front();
-		delete job;
-	}
-	m_queuedJobsMutex.unlock();
+	MEMORY_TAG_SCOPE(MEMORY_TAG_JOBS);
+	JobWorkerThread* worker = m_workerThreads[workerThreadID];
 
-	while (m_numberWorkingThread != 0)
+	// cancelled jobs are completed without running, keep looking so the worker does not park with work left
+	Job* newJob = TakeNextJob(worker);
+	while (newJob && newJob->IsCancelled())
 	{
-		std::this_thread::sleep_for(std::chrono::microseconds(1));
+		m_numberCancelledJobs++;
+		CompleteJob(newJob);
+		newJob = TakeNextJob(worker);
 	}
-
-	m_completedJobsMutex.lock();
-	while (!m_completedJobs.empty())
+	if (!newJob)
 	{
-		Job* job = m_completedJobs.front();
-		m_completedJobs.pop_front();
-		delete job;
+		return nullptr;
 	}
-	m_completedJobsMutex.unlock();
+
+	newJob->SetJobState(JobState::EXECUTING);
+	m_numberWorkingThread++;
+	return newJob;
 }
 
 
+Job* JobSystem::TakeNextJob(JobWorkerThread* worker)
+{
+	Job* newJob = worker->m_localJobs.Pop();
+	if (!newJob && worker->MoveSubmittedJobsTo(worker->m_localJobs))
+	{
+		newJob = worker->m_localJobs.Pop();
+		if (!worker->m_localJobs.IsEmpty())
+		{
+			WakeParkedWorker(worker->m_pool);
+		}
+	}
+	if (!newJob)
+	{
+		newJob = StealJob(worker);
+	}
+	if (!newJob)
+	{
+		newJob = TakePrioritizedJob(worker->m_pool);
+	}
+	return newJob;
+}
+
+
+void JobSystem::ExecuteJob(Job* job, int workerThreadID)
+{
+	if (!m_config.m_isTelemetryEnabled)
+	{
+		job->Execute();
+		MoveJobToCompletedList(job);
+		return;
+	}
+
+	uint8_t jobType = job->GetJobType();
+	double queuedTime = job->m_queuedTime;
+	double startTime = GetCurrentTimeSeconds();
+	job->Execute();
+	double endTime = GetCurrentTimeSeconds();
+
+	m_telemetry->RecordJob(jobType, workerThreadID, queuedTime, startTime, endTime);
+	if (workerThreadID >= 0)
+	{
+		m_workerThreads[workerThreadID]->m_busyMicroseconds += static_cast<int64_t>((endTime - startTime) * 1000000.0);
+	}
+	MoveJobToCompletedList(job);
+}
+
+
+void JobSystem::MoveJobToCompletedList(Job* completedJob)
+{
+	m_numberWorkingThread--;
+	CompleteJob(completedJob);
+}
+
+
+void JobSystem::CompleteJob(Job* completedJob)
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_JOBS);
+	completedJob->SetJobState(JobState::COMPLETED);
+
+	ReleaseDependentJobs(completedJob);
+
+	// the job may be retrieved and deleted as soon as it is in the completed list
+	JobCounter* completionCounter = completedJob->m_completionCounter;
+	uint8_t jobType = completedJob->GetJobType();
+
+	if (completedJob->m_deleteOnCompletion)
+	{
+		DestroyJob(completedJob);
+	}
+	else
+	{
+		completedJob->m_nextCompletedJob = nullptr;
+		m_completedJobsMutex.lock();
+		if (m_lastCompletedJob)
+		{
+			m_lastCompletedJob->m_nextCompletedJob = completedJob;
+		}
+		else
+		{
+			m_firstCompletedJob = completedJob;
+		}
+		m_lastCompletedJob = completedJob;
+		m_completedJobsMutex.unlock();
+	}
+
+	DecrementCompletionCounter(completionCounter);
+	RemovePendingJob(jobType);
+
+	if (--m_numberPendingJobs == 0)
+	{
+		m_jobsDoneMutex.lock();
+		m_jobsDoneMutex.unlock();
+		m_jobsDoneCondition.notify_all();
+	}
+}
+
+
+Job* JobSystem::RetrieveCompletedJob()
+{
+	m_completedJobsMutex.lock();
+	Job* completedJob = m_firstCompletedJob;
+	if (completedJob)
+	{
+		completedJob->SetJobState(JobState::RETRIVED);
+		m_firstCompletedJob = completedJob->m_nextCompletedJob;
+		if (!m_firstCompletedJob)
+		{
+			m_lastCompletedJob = nullptr;
+		}
+		completedJob->m_nextCompletedJob = nullptr;
+
+		completedJob->m_numberUnfinishedDependencies = 1;
+		completedJob->m_isFinished = false;
+		completedJob->m_completionCounter = nullptr;
+	}
+	m_completedJobsMutex.unlock();
+	return completedJob;
+}
+
+
+void JobSystem::ClearAllJobs()
+{
+	// jobs waiting on dependencies are cancelled rather than waited for, one that is never queued would hold them forever
+	m_numberPendingJobs -= DeleteAllQueuedJobs();
+	m_numberPendingJobs -= CancelWaitingJobs();
+	while (m_numberPendingJobs != 0)
+	{
+		std::unique_lock<std::mutex> lock(m_jobsDoneMutex);
+		m_jobsDoneCondition.wait_for(lock, std::chrono::milliseconds(1), [this]() { return m_numberPendingJobs == 0; });
+		lock.unlock();
+		m_numberPendingJobs -= DeleteAllQueuedJobs();
+		m_numberPendingJobs -= CancelWaitingJobs();
+	}
+
+	m_completedJobsMutex.lock();
+	Job* completedJob = m_firstCompletedJob;
+	m_firstCompletedJob = nullptr;
+	m_lastCompletedJob = nullptr;
+	m_completedJobsMutex.unlock();
+	while (completedJob)
+	{
+		Job* nextCompletedJob = completedJob->m_nextCompletedJob;
+		DestroyJob(completedJob);
+		completedJob = nextCompletedJob;
+	}
+}
+
+
+void JobSystem::DestroyJob(Job* job)
+{
+	if (job->m_pool)
+	{
+		job->m_pool->ReleaseJob(job);
+		return;
+	}
+	delete job;
+}
+
+
+void JobSystem::WaitForCounter(JobCounter const& counter)
+{
+	std::unique_lock<std::mutex> lock(m_jobsDoneMutex);
+	m_jobsDoneCondition.wait(lock, [&counter]() { return counter.IsDone(); });
+}
+
+
+void JobSystem::WaitFor(JobCounter const& counter, uint8_t helpJobMask)
+{
+	while (!counter.IsDone())
+	{
+		if (HelpExecuteJob(helpJobMask))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_jobsDoneMutex);
+		m_jobsDoneCondition.wait_for(lock, std::chrono::milliseconds(1), [&counter]() { return counter.IsDone(); });
+	}
+}
+
+
+void JobSystem::WaitForAll(uint8_t jobMask, uint8_t helpJobMask)
+{
+	while (GetNumberPendingJobs(jobMask) > 0)
+	{
+		if (HelpExecuteJob(helpJobMask))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_jobsDoneMutex);
+		m_jobsDoneCondition.wait_for(lock, std::chrono::milliseconds(1), [this, jobMask]() { return GetNumberPendingJobs(jobMask) == 0; });
+	}
+}
+
+
+bool JobSystem::HelpExecuteJob(uint8_t helpJobMask)
+{
+	Job* job = nullptr;
+	JobWorkerThread* worker = t_currentWorkerThread;
+	if (worker && worker->m_jobSystem == this)
+	{
+		job = SendJobToExecute(worker->m_workerThreadID);
+	}
+	else
+	{
+		job = TakeJobForHelper(helpJobMask);
+		while (job && job->IsCancelled())
+		{
+			m_numberCancelledJobs++;
+			CompleteJob(job);
+			job = TakeJobForHelper(helpJobMask);
+		}
+		if (job)
+		{
+			job->SetJobState(JobState::EXECUTING);
+			m_numberWorkingThread++;
+		}
+	}
+
+	if (!job)
+	{
+		return false;
+	}
+
+	ExecuteJob(job, worker ? worker->m_workerThreadID : -1);
+	return true;
+}
+
+
+int JobSystem::GetNumberPendingJobs(uint8_t jobMask) const
+{
+	if (jobMask == JOB_TYPE_ANY)
+	{
+		return m_numberPendingJobs;
+	}
+
+	int numPending = 0;
+	for (int typeBit = 0; typeBit < 8; typeBit++)
+	{
+		if (jobMask & (1 << typeBit))
+		{
+			numPending += m_numberPendingJobsByType[typeBit];
+		}
+	}
+	return numPending;
+}
+
+
+void JobSystem::AddPendingJob(uint8_t jobType)
+{
+	for (int typeBit = 0; typeBit < 8; typeBit++)
+	{
+		if (jobType & (1 << typeBit))
+		{
+			m_numberPendingJobsByType[typeBit]++;
+		}
+	}
+}
+
+
+void JobSystem::RemovePendingJob(uint8_t jobType)
+{
+	for (int typeBit = 0; typeBit < 8; typeBit++)
+	{
+		if (jobType & (1 << typeBit))
+		{
+			m_numberPendingJobsByType[typeBit]--;
+		}
+	}
+}
+
+
+void JobSystem::RunOnMainThread(std::function<void()> const& callback)
+{
+	m_mainThreadCallbacksMutex.lock();
+	m_mainThreadCallbacks.push_back(callback);
+	m_mainThreadCallbacksMutex.unlock();
+}
+
+
+void JobSystem::RouteJob(Job* job)
+{
+	if (m_config.m_isTelemetryEnabled)
+	{
+		job->m_queuedTime = GetCurrentTimeSeconds();
+	}
+
+	JobWorkerPool* pool = GetWorkerPoolForJobType(job->GetJobType());
+	if (!pool)
+	{
+		m_unroutedJobsMutex.lock();
+		m_unroutedJobs.push_back(job);
+		m_unroutedJobsMutex.unlock();
+		return;
+	}
+
+	if (job->m_isPrioritized)
+	{
+		AddPrioritizedJob(job, pool);
+		return;
+	}
+
+	RouteJobToWorker(job, pool);
+}
+
+
+void JobSystem::RouteJobToWorker(Job* job, JobWorkerPool* pool)
+{
+	unsigned int workerIndex = pool->m_nextWorkerIndex++;
+	JobWorkerThread* worker = pool->m_workerThreads[workerIndex % pool->m_workerThreads.size()];
+	worker->SubmitJob(job);
+	WakeParkedWorker(pool, worker);
+}
+
+
+void JobSystem::AddPrioritizedJob(Job* job, JobWorkerPool* pool)
+{
+	pool->m_prioritizedJobsMutex.lock();
+	pool->m_prioritizedJobs.push_back(job);
+	pool->m_numberPrioritizedJobs++;
+	pool->m_prioritizedJobsMutex.unlock();
+	WakeParkedWorker(pool);
+}
+
+
+Job* JobSystem::TakePrioritizedJob(JobWorkerPool* pool)
+{
+	if (pool->m_numberPrioritizedJobs == 0)
+	{
+		return nullptr;
+	}
+
+	pool->m_prioritizedJobsMutex.lock();
+	int bestIndex = -1;
+	float bestPriority = 0.f;
+	for (int jobIndex = 0; jobIndex < (int)pool->m_prioritizedJobs.size(); jobIndex++)
+	{
+		Job* job = pool->m_prioritizedJobs[jobIndex];
+
+		float priority = job->IsCancelled() ? -FLT_MAX : job->GetPriority();
+		if (bestIndex < 0 || priority < bestPriority)
+		{
+			bestIndex = jobIndex;
+			bestPriority = priority;
+		}
+	}
+
+	Job* bestJob = nullptr;
+	if (bestIndex >= 0)
+	{
+		bestJob = pool->m_prioritizedJobs[bestIndex];
+		pool->m_prioritizedJobs[bestIndex] = pool->m_prioritizedJobs.back();
+		pool->m_prioritizedJobs.pop_back();
+		pool->m_numberPrioritizedJobs--;
+	}
+	pool->m_prioritizedJobsMutex.unlock();
+	return bestJob;
+}
+
+
+bool JobSystem::RemovePrioritizedJob(Job* job)
+{
+	JobWorkerPool* pool = GetWorkerPoolForJobType(job->GetJobType());
+	if (!pool)
+	{
+		return false;
+	}
+
+	bool wasRemoved = false;
+	pool->m_prioritizedJobsMutex.lock();
+	for (int jobIndex = 0; jobIndex < (int)pool->m_prioritizedJobs.size(); jobIndex++)
+	{
+		if (pool->m_prioritizedJobs[jobIndex] == job)
+		{
+			pool->m_prioritizedJobs[jobIndex] = pool->m_prioritizedJobs.back();
+			pool->m_prioritizedJobs.pop_back();
+			pool->m_numberPrioritizedJobs--;
+			wasRemoved = true;
+			break;
+		}
+	}
+	pool->m_prioritizedJobsMutex.unlock();
+	return wasRemoved;
+}
+
+
+Job* JobSystem::StealJob(JobWorkerThread* thief)
+{
+	JobWorkerPool* pool = thief->m_pool;
+	int numWorkers = (int)pool->m_workerThreads.size();
+	int thiefIndex = 0;
+	while (pool->m_workerThreads[thiefIndex] != thief)
+	{
+		thiefIndex++;
+	}
+
+	for (int offset = 1; offset < numWorkers; offset++)
+	{
+		JobWorkerThread* victim = pool->m_workerThreads[(thiefIndex + offset) % numWorkers];
+
+		Job* stolenJob = victim->m_localJobs.Steal();
+		if (stolenJob)
+		{
+			if (!victim->m_localJobs.IsEmpty())
+			{
+				WakeParkedWorker(pool);
+			}
+			return stolenJob;
+		}
+
+		if (victim->MoveSubmittedJobsTo(thief->m_localJobs))
+		{
+			stolenJob = thief->m_localJobs.Pop();
+			if (!thief->m_localJobs.IsEmpty())
+			{
+				WakeParkedWorker(pool);
+			}
+			return stolenJob;
+		}
+	}
+	return nullptr;
+}
+
+
+Job* JobSystem::TakeJobForHelper(uint8_t helpJobMask)
+{
+	for (int poolIndex = 0; poolIndex < (int)m_workerPools.size(); poolIndex++)
+	{
+		JobWorkerPool* pool = m_workerPools[poolIndex];
+		if ((pool->GetJobTypes() & ~helpJobMask) != 0)
+		{
+			continue;
+		}
+
+		for (int workerIndex = 0; workerIndex < (int)pool->m_workerThreads.size(); workerIndex++)
+		{
+			JobWorkerThread* victim = pool->m_workerThreads[workerIndex];
+
+			Job* job = victim->m_localJobs.Steal();
+			if (job)
+			{
+				return job;
+			}
+
+			// the helper has no deque of its own, take the oldest submission and hand the rest back
+			Job* head = victim->m_submittedJobs.exchange(nullptr, std::memory_order_seq_cst);
+			if (!head)
+			{
+				continue;
+			}
+
+			Job* oldestJob = head;
+			Job* restHead = nullptr;
+			while (oldestJob->m_nextSubmittedJob)
+			{
+				Job* next = oldestJob->m_nextSubmittedJob;
+				oldestJob->m_nextSubmittedJob = restHead;
+				restHead = oldestJob;
+				oldestJob = next;
+			}
+			while (restHead)
+			{
+				Job* next = restHead->m_nextSubmittedJob;
+				victim->SubmitJob(restHead);
+				restHead = next;
+			}
+			if (victim->m_submittedJobs.load() != nullptr)
+			{
+				WakeParkedWorker(pool, victim);
+			}
+			return oldestJob;
+		}
+
+		Job* prioritizedJob = TakePrioritizedJob(pool);
+		if (prioritizedJob)
+		{
+			return prioritizedJob;
+		}
+	}
+
+	Job* unroutedJob = nullptr;
+	m_unroutedJobsMutex.lock();
+	for (int jobIndex = 0; jobIndex < (int)m_unroutedJobs.size(); jobIndex++)
+	{
+		if ((m_unroutedJobs[jobIndex]->m_jobType & helpJobMask) != 0)
+		{
+			unroutedJob = m_unroutedJobs[jobIndex];
+			m_unroutedJobs.erase(m_unroutedJobs.begin() + jobIndex);
+			break;
+		}
+	}
+	m_unroutedJobsMutex.unlock();
+	return unroutedJob;
+}
+
+
+int JobSystem::DeleteAllQueuedJobs()
+{
+	int numDeleted = 0;
+
+	m_unroutedJobsMutex.lock();
+	for (int jobIndex = 0; jobIndex < (int)m_unroutedJobs.size(); jobIndex++)
+	{
+		numDeleted += DiscardJob(m_unroutedJobs[jobIndex]);
+	}
+	m_unroutedJobs.clear();
+	m_unroutedJobsMutex.unlock();
+
+	for (int poolIndex = 0; poolIndex < (int)m_workerPools.size(); poolIndex++)
+	{
+		JobWorkerPool* pool = m_workerPools[poolIndex];
+		pool->m_prioritizedJobsMutex.lock();
+		// cleared in place, a swap would give away the reserved capacity
+		std::vector<Job*> prioritizedJobs(pool->m_prioritizedJobs);
+		pool->m_prioritizedJobs.clear();
+		pool->m_numberPrioritizedJobs = 0;
+		pool->m_prioritizedJobsMutex.unlock();
+		for (int jobIndex = 0; jobIndex < (int)prioritizedJobs.size(); jobIndex++)
+		{
+			numDeleted += DiscardJob(prioritizedJobs[jobIndex]);
+		}
+	}
+
+	for (int workerIndex = 0; workerIndex < (int)m_workerThreads.size(); workerIndex++)
+	{
+		JobWorkerThread* worker = m_workerThreads[workerIndex];
+
+		Job* submittedJob = worker->m_submittedJobs.exchange(nullptr, std::memory_order_acquire);
+		while (submittedJob)
+		{
+			Job* next = submittedJob->m_nextSubmittedJob;
+			numDeleted += DiscardJob(submittedJob);
+			submittedJob = next;
+		}
+
+		Job* queuedJob = worker->m_localJobs.Steal();
+		while (queuedJob)
+		{
+			numDeleted += DiscardJob(queuedJob);
+			queuedJob = worker->m_localJobs.Steal();
+		}
+	}
+
+	return numDeleted;
+}
+
+
+int JobSystem::DiscardJob(Job* job)
+{
+	job->MarkFinished();
+	DetachDependentJobs(job);
+
+	int numDiscarded = 1;
+	for (int jobIndex = 0; jobIndex < job->GetNumberDependentJobs(); jobIndex++)
+	{
+		Job* dependentJob = job->GetDependentJob(jobIndex);
+		if (--dependentJob->m_numberUnfinishedDependencies == 0)
+		{
+			RemoveWaitingJob(dependentJob);
+			numDiscarded += DiscardJob(dependentJob);
+		}
+	}
+	job->ClearDependentJobs();
+
+	DecrementCompletionCounter(job->m_completionCounter);
+	RemovePendingJob(job->GetJobType());
+	DestroyJob(job);
+	return numDiscarded;
+}
+
+
+int JobSystem::CancelWaitingJobs()
+{
+	std::vector<Job*> detachedJobs;
+	Job::s_dependencyMutex.lock();
+	for (int waitingIndex = 0; waitingIndex < (int)m_waitingJobs.size(); waitingIndex++)
+	{
+		Job* waitingJob = m_waitingJobs[waitingIndex];
+		waitingJob->Cancel();
+
+		// unfinished dependencies let go of the job, finished ones are releasing it already and it completes without running
+		int numDetached = 0;
+		std::vector<Job*>& dependencyJobs = waitingJob->m_dependencyJobs;
+		for (int dependencyIndex = 0; dependencyIndex < (int)dependencyJobs.size(); dependencyIndex++)
+		{
+			if (dependencyJobs[dependencyIndex]->RemoveDependentJob(waitingJob))
+			{
+				dependencyJobs[dependencyIndex] = dependencyJobs.back();
+				dependencyJobs.pop_back();
+				dependencyIndex--;
+				numDetached++;
+			}
+		}
+		if (numDetached > 0 && (waitingJob->m_numberUnfinishedDependencies -= numDetached) == 0)
+		{
+			detachedJobs.push_back(waitingJob);
+		}
+	}
+	Job::s_dependencyMutex.unlock();
+
+	int numDiscarded = 0;
+	for (int jobIndex = 0; jobIndex < (int)detachedJobs.size(); jobIndex++)
+	{
+		RemoveWaitingJob(detachedJobs[jobIndex]);
+		numDiscarded += DiscardJob(detachedJobs[jobIndex]);
+	}
+	return numDiscarded;
+}
+
+
+void JobSystem::AddWaitingJob(Job* job)
+{
+	Job::s_dependencyMutex.lock();
+	job->m_isWaitingForDependencies = true;
+	job->m_waitingJobIndex = (int)m_waitingJobs.size();
+	m_waitingJobs.push_back(job);
+	Job::s_dependencyMutex.unlock();
+}
+
+
+void JobSystem::RemoveWaitingJob(Job* job)
+{
+	// only the thread that brought the dependency count to zero gets here, so the flag needs no lock
+	if (!job->m_isWaitingForDependencies)
+	{
+		return;
+	}
+
+	Job::s_dependencyMutex.lock();
+	Job* lastJob = m_waitingJobs.back();
+	m_waitingJobs[job->m_waitingJobIndex] = lastJob;
+	lastJob->m_waitingJobIndex = job->m_waitingJobIndex;
+	m_waitingJobs.pop_back();
+	job->m_waitingJobIndex = -1;
+	job->m_isWaitingForDependencies = false;
+	Job::s_dependencyMutex.unlock();
+}
+
+
+void JobSystem::DetachDependentJobs(Job* finishedJob)
+{
+	if (finishedJob->GetNumberDependentJobs() == 0)
+	{
+		return;
+	}
+
+	// the dependents stop listing this job before it can be destroyed, CancelWaitingJobs only touches listed ones
+	Job::s_dependencyMutex.lock();
+	for (int jobIndex = 0; jobIndex < finishedJob->GetNumberDependentJobs(); jobIndex++)
+	{
+		finishedJob->GetDependentJob(jobIndex)->RemoveDependency(finishedJob);
+	}
+	Job::s_dependencyMutex.unlock();
+}
+
+
+void JobSystem::ReleaseDependentJobs(Job* finishedJob)
+{
+	finishedJob->MarkFinished();
+	DetachDependentJobs(finishedJob);
+
+	for (int jobIndex = 0; jobIndex < finishedJob->GetNumberDependentJobs(); jobIndex++)
+	{
+		Job* dependentJob = finishedJob->GetDependentJob(jobIndex);
+		if (finishedJob->IsCancelled())
+		{
+			dependentJob->Cancel();
+		}
+		if (--dependentJob->m_numberUnfinishedDependencies == 0)
+		{
+			RemoveWaitingJob(dependentJob);
+			dependentJob->SetJobState(JobState::QUEUEING);
+			RouteJob(dependentJob);
+		}
+	}
+	finishedJob->ClearDependentJobs();
+}
+
+
+void JobSystem::DecrementCompletionCounter(JobCounter* counter)
+{
+	if (counter && --counter->m_numberUnfinishedJobs == 0)
+	{
+		m_jobsDoneMutex.lock();
+		m_jobsDoneMutex.unlock();
+		m_jobsDoneCondition.notify_all();
+	}
+}
+
+
+int JobSystem::GetWorkerSpinMicroseconds() const
+{
+	return m_config.m_workerSpinMicroseconds;
+}
+
+
+JobSystemStats JobSystem::GetStats() const
+{
+	JobSystemStats stats;
+	int64_t spinMicroseconds = 0;
+	for (int workerIndex = 0; workerIndex < (int)m_workerThreads.size(); workerIndex++)
+	{
+		JobWorkerThread const* worker = m_workerThreads[workerIndex];
+		stats.m_numberParks += worker->m_numberParks;
+		stats.m_numberWakeups += worker->m_numberWakeups;
+		spinMicroseconds += worker->m_spinMicroseconds;
+	}
+	stats.m_spinSeconds = static_cast<double>(spinMicroseconds) * 0.000001;
+	stats.m_numberCancelledJobs = m_numberCancelledJobs;
+	stats.m_numberJobPathAllocations = m_numberJobPathAllocations;
+	stats.m_numberJobPoolHeapAllocations = JobPoolBase::GetTotalHeapAllocations();
+	return stats;
+}
+
+
+void JobSystem::ResetStats()
+{
+	for (int workerIndex = 0; workerIndex < (int)m_workerThreads.size(); workerIndex++)
+	{
+		JobWorkerThread* worker = m_workerThreads[workerIndex];
+		worker->m_numberParks = 0;
+		worker->m_numberWakeups = 0;
+		worker->m_spinMicroseconds = 0;
+		worker->m_busyMicroseconds = 0;
+	}
+	m_numberCancelledJobs = 0;
+	m_numberJobPathAllocations = 0;
+	m_telemetry->Reset();
+	m_statsStartTime = GetCurrentTimeSeconds();
+}
+
+
+JobTelemetry& JobSystem::GetTelemetry()
+{
+	return *m_telemetry;
+}
+
+
+float JobSystem::GetWorkerBusyFraction(int workerThreadID) const
+{
+	double elapsedSeconds = GetCurrentTimeSeconds() - m_statsStartTime;
+	if (elapsedSeconds <= 0.0)
+	{
+		return 0.f;
+	}
+	double busySeconds = static_cast<double>(m_workerThreads[workerThreadID]->m_busyMicroseconds) * 0.000001;
+	return static_cast<float>(busySeconds / elapsedSeconds);
+}
+
+
+std::string JobSystem::GetWorkerThreadName(int workerThreadID) const
+{
+	JobWorkerThread const* worker = m_workerThreads[workerThreadID];
+	JobWorkerPool const* pool = worker->m_pool;
+	int poolWorkerIndex = 0;
+	while (pool->m_workerThreads[poolWorkerIndex] != worker)
+	{
+		poolWorkerIndex++;
+	}
+	return Stringf("%s %d", pool->GetName().c_str(), poolWorkerIndex);
+}
+
+
+bool JobSystem::ExportChromeTrace(std::string const& filename) const
+{
+	std::vector<std::string> threadNames;
+	for (int workerIndex = 0; workerIndex < (int)m_workerThreads.size(); workerIndex++)
+	{
+		threadNames.push_back(GetWorkerThreadName(workerIndex));
+	}
+	return m_telemetry->ExportChromeTrace(filename, threadNames);
+}
+
+
+void JobSystem::WakeParkedWorker(JobWorkerPool* pool, JobWorkerThread* preferredWorker)
+{
+	// pairs with the parked flag store in JobWorkerMain so either the job or the sleeper is seen
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (preferredWorker && preferredWorker->m_isParked)
+	{
+		preferredWorker->Wake();
+		return;
+	}
+	for (int workerIndex = 0; workerIndex < (int)pool->m_workerThreads.size(); workerIndex++)
+	{
+		JobWorkerThread* worker = pool->m_workerThreads[workerIndex];
+		if (worker->m_isParked)
+		{
+			worker->Wake();
+			return;
+		}
+	}
+}
+
+
+void JobSystem::ParallelForBatches(int begin, int end, int grainSize, std::function<void(int, int)> const& batchFunction, int maxHelperWorkers)
+{
+	if (end <= begin)
+	{
+		return;
+	}
+
+	if (grainSize <= 0)
+	{
+		grainSize = GetAutoGrainSize(end - begin);
+	}
+
+	ParallelForState* state = AcquireParallelForState();
+	state->m_batchFunction = &batchFunction;
+	state->m_begin = begin;
+	state->m_end = end;
+	state->m_grainSize = grainSize;
+	state->m_numberBatches = (end - begin + grainSize - 1) / grainSize;
+
+	int numHelpers = state->m_numberBatches - 1;
+	int numWorkers = GetNumberWorkerThreads(JOB_TYPE_ANY);
+	if (numHelpers > numWorkers)
+	{
+		numHelpers = numWorkers;
+	}
+	if (maxHelperWorkers >= 0 && numHelpers > maxHelperWorkers)
+	{
+		numHelpers = maxHelperWorkers;
+	}
+
+	state->m_numberReferences = numHelpers + 1;
+	for (int helperIndex = 0; helperIndex < numHelpers; helperIndex++)
+	{
+		QueueJob(m_parallelForJobPool->Acquire(state));
+	}
+
+	// the calling thread takes batches too, then only batches other threads already claimed are left
+	state->RunBatches();
+	JobWorkerPool const* helperPool = GetWorkerPoolForJobType(JOB_TYPE_ANY);
+	uint8_t helpJobMask = helperPool ? helperPool->GetJobTypes() : JOB_TYPE_ANY;
+	while (state->m_numberBatchesDone < state->m_numberBatches)
+	{
+		if (!HelpExecuteJob(helpJobMask))
+		{
+			std::this_thread::yield();
+		}
+	}
+	ReleaseParallelForState(state);
+}
+
+
+ParallelForState* JobSystem::AcquireParallelForState()
+{
+	ParallelForState* state = nullptr;
+	m_parallelForStatesMutex.lock();
+	if (!m_freeParallelForStates.empty())
+	{
+		state = m_freeParallelForStates.back();
+		m_freeParallelForStates.pop_back();
+	}
+	m_parallelForStatesMutex.unlock();
+
+	if (!state)
+	{
+		state = new ParallelForState();
+	}
+	state->m_jobSystem = this;
+	state->m_nextBatch = 0;
+	state->m_numberBatchesDone = 0;
+	return state;
+}
+
+
+void JobSystem::ReleaseParallelForState(ParallelForState* state)
+{
+	if (--state->m_numberReferences != 0)
+	{
+		return;
+	}
+
+	m_parallelForStatesMutex.lock();
+	m_freeParallelForStates.push_back(state);
+	m_parallelForStatesMutex.unlock();
+}
+
+
+int JobSystem::GetAutoGrainSize(int count) const
+{
+	int numThreads = GetNumberWorkerThreads(JOB_TYPE_ANY) + 1;
+	int numBatches = numThreads * 4;
+	int grainSize = (count + numBatches - 1) / numBatches;
+	return grainSize > 0 ? grainSize : 1;
+}
+
+
+int JobSystem::GetNumberWorkerThreads() const
+{
+	return (int)m_workerThreads.size();
+}
+
+
+int JobSystem::GetNumberWorkerThreads(uint8_t jobType) const
+{
+	JobWorkerPool const* pool = GetWorkerPoolForJobType(jobType);
+	return pool ? pool->GetNumberWorkerThreads() : 0;
+}
+
+
+int JobSystem::GetNumberWorkerPools() const
+{
+	return (int)m_workerPools.size();
+}
+
+
+JobWorkerPool* JobSystem::GetWorkerPool(int poolIndex) const
+{
+	return m_workerPools[poolIndex];
+}
+
+
+JobWorkerPool* JobSystem::GetWorkerPool(std::string const& poolName) const
+{
+	for (int poolIndex = 0; poolIndex < (int)m_workerPools.size(); poolIndex++)
+	{
+		if (m_workerPools[poolIndex]->GetName() == poolName)
+		{
+			return m_workerPools[poolIndex];
+		}
+	}
+	return nullptr;
+}
+
+
+JobWorkerPool* JobSystem::GetWorkerPoolForJobType(uint8_t jobType) const
+{
+	int poolIndex = m_poolIndexForJobType[jobType];
+	if (poolIndex < 0 || poolIndex >= (int)m_workerPools.size())
+	{
+		return nullptr;
+	}
+	return m_workerPools[poolIndex];
+}
+
+
+bool JobSystem::Command_BenchmarkParallelFor(EventArgs& args)
+{
+	if (!g_theJobSystem) return false;
+
+	int numVertices = args.GetParsedValue("vertices", 1000000);
+	int numRepeats = args.GetParsedValue("repeats", 10);
+	int grainSize = args.GetParsedValue("grain", 0);
+	if (numVertices <= 0 || numRepeats <= 0) return false;
+
+	std::vector<Vertex_PCU> verts;
+	verts.resize(numVertices);
+	for (int vertIndex = 0; vertIndex < numVertices; vertIndex++)
+	{
+		verts[vertIndex].m_position = Vec3(static_cast<float>(vertIndex), 1.f, 2.f);
+	}
+
+	Vec3 iBasis(0.f, 1.f, 0.f);
+	Vec3 jBasis(-1.f, 0.f, 0.f);
+	Vec3 kBasis(0.f, 0.f, 1.f);
+	Vec3 translation(1.f, 2.f, 3.f);
+
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, Stringf("## ParallelFor vertex transform, %d verts x %d ##", numVertices, numRepeats));
+	double singleThreadSeconds = 0.0;
+	int numWorkers = g_theJobSystem->GetNumberWorkerThreads(JOB_TYPE_ANY);
+	for (int numHelpers = 0; numHelpers <= numWorkers; numHelpers++)
+	{
+		double startTime = GetCurrentTimeSeconds();
+		for (int repeat = 0; repeat < numRepeats; repeat++)
+		{
+			g_theJobSystem->ParallelForBatches(0, numVertices, grainSize, [&](int batchBegin, int batchEnd)
+			{
+				for (int vertIndex = batchBegin; vertIndex < batchEnd; vertIndex++)
+				{
+					TransformPositionXYZ3D(verts[vertIndex].m_position, iBasis, jBasis, kBasis, translation);
+				}
+			}, numHelpers);
+		}
+		double seconds = (GetCurrentTimeSeconds() - startTime) / static_cast<double>(numRepeats);
+		if (numHelpers == 0)
+		{
+			singleThreadSeconds = seconds;
+		}
+
+		std::string line = Stringf("threads=%2d  %.3fms  speedup=%.2fx", numHelpers + 1, seconds * 1000.0, singleThreadSeconds / seconds);
+		g_theDevConsole->AddLine(DevConsole::INFO_MINOR, line);
+	}
+
+	return false;
+}
+
+
+
+
+bool JobSystem::Command_JobStats(EventArgs& args)
+{
+	if (!g_theJobSystem) return false;
+	JobSystem* jobSystem = g_theJobSystem;
+	JobTelemetry& telemetry = jobSystem->GetTelemetry();
+
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, "## Job workers ##");
+	for (int workerIndex = 0; workerIndex < (int)jobSystem->m_workerThreads.size(); workerIndex++)
+	{
+		float busyFraction = jobSystem->GetWorkerBusyFraction(workerIndex);
+		std::string line = Stringf("%-16s busy=%5.1f%%  idle=%5.1f%%", jobSystem->GetWorkerThreadName(workerIndex).c_str(), busyFraction * 100.f, (1.f - busyFraction) * 100.f);
+		g_theDevConsole->AddLine(DevConsole::INFO_MINOR, line);
+	}
+
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, "## Job types (us) ##");
+	for (int jobType = 0; jobType < NUM_JOB_TYPE_VALUES; jobType++)
+	{
+		JobTimingHistogram const& executionTime = telemetry.GetExecutionTime(static_cast<uint8_t>(jobType));
+		if (executionTime.GetNumberSamples() == 0)
+		{
+			continue;
+		}
+		JobTimingHistogram const& queueLatency = telemetry.GetQueueLatency(static_cast<uint8_t>(jobType));
+		std::string line = Stringf("%-20s count=%d  exec avg=%.0f p50<%lld p95<%lld max=%lld  queue avg=%.0f p95<%lld",
+			telemetry.GetJobTypeName(static_cast<uint8_t>(jobType)).c_str(), executionTime.GetNumberSamples(),
+			executionTime.GetAverageMicroseconds(), (long long)executionTime.GetPercentileMicroseconds(0.5f), (long long)executionTime.GetPercentileMicroseconds(0.95f), (long long)executionTime.GetMaxMicroseconds(),
+			queueLatency.GetAverageMicroseconds(), (long long)queueLatency.GetPercentileMicroseconds(0.95f));
+		g_theDevConsole->AddLine(DevConsole::INFO_MINOR, line);
+	}
+
+	JobSystemStats stats = jobSystem->GetStats();
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, "## Job allocations ##");
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("queueing path=%d  pool slabs=%d", stats.m_numberJobPathAllocations, stats.m_numberJobPoolHeapAllocations));
+
+	if (args.GetParsedValue("reset", false))
+	{
+		jobSystem->ResetStats();
+	}
+	return false;
+}
+
+
+bool JobSystem::Command_JobTrace(EventArgs& args)
+{
+	if (!g_theJobSystem) return false;
+
+	std::string filename = args.GetValue("file", "JobTrace.json");
+	if (g_theJobSystem->ExportChromeTrace(filename))
+	{
+		g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("Wrote job trace to %s, open it in chrome://tracing", filename.c_str()));
+	}
+	else
+	{
+		g_theDevConsole->AddLine(DevConsole::INFO_ERROR, Stringf("Could not write job trace to %s", filename.c_str()));
+	}
+	return false;
+}
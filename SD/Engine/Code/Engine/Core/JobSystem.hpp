@@ -1,24 +1,60 @@
 #pragma once
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/WorkStealingQueue.hpp"
+#include "Engine/Core/JobTelemetry.hpp"
+
 #include <atomic>
+#include <condition_variable>
 #include <thread>
-#include <deque>
+#include <functional>
 #include <mutex>
+#include <string>
 #include <vector>
 
+class JobSystem;
+class JobPoolBase;
+class JobWorkerPool;
+class ParallelForJob;
+struct ParallelForState;
+template <typename T> class JobPool;
+
+extern JobSystem* g_theJobSystem;
+
+// matches any worker that accepts at least one job type
+constexpr uint8_t JOB_TYPE_ANY = 0b11111111;
+
 enum class JobState
 {
 	INVALID = - 1,
 
+	WAITING,
 	QUEUEING,
 	EXECUTING,
 	COMPLETED,
 	RETRIVED
 };
 
+class JobCounter
+{
+	friend class JobSystem;
+
+public:
+	JobCounter() {}
+	JobCounter(JobCounter const& copy) = delete;
+
+	bool IsDone() const;
+	int GetNumberUnfinishedJobs() const;
+
+private:
+	std::atomic<int> m_numberUnfinishedJobs = 0;
+};
+
 class Job
 {
 	friend class JobWorkerThread;
-	
+	friend class JobSystem;
+	friend class JobPoolBase;
+
 public:
 	Job(uint8_t jobType, int jobIndex = -1);
 	virtual ~Job() {}
@@ -32,43 +68,177 @@ public:
 	int GetJobIndex() const;
 	void SetJobState(JobState jobState);
 	JobState GetJobState() const;
+	uint8_t GetJobType() const;
+	bool IsPooled() const;
+
+	// this job is held back until the dependency finishes, must be called before this job is queued
+	void AddDependency(Job* dependency);
+	// the job system deletes the job once it is done instead of adding it to the completed list
+	void SetDeleteOnCompletion(bool deleteOnCompletion);
+
+	// cooperative, a job that has not started is skipped and a running one may poll IsCancelled
+	void Cancel();
+	bool IsCancelled() const;
+	bool IsPrioritized() const;
+	float GetPriority() const;
 
 private:
+	void MarkFinished();
+	int GetNumberDependentJobs() const;
+	Job* GetDependentJob(int index) const;
+	bool RemoveDependentJob(Job* dependentJob);
+	void RemoveDependency(Job* dependency);
+	void ClearDependentJobs();
+
+private:
+	static constexpr int NUM_INLINE_DEPENDENT_JOBS = 4;
+
 	uint8_t m_jobType = 0;
 	std::atomic<int> m_jobIndex = 0;
 	std::atomic<JobState> m_state = JobState::INVALID;
-};
+	Job* m_nextSubmittedJob = nullptr;
+	// links the completed list, so completing a job never allocates
+	Job* m_nextCompletedJob = nullptr;
 
-class JobSystem;
+	// starts at one for the QueueJob call itself, the job is routed when it reaches zero
+	std::atomic<int> m_numberUnfinishedDependencies = 1;
+	// a few dependents are stored inline so pooled jobs can be reused without touching the heap
+	Job* m_inlineDependentJobs[NUM_INLINE_DEPENDENT_JOBS] = {};
+	std::vector<Job*> m_extraDependentJobs;
+	int m_numberDependentJobs = 0;
+	std::mutex m_dependentJobsMutex;
+	bool m_isFinished = false;
+	// the jobs this one still waits on, a dependency takes itself off before it releases this job
+	std::vector<Job*> m_dependencyJobs;
+	// set while the job is queued behind unfinished dependencies and listed for ClearAllJobs
+	bool m_isWaitingForDependencies = false;
+	int m_waitingJobIndex = -1;
+	bool m_deleteOnCompletion = false;
+	JobCounter* m_completionCounter = nullptr;
+	JobPoolBase* m_pool = nullptr;
+
+	std::atomic<bool> m_isCancelled = false;
+	bool m_isPrioritized = false;
+	// lower runs first, can change while the job is queued
+	std::atomic<float> m_priority = 0.f;
+	// when the job last became ready to run, only tracked with telemetry enabled
+	double m_queuedTime = 0.0;
+
+	// guards m_dependencyJobs and the waiting job list, only taken by jobs that have dependencies
+	static std::mutex s_dependencyMutex;
+};
 
 class JobWorkerThread
 {
 public:
-	JobWorkerThread(JobSystem* jobSystem, int workerThreadID);
+	JobWorkerThread(JobSystem* jobSystem, JobWorkerPool* pool, int workerThreadID, int coreIndex);
 	~JobWorkerThread();
 
+	void Start();
 	void JobWorkerMain();
-	void SetAllowedJobTypes(uint8_t jobMask);
-	void AddAllowedJobTypes(uint8_t jobMask);
+	bool CanExecuteJob(Job const* job) const;
 	void Quit();
 
+	void SubmitJob(Job* job);
+	bool MoveSubmittedJobsTo(WorkStealingQueue& queue);
+
+	Job* SpinForJob();
+	void WaitForWake();
+	void Wake();
+
 public:
 	JobSystem* m_jobSystem = nullptr;
 	std::atomic<bool> m_isQuitting = false;
+	JobWorkerPool* m_pool = nullptr;
 	int m_workerThreadID = -1;
+	// copied from the pool, workers only ever receive jobs of these types
+	uint8_t m_jobMask = 0b00000000;
+	// -1 lets the OS schedule the thread on any core
+	int m_coreIndex = -1;
+
+	// owned by this worker, stolen from by the others
+	WorkStealingQueue m_localJobs;
+	// lock-free stack the submitting threads push onto, drained into m_localJobs
+	std::atomic<Job*> m_submittedJobs = nullptr;
+
+	std::atomic<bool> m_isParked = false;
+	bool m_wakeRequested = false;
+	std::mutex m_parkMutex;
+	std::condition_variable m_parkCondition;
+
+	std::atomic<int> m_numberParks = 0;
+	std::atomic<int> m_numberWakeups = 0;
+	std::atomic<int64_t> m_spinMicroseconds = 0;
+	std::atomic<int64_t> m_busyMicroseconds = 0;
+
 	std::thread* m_thread = nullptr;
-	std::atomic<uint8_t> m_jobMask = 0b00000000;
+};
+
+
+struct JobWorkerPoolConfig
+{
+	std::string m_name = "default";
+	int m_numberWorkerThreads = 1;
+	// a job goes to the first pool that shares a type bit with it
+	uint8_t m_jobTypes = JOB_TYPE_ANY;
+	// pins worker N of the pool to core m_firstCoreIndex + N, -1 leaves the threads unpinned
+	int m_firstCoreIndex = -1;
+};
+
+
+// workers only steal from their own pool, so a busy pool cannot take over the threads of another
+class JobWorkerPool
+{
+public:
+	JobWorkerPool(JobWorkerPoolConfig const& config, int poolIndex);
+
+	std::string const& GetName() const;
+	uint8_t GetJobTypes() const;
+	int GetNumberWorkerThreads() const;
+
+public:
+	JobWorkerPoolConfig m_config;
+	int m_poolIndex = -1;
+	std::vector<JobWorkerThread*> m_workerThreads;
+	std::atomic<unsigned int> m_nextWorkerIndex = 0;
+
+	// scanned linearly, streaming workloads keep it short and priorities change while jobs wait
+	std::vector<Job*> m_prioritizedJobs;
+	std::mutex m_prioritizedJobsMutex;
+	std::atomic<int> m_numberPrioritizedJobs = 0;
 };
 
 
 struct JobSystemConfig
 {
+	// used for a single pool that accepts every job type when m_workerPools is empty
 	int m_numberWorkerThreads = 0;
+	std::vector<JobWorkerPoolConfig> m_workerPools;
+	// how long an idle worker keeps polling for jobs before it parks, 0 parks right away
+	int m_workerSpinMicroseconds = 50;
+	// times every job and keeps the newest m_maxTraceEvents for jobStats and jobTrace
+	bool m_isTelemetryEnabled = true;
+	int m_maxTraceEvents = 16384;
+};
+
+
+struct JobSystemStats
+{
+	int m_numberParks = 0;
+	int m_numberWakeups = 0;
+	double m_spinSeconds = 0.0;
+	int m_numberCancelledJobs = 0;
+	// heap allocations the queueing and completion path made, only grows while the queues grow so it stays flat once warmed up
+	int m_numberJobPathAllocations = 0;
+	// slabs allocated by every JobPool since startup
+	int m_numberJobPoolHeapAllocations = 0;
 };
 
 
 class JobSystem
 {
+	friend class ParallelForJob;
+
 public:
 	JobSystem(JobSystemConfig const& config);
 	~JobSystem();
@@ -77,28 +247,167 @@ public:
 	void EndFrame();
 	void ShutDown();
 
-	void SetJobTypeForWorker(int workerThreadID, uint8_t jobType);
-	void QueueJob(Job* jobToExecute);
-	Job* SendJobToExecute();
+	void QueueJob(Job* jobToExecute, JobCounter* completionCounter = nullptr);
+	// prioritized jobs wait in a list per pool and the lowest priority value runs first
+	void QueuePrioritizedJob(Job* jobToExecute, float priority, JobCounter* completionCounter = nullptr);
+	void SetJobPriority(Job* job, float priority);
+	// returns true when the job was pulled out of the queue before running, otherwise it is only flagged
+	bool CancelJob(Job* job);
+	Job* SendJobToExecute(int workerThreadID);
+	// runs a claimed job and completes it, workerThreadID is -1 for a thread helping in WaitFor
+	void ExecuteJob(Job* job, int workerThreadID);
 	void MoveJobToCompletedList(Job* completedJob);
 	Job* RetrieveCompletedJob();
 	void ClearAllJobs();
+	void WaitForCounter(JobCounter const& counter);
+	// like WaitForCounter, but the calling thread runs queued jobs of the help types while it waits
+	void WaitFor(JobCounter const& counter, uint8_t helpJobMask = JOB_TYPE_ANY);
+	// returns once no job sharing a type bit with jobMask is queued or running
+	void WaitForAll(uint8_t jobMask = JOB_TYPE_ANY, uint8_t helpJobMask = JOB_TYPE_ANY);
+	// runs one queued job on the calling thread, false when there was nothing it was allowed to take
+	bool HelpExecuteJob(uint8_t helpJobMask = JOB_TYPE_ANY);
+	int GetNumberPendingJobs(uint8_t jobMask = JOB_TYPE_ANY) const;
+
+	// callable from any thread, the callback runs on the main thread in the next BeginFrame
+	void RunOnMainThread(std::function<void()> const& callback);
+	// returns a retrieved job to its pool, or deletes it when it was not pool allocated
+	void DestroyJob(Job* job);
+
+	// splits [begin, end) into batches of grainSize (0 picks one), workers and the calling thread run them
+	template <typename IndexFunction>
+	inline void ParallelFor(int begin, int end, int grainSize, IndexFunction const& indexFunction)
+	{
+		ParallelForBatches(begin, end, grainSize, [&indexFunction](int batchBegin, int batchEnd)
+		{
+			for (int index = batchBegin; index < batchEnd; index++)
+			{
+				indexFunction(index);
+			}
+		});
+	}
+
+	// partial results are combined in index order, so reduceFunction only needs to be associative
+	template <typename T, typename MapFunction, typename ReduceFunction>
+	inline T ParallelReduce(int begin, int end, int grainSize, T const& identity, MapFunction const& mapFunction, ReduceFunction const& reduceFunction)
+	{
+		if (end <= begin)
+		{
+			return identity;
+		}
+
+		if (grainSize <= 0)
+		{
+			grainSize = GetAutoGrainSize(end - begin);
+		}
+		int numBatches = (end - begin + grainSize - 1) / grainSize;
+		std::vector<T> partialResults(numBatches, identity);
+		ParallelForBatches(begin, end, grainSize, [&](int batchBegin, int batchEnd)
+		{
+			T partialResult = identity;
+			for (int index = batchBegin; index < batchEnd; index++)
+			{
+				partialResult = reduceFunction(partialResult, mapFunction(index));
+			}
+			partialResults[(batchBegin - begin) / grainSize] = partialResult;
+		});
+
+		T result = identity;
+		for (int batchIndex = 0; batchIndex < numBatches; batchIndex++)
+		{
+			result = reduceFunction(result, partialResults[batchIndex]);
+		}
+		return result;
+	}
+
+	void ParallelForBatches(int begin, int end, int grainSize, std::function<void(int, int)> const& batchFunction, int maxHelperWorkers = -1);
+	int GetAutoGrainSize(int count) const;
+	int GetNumberWorkerThreads() const;
+	int GetNumberWorkerThreads(uint8_t jobType) const;
+	int GetNumberWorkerPools() const;
+	JobWorkerPool* GetWorkerPool(int poolIndex) const;
+	JobWorkerPool* GetWorkerPool(std::string const& poolName) const;
+	JobWorkerPool* GetWorkerPoolForJobType(uint8_t jobType) const;
+
+	int GetWorkerSpinMicroseconds() const;
+	JobSystemStats GetStats() const;
+	void ResetStats();
+
+	JobTelemetry& GetTelemetry();
+	// busy share of the wall time since the last ResetStats, the rest is spent spinning or parked
+	float GetWorkerBusyFraction(int workerThreadID) const;
+	std::string GetWorkerThreadName(int workerThreadID) const;
+	bool ExportChromeTrace(std::string const& filename) const;
+
+	static bool Command_BenchmarkParallelFor(EventArgs& args);
+	static bool Command_JobStats(EventArgs& args);
+	static bool Command_JobTrace(EventArgs& args);
+
+private:
+	void EnqueueJob(Job* jobToExecute, JobCounter* completionCounter);
+	void CompleteJob(Job* completedJob);
+	Job* TakeNextJob(JobWorkerThread* worker);
+	void RouteJob(Job* job);
+	void AddPrioritizedJob(Job* job, JobWorkerPool* pool);
+	Job* TakePrioritizedJob(JobWorkerPool* pool);
+	Job* TakeJobForHelper(uint8_t helpJobMask);
+	void AddPendingJob(uint8_t jobType);
+	void RemovePendingJob(uint8_t jobType);
+	bool RemovePrioritizedJob(Job* job);
+	void RouteJobToWorker(Job* job, JobWorkerPool* pool);
+	Job* StealJob(JobWorkerThread* thief);
+	int DeleteAllQueuedJobs();
+	int DiscardJob(Job* job);
+	int CancelWaitingJobs();
+	void AddWaitingJob(Job* job);
+	void RemoveWaitingJob(Job* job);
+	void DetachDependentJobs(Job* finishedJob);
+	void ReleaseDependentJobs(Job* finishedJob);
+	void DecrementCompletionCounter(JobCounter* counter);
+	ParallelForState* AcquireParallelForState();
+	void ReleaseParallelForState(ParallelForState* state);
+	// call once the job is visible to the pool's workers, the preferred worker is woken when it is parked, else any parked one
+	void WakeParkedWorker(JobWorkerPool* pool, JobWorkerThread* preferredWorker = nullptr);
 
 private:
 	JobSystemConfig m_config;
 
+	std::vector<JobWorkerPool*> m_workerPools;
+	// every worker of every pool, indexed by worker thread ID
 	std::vector<JobWorkerThread*> m_workerThreads;
+	// pool index for each job type value, -1 when no pool accepts it
+	int m_poolIndexForJobType[256] = {};
 
-	std::deque<Job*> m_queuedJobs;
-	std::mutex m_queuedJobsMutex;
+	// jobs no pool accepts, only threads helping in WaitFor can run them
+	std::vector<Job*> m_unroutedJobs;
+	std::mutex m_unroutedJobsMutex;
 
-	std::vector<Job*> m_executingJobs;
-	std::mutex m_executingJobsMutex;
+	// jobs queued behind unfinished dependencies, guarded by Job::s_dependencyMutex
+	std::vector<Job*> m_waitingJobs;
 
-	std::deque<Job*> m_completedJobs;
+	Job* m_firstCompletedJob = nullptr;
+	Job* m_lastCompletedJob = nullptr;
 	std::mutex m_completedJobsMutex;
 
+	std::vector<std::function<void()>> m_mainThreadCallbacks;
+	std::vector<std::function<void()>> m_mainThreadCallbacksToRun;
+	std::mutex m_mainThreadCallbacksMutex;
+
+	std::atomic<int> m_numberPendingJobs = 0;
+	// one count per job type bit, a job with several bits counts towards each
+	std::atomic<int> m_numberPendingJobsByType[8] = {};
 	std::atomic<int> m_numberWorkingThread = 0;
+	std::atomic<int> m_numberCancelledJobs = 0;
+	int m_numberJobPathAllocations = 0;
+
+	// ParallelForBatches recycles its helper jobs and their shared state, the heap is only touched while these grow
+	JobPool<ParallelForJob>* m_parallelForJobPool = nullptr;
+	std::vector<ParallelForState*> m_freeParallelForStates;
+	std::mutex m_parallelForStatesMutex;
+
+	JobTelemetry* m_telemetry = nullptr;
+	double m_statsStartTime = 0.0;
+	std::mutex m_jobsDoneMutex;
+	std::condition_variable m_jobsDoneCondition;
 };
 
 
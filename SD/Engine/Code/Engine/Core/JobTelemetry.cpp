@@ -0,0 +1,197 @@
+#include "Engine/Core/JobTelemetry.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+void JobTimingHistogram::AddSample(int64_t microseconds)
+{
+	int bucketIndex = 0;
+	while (bucketIndex < NUM_JOB_TIMING_BUCKETS - 1 && (microseconds >> (bucketIndex + 1)) > 0)
+	{
+		bucketIndex++;
+	}
+	m_buckets[bucketIndex]++;
+	m_numberSamples++;
+	m_totalMicroseconds += microseconds;
+
+	int64_t maxMicroseconds = m_maxMicroseconds.load(std::memory_order_relaxed);
+	while (microseconds > maxMicroseconds && !m_maxMicroseconds.compare_exchange_weak(maxMicroseconds, microseconds, std::memory_order_relaxed))
+	{
+	}
+}
+
+
+void JobTimingHistogram::Reset()
+{
+	for (int bucketIndex = 0; bucketIndex < NUM_JOB_TIMING_BUCKETS; bucketIndex++)
+	{
+		m_buckets[bucketIndex] = 0;
+	}
+	m_numberSamples = 0;
+	m_totalMicroseconds = 0;
+	m_maxMicroseconds = 0;
+}
+
+
+int JobTimingHistogram::GetNumberSamples() const
+{
+	return m_numberSamples;
+}
+
+
+double JobTimingHistogram::GetAverageMicroseconds() const
+{
+	int numSamples = m_numberSamples;
+	if (numSamples == 0)
+	{
+		return 0.0;
+	}
+	return static_cast<double>(m_totalMicroseconds) / static_cast<double>(numSamples);
+}
+
+
+int64_t JobTimingHistogram::GetMaxMicroseconds() const
+{
+	return m_maxMicroseconds;
+}
+
+
+int64_t JobTimingHistogram::GetPercentileMicroseconds(float percentile) const
+{
+	int numSamples = 0;
+	for (int bucketIndex = 0; bucketIndex < NUM_JOB_TIMING_BUCKETS; bucketIndex++)
+	{
+		numSamples += m_buckets[bucketIndex];
+	}
+	if (numSamples == 0)
+	{
+		return 0;
+	}
+
+	int targetCount = static_cast<int>(percentile * static_cast<float>(numSamples));
+	int runningCount = 0;
+	for (int bucketIndex = 0; bucketIndex < NUM_JOB_TIMING_BUCKETS; bucketIndex++)
+	{
+		runningCount += m_buckets[bucketIndex];
+		if (runningCount > targetCount)
+		{
+			return static_cast<int64_t>(1) << (bucketIndex + 1);
+		}
+	}
+	return m_maxMicroseconds;
+}
+
+
+JobTelemetry::JobTelemetry(int maxTraceEvents)
+{
+	m_traceEvents.resize(maxTraceEvents > 0 ? maxTraceEvents : 1);
+}
+
+
+void JobTelemetry::SetJobTypeName(uint8_t jobType, std::string const& name)
+{
+	m_jobTypeNames[jobType] = name;
+}
+
+
+std::string JobTelemetry::GetJobTypeName(uint8_t jobType) const
+{
+	if (!m_jobTypeNames[jobType].empty())
+	{
+		return m_jobTypeNames[jobType];
+	}
+	return Stringf("JobType 0x%02X", jobType);
+}
+
+
+void JobTelemetry::RecordJob(uint8_t jobType, int workerThreadID, double queuedTime, double startTime, double endTime)
+{
+	int64_t queueMicroseconds = static_cast<int64_t>((startTime - queuedTime) * 1000000.0);
+	int64_t executeMicroseconds = static_cast<int64_t>((endTime - startTime) * 1000000.0);
+	m_queueLatency[jobType].AddSample(queueMicroseconds > 0 ? queueMicroseconds : 0);
+	m_executionTime[jobType].AddSample(executeMicroseconds > 0 ? executeMicroseconds : 0);
+
+	uint64_t eventIndex = m_numberTraceEvents++;
+	JobTraceEvent& traceEvent = m_traceEvents[eventIndex % m_traceEvents.size()];
+	traceEvent.m_queuedTime = queuedTime;
+	traceEvent.m_startTime = startTime;
+	traceEvent.m_endTime = endTime;
+	traceEvent.m_workerThreadID = workerThreadID;
+	traceEvent.m_jobType = jobType;
+}
+
+
+void JobTelemetry::Reset()
+{
+	for (int jobType = 0; jobType < NUM_JOB_TYPE_VALUES; jobType++)
+	{
+		m_queueLatency[jobType].Reset();
+		m_executionTime[jobType].Reset();
+	}
+	m_numberTraceEvents = 0;
+}
+
+
+JobTimingHistogram const& JobTelemetry::GetQueueLatency(uint8_t jobType) const
+{
+	return m_queueLatency[jobType];
+}
+
+
+JobTimingHistogram const& JobTelemetry::GetExecutionTime(uint8_t jobType) const
+{
+	return m_executionTime[jobType];
+}
+
+
+int JobTelemetry::GetTraceEvents(std::vector<JobTraceEvent>& outEvents) const
+{
+	uint64_t numRecorded = m_numberTraceEvents;
+	uint64_t capacity = m_traceEvents.size();
+	uint64_t firstIndex = numRecorded > capacity ? numRecorded - capacity : 0;
+
+	outEvents.clear();
+	outEvents.reserve(static_cast<size_t>(numRecorded - firstIndex));
+	for (uint64_t eventIndex = firstIndex; eventIndex < numRecorded; eventIndex++)
+	{
+		outEvents.push_back(m_traceEvents[eventIndex % capacity]);
+	}
+	return (int)outEvents.size();
+}
+
+
+bool JobTelemetry::ExportChromeTrace(std::string const& filename, std::vector<std::string> const& threadNames) const
+{
+	std::vector<JobTraceEvent> traceEvents;
+	GetTraceEvents(traceEvents);
+
+	double baseTime = 0.0;
+	for (int eventIndex = 0; eventIndex < (int)traceEvents.size(); eventIndex++)
+	{
+		if (eventIndex == 0 || traceEvents[eventIndex].m_queuedTime < baseTime)
+		{
+			baseTime = traceEvents[eventIndex].m_queuedTime;
+		}
+	}
+
+	// chrome://tracing takes complete ("X") events in microseconds, thread names come from metadata ("M") events
+	std::string json = "{\"traceEvents\":[\n";
+	json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"helper\"}}";
+	for (int threadIndex = 0; threadIndex < (int)threadNames.size(); threadIndex++)
+	{
+		json += Stringf(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", threadIndex + 1, threadNames[threadIndex].c_str());
+	}
+
+	for (int eventIndex = 0; eventIndex < (int)traceEvents.size(); eventIndex++)
+	{
+		JobTraceEvent const& traceEvent = traceEvents[eventIndex];
+		double startMicroseconds = (traceEvent.m_startTime - baseTime) * 1000000.0;
+		double durationMicroseconds = (traceEvent.m_endTime - traceEvent.m_startTime) * 1000000.0;
+		double queueMicroseconds = (traceEvent.m_startTime - traceEvent.m_queuedTime) * 1000000.0;
+		json += Stringf(",\n{\"name\":\"%s\",\"cat\":\"job\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"queueUs\":%.3f}}",
+			GetJobTypeName(traceEvent.m_jobType).c_str(), traceEvent.m_workerThreadID + 1, startMicroseconds, durationMicroseconds, queueMicroseconds);
+	}
+	json += "\n]}\n";
+
+	std::vector<uint8_t> buffer(json.begin(), json.end());
+	return FileWriteFromBuffer(buffer, filename) == 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// bucket i holds times in [2^i, 2^(i+1)) microseconds, bucket 0 also holds anything under a microsecond
+constexpr int NUM_JOB_TIMING_BUCKETS = 24;
+constexpr int NUM_JOB_TYPE_VALUES = 256;
+
+struct JobTimingHistogram
+{
+public:
+	void AddSample(int64_t microseconds);
+	void Reset();
+
+	int GetNumberSamples() const;
+	double GetAverageMicroseconds() const;
+	int64_t GetMaxMicroseconds() const;
+	// upper edge of the bucket the percentile falls into
+	int64_t GetPercentileMicroseconds(float percentile) const;
+
+public:
+	std::atomic<int> m_buckets[NUM_JOB_TIMING_BUCKETS] = {};
+	std::atomic<int> m_numberSamples = 0;
+	std::atomic<int64_t> m_totalMicroseconds = 0;
+	std::atomic<int64_t> m_maxMicroseconds = 0;
+};
+
+
+struct JobTraceEvent
+{
+	double m_queuedTime = 0.0;
+	double m_startTime = 0.0;
+	double m_endTime = 0.0;
+	int m_workerThreadID = -1;
+	uint8_t m_jobType = 0;
+};
+
+
+class JobTelemetry
+{
+public:
+	explicit JobTelemetry(int maxTraceEvents = 16384);
+	JobTelemetry(JobTelemetry const& copy) = delete;
+
+	void SetJobTypeName(uint8_t jobType, std::string const& name);
+	std::string GetJobTypeName(uint8_t jobType) const;
+
+	// workerThreadID is -1 for threads helping in WaitFor
+	void RecordJob(uint8_t jobType, int workerThreadID, double queuedTime, double startTime, double endTime);
+	void Reset();
+
+	JobTimingHistogram const& GetQueueLatency(uint8_t jobType) const;
+	JobTimingHistogram const& GetExecutionTime(uint8_t jobType) const;
+
+	// the ring buffer keeps the newest events, a thread still recording may tear the oldest one being overwritten
+	int GetTraceEvents(std::vector<JobTraceEvent>& outEvents) const;
+	// threadNames[i] names worker i, helper threads show up as thread 0
+	bool ExportChromeTrace(std::string const& filename, std::vector<std::string> const& threadNames) const;
+
+private:
+	JobTimingHistogram m_queueLatency[NUM_JOB_TYPE_VALUES];
+	JobTimingHistogram m_executionTime[NUM_JOB_TYPE_VALUES];
+	std::string m_jobTypeNames[NUM_JOB_TYPE_VALUES];
+
+	std::vector<JobTraceEvent> m_traceEvents;
+	std::atomic<uint64_t> m_numberTraceEvents = 0;
+};
@@ -0,0 +1,347 @@
+#include "Game/EngineBuildPreferences.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystem.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// everything here may run before main and from inside operator new, so it is all constant initialized and never allocates
+struct MemoryTagCounters
+{
+	std::atomic<int64_t> m_liveBytes;
+	std::atomic<int64_t> m_peakBytes;
+	std::atomic<int> m_liveAllocations;
+	std::atomic<int> m_frameAllocations;
+	std::atomic<int64_t> m_frameBytes;
+	int m_lastFrameAllocations;
+	int64_t m_lastFrameBytes;
+	int m_worstFrameAllocations;
+	int64_t m_worstFrameBytes;
+	int64_t m_budgetBytes;
+	bool m_isOverBudget;
+};
+
+static MemoryTagCounters s_memoryTagCounters[NUM_MEMORY_TAGS];
+static char const* s_memoryTagNames[NUM_MEMORY_TAGS] =
+{
+	"untagged",
+	"chunks",
+	"meshes",
+	"renderer",
+	"gui",
+	"audio",
+	"net",
+	"definitions",
+	"jobs",
+};
+thread_local MemoryTag t_currentMemoryTag = MEMORY_TAG_UNTAGGED;
+
+static bool Command_Memory(EventArgs& args);
+static bool Command_MemoryBudget(EventArgs& args);
+
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag)
+	: m_previousTag(t_currentMemoryTag)
+{
+	t_currentMemoryTag = tag;
+}
+
+
+MemoryTagScope::~MemoryTagScope()
+{
+	t_currentMemoryTag = m_previousTag;
+}
+
+
+void MemoryTrackerStartup()
+{
+	SubscribeEventCallbackFunction("memory", Command_Memory);
+	SubscribeEventCallbackFunction("memoryBudget", Command_MemoryBudget);
+}
+
+
+void MemoryTrackerShutdown()
+{
+}
+
+
+void MemoryTrackerBeginFrame()
+{
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		MemoryTagCounters& counters = s_memoryTagCounters[tagIndex];
+		counters.m_lastFrameAllocations = counters.m_frameAllocations.exchange(0);
+		counters.m_lastFrameBytes = counters.m_frameBytes.exchange(0);
+		if (counters.m_lastFrameAllocations > counters.m_worstFrameAllocations)
+		{
+			counters.m_worstFrameAllocations = counters.m_lastFrameAllocations;
+		}
+		if (counters.m_lastFrameBytes > counters.m_worstFrameBytes)
+		{
+			counters.m_worstFrameBytes = counters.m_lastFrameBytes;
+		}
+
+		// warn once per crossing, not every frame the tag stays over
+		bool isOverBudget = counters.m_budgetBytes > 0 && counters.m_liveBytes > counters.m_budgetBytes;
+		if (isOverBudget && !counters.m_isOverBudget && g_theDevConsole)
+		{
+			g_theDevConsole->AddLine(DevConsole::INFO_WARNING, Stringf("Memory tag %s is over budget: %.2fMB of %.2fMB", s_memoryTagNames[tagIndex] ? s_memoryTagNames[tagIndex] : "?",
+				static_cast<double>(counters.m_liveBytes) / (1024.0 * 1024.0), static_cast<double>(counters.m_budgetBytes) / (1024.0 * 1024.0)));
+		}
+		counters.m_isOverBudget = isOverBudget;
+	}
+}
+
+
+MemoryTag GetCurrentMemoryTag()
+{
+	return t_currentMemoryTag;
+}
+
+
+void SetCurrentMemoryTag(MemoryTag tag)
+{
+	t_currentMemoryTag = tag;
+}
+
+
+void SetMemoryTagName(MemoryTag tag, char const* name)
+{
+	s_memoryTagNames[tag] = name;
+}
+
+
+char const* GetMemoryTagName(MemoryTag tag)
+{
+	return s_memoryTagNames[tag] ? s_memoryTagNames[tag] : "";
+}
+
+
+bool GetMemoryTagFromName(std::string const& name, MemoryTag& out_tag)
+{
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		if (s_memoryTagNames[tagIndex] && _stricmp(s_memoryTagNames[tagIndex], name.c_str()) == 0)
+		{
+			out_tag = static_cast<MemoryTag>(tagIndex);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void SetMemoryTagBudget(MemoryTag tag, int64_t budgetBytes)
+{
+	s_memoryTagCounters[tag].m_budgetBytes = budgetBytes;
+}
+
+
+MemoryTagStats GetMemoryTagStats(MemoryTag tag)
+{
+	MemoryTagCounters const& counters = s_memoryTagCounters[tag];
+	MemoryTagStats stats;
+	stats.m_liveBytes = counters.m_liveBytes;
+	stats.m_peakBytes = counters.m_peakBytes;
+	stats.m_liveAllocations = counters.m_liveAllocations;
+	stats.m_frameAllocations = counters.m_lastFrameAllocations;
+	stats.m_frameBytes = counters.m_lastFrameBytes;
+	stats.m_worstFrameAllocations = counters.m_worstFrameAllocations;
+	stats.m_worstFrameBytes = counters.m_worstFrameBytes;
+	stats.m_budgetBytes = counters.m_budgetBytes;
+	return stats;
+}
+
+
+MemoryTagStats GetTotalMemoryStats()
+{
+	MemoryTagStats totalStats;
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		MemoryTagStats stats = GetMemoryTagStats(static_cast<MemoryTag>(tagIndex));
+		totalStats.m_liveBytes += stats.m_liveBytes;
+		// tags peak at different times, so this is an upper bound
+		totalStats.m_peakBytes += stats.m_peakBytes;
+		totalStats.m_liveAllocations += stats.m_liveAllocations;
+		totalStats.m_frameAllocations += stats.m_frameAllocations;
+		totalStats.m_frameBytes += stats.m_frameBytes;
+		totalStats.m_worstFrameAllocations += stats.m_worstFrameAllocations;
+		totalStats.m_worstFrameBytes += stats.m_worstFrameBytes;
+		totalStats.m_budgetBytes += stats.m_budgetBytes;
+	}
+	return totalStats;
+}
+
+
+void ResetMemoryPeaks()
+{
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		MemoryTagCounters& counters = s_memoryTagCounters[tagIndex];
+		counters.m_peakBytes = counters.m_liveBytes.load();
+		counters.m_worstFrameAllocations = 0;
+		counters.m_worstFrameBytes = 0;
+	}
+}
+
+
+static bool Command_Memory(EventArgs& args)
+{
+	if (args.GetParsedValue("reset", false))
+	{
+		ResetMemoryPeaks();
+	}
+
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, "## Memory by tag (MB, allocations) ##");
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		MemoryTag tag = static_cast<MemoryTag>(tagIndex);
+		MemoryTagStats stats = GetMemoryTagStats(tag);
+		if (stats.m_peakBytes == 0 && stats.m_budgetBytes == 0)
+		{
+			continue;
+		}
+
+		std::string line = Stringf("%-12s live=%8.2f peak=%8.2f count=%7d  frame=%5d/%8.3f  worst frame=%5d/%8.3f", GetMemoryTagName(tag),
+			static_cast<double>(stats.m_liveBytes) / (1024.0 * 1024.0), static_cast<double>(stats.m_peakBytes) / (1024.0 * 1024.0), stats.m_liveAllocations,
+			stats.m_frameAllocations, static_cast<double>(stats.m_frameBytes) / (1024.0 * 1024.0),
+			stats.m_worstFrameAllocations, static_cast<double>(stats.m_worstFrameBytes) / (1024.0 * 1024.0));
+		if (stats.m_budgetBytes > 0)
+		{
+			line += Stringf("  budget=%.2f", static_cast<double>(stats.m_budgetBytes) / (1024.0 * 1024.0));
+		}
+		g_theDevConsole->AddLine(stats.m_budgetBytes > 0 && stats.m_liveBytes > stats.m_budgetBytes ? DevConsole::INFO_WARNING : DevConsole::INFO_MINOR, line);
+	}
+
+	MemoryTagStats totalStats = GetTotalMemoryStats();
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("%-12s live=%8.2f count=%7d  frame=%5d/%8.3f", "total",
+		static_cast<double>(totalStats.m_liveBytes) / (1024.0 * 1024.0), totalStats.m_liveAllocations,
+		totalStats.m_frameAllocations, static_cast<double>(totalStats.m_frameBytes) / (1024.0 * 1024.0)));
+	return false;
+}
+
+
+static bool Command_MemoryBudget(EventArgs& args)
+{
+	std::string tagName = args.GetValue("tag", "");
+	MemoryTag tag = MEMORY_TAG_UNTAGGED;
+	if (!GetMemoryTagFromName(tagName, tag))
+	{
+		g_theDevConsole->AddLine(DevConsole::INFO_ERROR, Stringf("Unknown memory tag \"%s\"", tagName.c_str()));
+		return false;
+	}
+
+	// mb=0 removes the budget
+	double budgetMegabytes = args.GetParsedValue("mb", 0.0);
+	SetMemoryTagBudget(tag, static_cast<int64_t>(budgetMegabytes * 1024.0 * 1024.0));
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("Memory budget for %s set to %.2fMB", GetMemoryTagName(tag), budgetMegabytes));
+	return false;
+}
+
+
+#if !defined(ENGINE_DISABLE_MEMORY_TRACKING)
+
+// sits right in front of every tracked block, the block is aligned to at least the header size whatever malloc returns
+struct MemoryAllocationHeader
+{
+	uint64_t m_size;
+	uint32_t m_offset;
+	MemoryTag m_tag;
+	uint8_t m_padding[3];
+};
+static_assert(sizeof(MemoryAllocationHeader) == 16, "memory header must be 16 bytes, the minimum block alignment is taken from it");
+
+
+static void* TrackedAllocate(size_t size, size_t alignment)
+{
+	if (alignment < sizeof(MemoryAllocationHeader))
+	{
+		alignment = sizeof(MemoryAllocationHeader);
+	}
+
+	// malloc only promises 8 bytes on Win32, so the block can start up to header plus alignment - 1 bytes in
+	size_t overhead = alignment + sizeof(MemoryAllocationHeader);
+	if (size > SIZE_MAX - overhead)
+	{
+		return nullptr;
+	}
+	uint8_t* rawBlock = static_cast<uint8_t*>(malloc(size + overhead));
+	if (!rawBlock)
+	{
+		return nullptr;
+	}
+
+	uintptr_t blockAddress = reinterpret_cast<uintptr_t>(rawBlock) + sizeof(MemoryAllocationHeader);
+	blockAddress = (blockAddress + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+	uint8_t* block = reinterpret_cast<uint8_t*>(blockAddress);
+
+	MemoryTag tag = t_currentMemoryTag;
+	MemoryAllocationHeader* header = reinterpret_cast<MemoryAllocationHeader*>(block) - 1;
+	header->m_size = size;
+	header->m_offset = static_cast<uint32_t>(block - rawBlock);
+	header->m_tag = tag;
+
+	MemoryTagCounters& counters = s_memoryTagCounters[tag];
+	int64_t liveBytes = counters.m_liveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+	counters.m_liveAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters.m_frameAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters.m_frameBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+
+	int64_t peakBytes = counters.m_peakBytes.load(std::memory_order_relaxed);
+	while (liveBytes > peakBytes && !counters.m_peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+	{
+	}
+	return block;
+}
+
+
+static void TrackedFree(void* block)
+{
+	if (!block)
+	{
+		return;
+	}
+
+	MemoryAllocationHeader* header = static_cast<MemoryAllocationHeader*>(block) - 1;
+	MemoryTagCounters& counters = s_memoryTagCounters[header->m_tag];
+	counters.m_liveBytes.fetch_sub(static_cast<int64_t>(header->m_size), std::memory_order_relaxed);
+	counters.m_liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	free(static_cast<uint8_t*>(block) - header->m_offset);
+}
+
+
+static void* TrackedAllocateOrThrow(size_t size, size_t alignment)
+{
+	void* block = TrackedAllocate(size == 0 ? 1 : size, alignment);
+	if (!block)
+	{
+		throw std::bad_alloc();
+	}
+	return block;
+}
+
+
+void* operator new(size_t size)														{ return TrackedAllocateOrThrow(size, 0); }
+void* operator new[](size_t size)													{ return TrackedAllocateOrThrow(size, 0); }
+void* operator new(size_t size, std::nothrow_t const&) noexcept						{ return TrackedAllocate(size == 0 ? 1 : size, 0); }
+void* operator new[](size_t size, std::nothrow_t const&) noexcept					{ return TrackedAllocate(size == 0 ? 1 : size, 0); }
+void operator delete(void* block) noexcept											{ TrackedFree(block); }
+void operator delete[](void* block) noexcept										{ TrackedFree(block); }
+void operator delete(void* block, size_t) noexcept									{ TrackedFree(block); }
+void operator delete[](void* block, size_t) noexcept								{ TrackedFree(block); }
+void operator delete(void* block, std::nothrow_t const&) noexcept					{ TrackedFree(block); }
+void operator delete[](void* block, std::nothrow_t const&) noexcept					{ TrackedFree(block); }
+
+#if defined(__cpp_aligned_new)
+void* operator new(size_t size, std::align_val_t alignment)							{ return TrackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment)						{ return TrackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void operator delete(void* block, std::align_val_t) noexcept						{ TrackedFree(block); }
+void operator delete[](void* block, std::align_val_t) noexcept						{ TrackedFree(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept				{ TrackedFree(block); }
+void operator delete[](void* block, size_t, std::align_val_t) noexcept				{ TrackedFree(block); }
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+
+#include <cstdint>
+
+// every operator new/delete in the program goes through the tracker unless ENGINE_DISABLE_MEMORY_TRACKING is defined,
+// allocations are charged to the calling thread's current tag
+enum MemoryTag : uint8_t
+{
+	MEMORY_TAG_UNTAGGED,
+	MEMORY_TAG_CHUNKS,
+	MEMORY_TAG_MESHES,
+	MEMORY_TAG_RENDERER,
+	MEMORY_TAG_GUI,
+	MEMORY_TAG_AUDIO,
+	MEMORY_TAG_NET,
+	MEMORY_TAG_DEFINITIONS,
+	// the job system's queueing and completion path, stays at zero once the queues have grown
+	MEMORY_TAG_JOBS,
+	// games name their own tags from here with SetMemoryTagName
+	MEMORY_TAG_FIRST_GAME_TAG,
+	NUM_MEMORY_TAGS = 16
+};
+
+
+struct MemoryTagStats
+{
+	int64_t m_liveBytes = 0;
+	int64_t m_peakBytes = 0;
+	int m_liveAllocations = 0;
+	// last completed frame and the worst frame since the last reset
+	int m_frameAllocations = 0;
+	int64_t m_frameBytes = 0;
+	int m_worstFrameAllocations = 0;
+	int64_t m_worstFrameBytes = 0;
+	// 0 means no budget
+	int64_t m_budgetBytes = 0;
+};
+
+
+// sets the calling thread's tag for the rest of the enclosing block
+#define MEMORY_TAG_SCOPE_CONCAT_INNER(a, b) a##b
+#define MEMORY_TAG_SCOPE_CONCAT(a, b) MEMORY_TAG_SCOPE_CONCAT_INNER(a, b)
+#define MEMORY_TAG_SCOPE(tag) MemoryTagScope MEMORY_TAG_SCOPE_CONCAT(memoryTagScope_, __LINE__)(tag)
+
+class MemoryTagScope
+{
+public:
+	explicit MemoryTagScope(MemoryTag tag);
+	~MemoryTagScope();
+	MemoryTagScope(MemoryTagScope const& copy) = delete;
+
+private:
+	MemoryTag m_previousTag = MEMORY_TAG_UNTAGGED;
+};
+
+
+// Setup
+void MemoryTrackerStartup();
+void MemoryTrackerShutdown();
+// closes the per frame allocation counts and warns about tags that went over budget
+void MemoryTrackerBeginFrame();
+
+// Tags
+MemoryTag GetCurrentMemoryTag();
+void SetCurrentMemoryTag(MemoryTag tag);
+void SetMemoryTagName(MemoryTag tag, char const* name);
+char const* GetMemoryTagName(MemoryTag tag);
+bool GetMemoryTagFromName(std::string const& name, MemoryTag& out_tag);
+
+// Stats
+void SetMemoryTagBudget(MemoryTag tag, int64_t budgetBytes);
+MemoryTagStats GetMemoryTagStats(MemoryTag tag);
+MemoryTagStats GetTotalMemoryStats();
+void ResetMemoryPeaks();
@@ -1,155 +1,343 @@
 #pragma once
 #include "Engine/Core/StringUtils.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 #include <string>
-#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-class NamedPropertyBase
+// address of a per type static, stands in for typeid so GetValue needs no RTTI
+typedef void const* NamedPropertyTypeId;
+
+template <typename T>
+inline NamedPropertyTypeId GetNamedPropertyTypeId()
+{
+	// not const, identical read only data may be folded into one address by the linker
+	static char s_typeTag = 0;
+	return &s_typeTag;
+}
+
+
+// values this small and trivially copyable live inside the entry, everything else goes on the heap
+constexpr int NAMED_PROPERTY_INLINE_BYTES = 16;
+
+template <typename T>
+struct IsNamedPropertyInline
+	: std::integral_constant<bool, sizeof(T) <= NAMED_PROPERTY_INLINE_BYTES && alignof(T) <= alignof(void*) && std::is_trivially_copyable<T>::value>
 {
-	friend class NamedProperties;
+};
 
-protected:
-	NamedPropertyBase() {}
-	virtual ~NamedPropertyBase() {}
 
-	virtual NamedPropertyBase* Clone() const = 0;
+// copy and delete for a heap value whose type is only known where it was set
+struct NamedPropertyHeapFunctions
+{
+	void* (*m_cloneFunction)(void const* value);
+	void (*m_deleteFunction)(void* value);
 };
 
+template <typename T>
+inline void* CloneNamedPropertyValue(void const* value)
+{
+	return new T(*static_cast<T const*>(value));
+}
+
+template <typename T>
+inline void DeleteNamedPropertyValue(void* value)
+{
+	delete static_cast<T*>(value);
+}
 
 template <typename T>
-class NamedProperty : public NamedPropertyBase
+inline NamedPropertyHeapFunctions const* GetNamedPropertyHeapFunctions()
 {
-	friend class NamedProperties;
+	static NamedPropertyHeapFunctions const s_functions = { &CloneNamedPropertyValue<T>, &DeleteNamedPropertyValue<T> };
+	return &s_functions;
+}
 
-	NamedProperty(T value)
-		: m_value(value)
+
+class NamedPropertyEntry
+{
+public:
+	NamedPropertyEntry() {}
+	~NamedPropertyEntry()
 	{
+		ReleaseValue();
 	}
-	NamedProperty(NamedProperty<T> const& prop)
+
+	NamedPropertyEntry(NamedPropertyEntry const& copy)
 	{
-		m_value = prop.m_value;
+		CopyFrom(copy);
 	}
 
-	virtual ~NamedProperty() {}
-
-	virtual NamedPropertyBase* Clone() const override
+	NamedPropertyEntry(NamedPropertyEntry&& copy) noexcept
 	{
-		return new NamedProperty<T>(*this);
+		MoveFrom(copy);
 	}
 
-	T m_value;
-};
-
+	NamedPropertyEntry& operator=(NamedPropertyEntry const& copy)
+	{
+		if (this != &copy)
+		{
+			ReleaseValue();
+			CopyFrom(copy);
+		}
+		return *this;
+	}
 
-class NamedProperties
-{
-public:
-	NamedProperties() {}
-	~NamedProperties()
+	NamedPropertyEntry& operator=(NamedPropertyEntry&& copy) noexcept
 	{
-		for (auto item : m_properties)
+		if (this != &copy)
 		{
-			delete item.second;
+			ReleaseValue();
+			MoveFrom(copy);
 		}
-		m_properties.clear();
+		return *this;
 	}
 
-	
-	NamedProperties(NamedProperties const& properties)
+	template <typename T>
+	inline void SetValue(T const& value)
 	{
-		for (auto p : properties.m_properties)
+		// same type overwrites in place, so setting a key every frame does not touch the heap
+		if (m_typeId == GetNamedPropertyTypeId<T>())
 		{
-			m_properties[p.first] = p.second->Clone();
+			*static_cast<T*>(GetValuePointer()) = value;
+			return;
 		}
+
+		ReleaseValue();
+		StoreValue(value, IsNamedPropertyInline<T>());
+		m_typeId = GetNamedPropertyTypeId<T>();
 	}
 
-	NamedProperties(NamedProperties&& properties) noexcept
+	template <typename T>
+	inline T const* GetValue() const
 	{
-		m_properties = std::move(properties.m_properties);
+		if (m_typeId != GetNamedPropertyTypeId<T>()) return nullptr;
+		return static_cast<T const*>(GetValuePointer());
 	}
 
-	void operator=(NamedProperties const& properties)
+public:
+	std::string m_key;
+
+private:
+	template <typename T>
+	inline void StoreValue(T const& value, std::true_type)
 	{
-		for (auto item : m_properties)
-		{
-			delete item.second;
-		}
-		m_properties.clear();
+		new (m_inlineValue) T(value);
+	}
 
-		for (auto p : properties.m_properties)
+	template <typename T>
+	inline void StoreValue(T const& value, std::false_type)
+	{
+		m_heapValue = new T(value);
+		m_heapFunctions = GetNamedPropertyHeapFunctions<T>();
+	}
+
+	void* GetValuePointer()						{ return m_heapFunctions ? m_heapValue : static_cast<void*>(m_inlineValue); }
+	void const* GetValuePointer() const			{ return m_heapFunctions ? m_heapValue : static_cast<void const*>(m_inlineValue); }
+
+	void ReleaseValue()
+	{
+		if (m_heapFunctions)
 		{
-			m_properties[p.first] = p.second->Clone();
+			m_heapFunctions->m_deleteFunction(m_heapValue);
 		}
+		m_heapFunctions = nullptr;
+		m_typeId = nullptr;
 	}
 
-	void operator=(NamedProperties&& properties) noexcept
+	void CopyFrom(NamedPropertyEntry const& copy)
 	{
-		for (auto item : m_properties)
+		m_key = copy.m_key;
+		m_typeId = copy.m_typeId;
+		m_heapFunctions = copy.m_heapFunctions;
+		if (m_heapFunctions)
 		{
-			delete item.second;
+			m_heapValue = m_heapFunctions->m_cloneFunction(copy.m_heapValue);
 		}
-		m_properties.clear();
+		else
+		{
+			memcpy(m_inlineValue, copy.m_inlineValue, NAMED_PROPERTY_INLINE_BYTES);
+		}
+	}
 
-		m_properties = std::move(properties.m_properties);
+	void MoveFrom(NamedPropertyEntry& copy)
+	{
+		m_key = std::move(copy.m_key);
+		m_typeId = copy.m_typeId;
+		m_heapFunctions = copy.m_heapFunctions;
+		memcpy(m_inlineValue, copy.m_inlineValue, NAMED_PROPERTY_INLINE_BYTES);
+		copy.m_heapFunctions = nullptr;
+		copy.m_typeId = nullptr;
 	}
 
-	template <typename T>
-	inline void SetValue(std::string const& key, T value)
+private:
+	NamedPropertyTypeId m_typeId = nullptr;
+	// null for inline values
+	NamedPropertyHeapFunctions const* m_heapFunctions = nullptr;
+	union
 	{
-		NamedPropertyBase* namedProp = new NamedProperty<T>(value);
-		std::map<std::string, NamedPropertyBase*>::iterator iter = m_properties.find(key);
+		alignas(void*) unsigned char m_inlineValue[NAMED_PROPERTY_INLINE_BYTES];
+		void* m_heapValue;
+	};
+};
 
-		if (iter == m_properties.end())
+
+// keys sorted in a flat array, the first few entries live in the object itself so typical EventArgs never allocate
+constexpr int NAMED_PROPERTIES_INLINE_ENTRIES = 4;
+
+class NamedProperties
+{
+public:
+	NamedProperties() {}
+	~NamedProperties() {}
+
+	NamedProperties(NamedProperties const& properties) = default;
+	NamedProperties& operator=(NamedProperties const& properties) = default;
+
+	NamedProperties(NamedProperties&& properties) noexcept
+	{
+		*this = std::move(properties);
+	}
+
+	NamedProperties& operator=(NamedProperties&& properties) noexcept
+	{
+		if (this != &properties)
 		{
-			m_properties[key] = namedProp;
-			return;
+			for (int entryIndex = 0; entryIndex < NAMED_PROPERTIES_INLINE_ENTRIES; entryIndex++)
+			{
+				m_inlineEntries[entryIndex] = std::move(properties.m_inlineEntries[entryIndex]);
+			}
+			m_heapEntries = std::move(properties.m_heapEntries);
+			m_numEntries = properties.m_numEntries;
+			// left empty rather than half moved
+			properties.m_heapEntries.clear();
+			properties.m_numEntries = 0;
 		}
+		return *this;
+	}
 
-		// static is faster, but dynamic ensure types are same
-		NamedProperty<T>* prop = dynamic_cast<NamedProperty<T>*>(iter->second);
-		if (prop)
+	template <typename T>
+	inline void SetValue(std::string const& key, T value)
+	{
+		int entryIndex = FindInsertIndex(key);
+		NamedPropertyEntry* entries = GetEntries();
+		if (entryIndex < m_numEntries && entries[entryIndex].m_key == key)
 		{
-			iter->second = namedProp;
+			entries[entryIndex].SetValue(value);
 			return;
 		}
-
-		m_properties.erase(iter);
-		m_properties[key] = namedProp;
+		InsertEntry(entryIndex, key).SetValue(value);
 	}
 
 	inline void SetValue(std::string const& key, char const* value)
 	{
-		std::string const& string = Stringf(value);
-		SetValue(key, string);
+		SetValue(key, std::string(value));
 	}
 
 	template <typename T>
 	inline T GetValue(std::string const& key, T defaultValue) const
 	{
-		std::map<std::string, NamedPropertyBase*>::const_iterator iter = m_properties.find(key);
-		if (iter == m_properties.end())
-		{
-			return defaultValue;
-		}
+		NamedPropertyEntry const* entry = FindEntry(key);
+		if (!entry) return defaultValue;
 
-		// static is faster, but dynamic ensure types are same
-		NamedProperty<T>* prop = dynamic_cast<NamedProperty<T>*>(iter->second);
-		if (prop)
-		{
-			return prop->m_value;
-		}
+		// a key set with a different type reads as missing
+		T const* value = entry->GetValue<T>();
+		return value ? *value : defaultValue;
+	}
+
+	inline std::string GetValue(std::string const& key, char const* defaultValue) const
+	{
+		return GetValue(key, std::string(defaultValue));
+	}
+
+	// like GetValue, but a key holding text is parsed as T, which is how dev console arguments arrive
+	template <typename T>
+	inline T GetParsedValue(std::string const& key, T defaultValue) const
+	{
+		NamedPropertyEntry const* entry = FindEntry(key);
+		if (!entry) return defaultValue;
+
+		T const* value = entry->GetValue<T>();
+		if (value) return *value;
+		std::string const* text = entry->GetValue<std::string>();
+		return text ? ParseText(*text, defaultValue) : defaultValue;
+	}
 
+	int GetNumProperties() const				{ return m_numEntries; }
+
+private:
+	// the default only picks the overload, except for bool where text that is neither true nor false falls back to it
+	static int ParseText(std::string const& text, int)			{ return atoi(text.c_str()); }
+	static float ParseText(std::string const& text, float)		{ return static_cast<float>(atof(text.c_str())); }
+	static double ParseText(std::string const& text, double)	{ return atof(text.c_str()); }
+	static bool ParseText(std::string const& text, bool defaultValue)
+	{
+		if (text == "true") return true;
+		if (text == "false") return false;
 		return defaultValue;
 	}
 
-	inline std::string GetValue(std::string const& key, char const* defaultValue) const
+	bool IsOnHeap() const						{ return !m_heapEntries.empty(); }
+	NamedPropertyEntry* GetEntries()			{ return IsOnHeap() ? m_heapEntries.data() : m_inlineEntries; }
+	NamedPropertyEntry const* GetEntries() const	{ return IsOnHeap() ? m_heapEntries.data() : m_inlineEntries; }
+
+	int FindInsertIndex(std::string const& key) const
 	{
-		std::string const& string = Stringf(defaultValue);
-		return GetValue(key, string);
+		NamedPropertyEntry const* entries = GetEntries();
+		NamedPropertyEntry const* found = std::lower_bound(entries, entries + m_numEntries, key,
+			[](NamedPropertyEntry const& entry, std::string const& searchKey) { return entry.m_key < searchKey; });
+		return (int)(found - entries);
 	}
 
-public:
-	std::map<std::string, NamedPropertyBase*> m_properties;
-};
+	NamedPropertyEntry const* FindEntry(std::string const& key) const
+	{
+		int entryIndex = FindInsertIndex(key);
+		NamedPropertyEntry const* entries = GetEntries();
+		if (entryIndex < m_numEntries && entries[entryIndex].m_key == key)
+		{
+			return &entries[entryIndex];
+		}
+		return nullptr;
+	}
 
+	NamedPropertyEntry& InsertEntry(int entryIndex, std::string const& key)
+	{
+		NamedPropertyEntry newEntry;
+		newEntry.m_key = key;
 
+		if (!IsOnHeap() && m_numEntries < NAMED_PROPERTIES_INLINE_ENTRIES)
+		{
+			for (int shiftIndex = m_numEntries; shiftIndex > entryIndex; shiftIndex--)
+			{
+				m_inlineEntries[shiftIndex] = std::move(m_inlineEntries[shiftIndex - 1]);
+			}
+			m_inlineEntries[entryIndex] = std::move(newEntry);
+			m_numEntries++;
+			return m_inlineEntries[entryIndex];
+		}
+
+		// spilled for good once the inline entries are full
+		if (!IsOnHeap())
+		{
+			m_heapEntries.reserve(NAMED_PROPERTIES_INLINE_ENTRIES * 2);
+			for (int inlineIndex = 0; inlineIndex < m_numEntries; inlineIndex++)
+			{
+				m_heapEntries.push_back(std::move(m_inlineEntries[inlineIndex]));
+				m_inlineEntries[inlineIndex] = NamedPropertyEntry();
+			}
+		}
+		m_heapEntries.insert(m_heapEntries.begin() + entryIndex, std::move(newEntry));
+		m_numEntries++;
+		return m_heapEntries[entryIndex];
+	}
+
+private:
+	NamedPropertyEntry m_inlineEntries[NAMED_PROPERTIES_INLINE_ENTRIES];
+	std::vector<NamedPropertyEntry> m_heapEntries;
+	int m_numEntries = 0;
+};
@@ -2,6 +2,7 @@
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/IntVec2.hpp"
+#include "Engine/Core/StringUtils.hpp"
 
 void NamedStrings::PopulateFromXmlElementAttributes(XmlElement const& element)
 {
@@ -14,6 +15,27 @@ void NamedStrings::PopulateFromXmlElementAttributes(XmlElement const& element)
 }
 
 
+void NamedStrings::PopulateFromCommandLine(std::string const& commandLine)
+{
+	Strings arguments = SplitStringOnDelimiter(commandLine, ' ');
+	for (int argumentIndex = 0; argumentIndex < (int)arguments.size(); argumentIndex++)
+	{
+		std::string const& argument = arguments[argumentIndex];
+		if (argument.empty()) continue;
+
+		Strings keyAndValue = SplitStringOnFirstDelimiter(argument, '=');
+		if (keyAndValue.size() == 2)
+		{
+			SetValue(keyAndValue[0], keyAndValue[1]);
+		}
+		else
+		{
+			SetValue(argument, "true");
+		}
+	}
+}
+
+
 void NamedStrings::SetValue(std::string const& keyName, std::string const& newValue)
 {
 	m_keyValuePairs[keyName] = newValue;
@@ -21,6 +21,8 @@ public:
 	~NamedStrings() {}
 
 	void PopulateFromXmlElementAttributes(XmlElement const& element);
+	// space separated key=value pairs, a bare key is set to "true"
+	void PopulateFromCommandLine(std::string const& commandLine);
 	void SetValue(std::string const& keyName, std::string const& newValue);
 	std::string GetValue(std::string const& keyName, std::string const& defaultValue) const;
 	bool GetValue(std::string const& keyName, bool defaultValue) const;
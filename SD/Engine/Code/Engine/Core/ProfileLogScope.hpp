@@ -2,26 +2,31 @@
 #include "Engine/Core/Time.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Profiler.hpp"
 
 #include <string>
 
+// prints the scope duration to the dev console and shows it in the profiler, PROFILE_SCOPE is cheaper for code that runs every frame
 class ProfileLogScope
 {
 public:
-	ProfileLogScope(char const* logDesc)
+	// logDesc is copied, the profiler gets an interned copy since its events outlive the scope
+	ProfileLogScope(std::string const& logDesc)
 		: m_logDesc(logDesc)
 		, m_startTime(GetCurrentTimeSeconds())
+		, m_profileScope(Profiler::InternScopeName(logDesc))
 	{
 	}
 
 	~ProfileLogScope()
 	{
 		double duration = GetCurrentTimeSeconds() - m_startTime;
-		std::string line = Stringf("%s: %.5fs", m_logDesc, duration);
+		std::string line = Stringf("%s: %.5fs", m_logDesc.c_str(), duration);
 		g_theDevConsole->AddLine(Rgba8::WHITE, line);
 	}
 
 private:
-	char const* m_logDesc;
+	std::string m_logDesc;
 	double m_startTime = 0.0;
+	ProfileScope m_profileScope;
 };
\ No newline at end of file
@@ -0,0 +1,639 @@
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <intrin.h>
+#include <set>
+
+Profiler* g_theProfiler = nullptr;
+
+constexpr int PROFILER_VIEW_LINES = 40;
+
+static std::atomic<int> s_nextProfilerID = 1;
+thread_local ProfilerThreadBuffer* t_profilerThreadBuffer = nullptr;
+thread_local int t_profilerThreadBufferID = 0;
+
+
+ProfilerThreadBuffer::ProfilerThreadBuffer(int threadIndex, int numEvents)
+	: m_threadIndex(threadIndex)
+	, m_threadName(Stringf("thread %d", threadIndex))
+{
+	uint32_t capacity = 2;
+	while (capacity < static_cast<uint32_t>(numEvents))
+	{
+		capacity <<= 1;
+	}
+	m_events.resize(capacity);
+	m_eventMask = capacity - 1;
+}
+
+
+bool ProfilerThreadBuffer::PushBegin(char const* name)
+{
+	uint32_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+	uint32_t readIndex = m_readIndex.load(std::memory_order_acquire);
+	uint32_t numFreeEvents = static_cast<uint32_t>(m_events.size()) - (writeIndex - readIndex);
+	if (numFreeEvents < static_cast<uint32_t>(m_numberOpenScopes) + 2)
+	{
+		// dropping the whole scope keeps begins and ends paired
+		m_numberDroppedScopes++;
+		return false;
+	}
+
+	ProfileEvent& profileEvent = m_events[writeIndex & m_eventMask];
+	profileEvent.m_name = name;
+	profileEvent.m_type = PROFILE_EVENT_BEGIN;
+	profileEvent.m_ticks = Profiler::GetTicks();
+	m_writeIndex.store(writeIndex + 1, std::memory_order_release);
+	m_numberOpenScopes++;
+	return true;
+}
+
+
+void ProfilerThreadBuffer::PushEnd()
+{
+	uint64_t ticks = Profiler::GetTicks();
+	uint32_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+
+	ProfileEvent& profileEvent = m_events[writeIndex & m_eventMask];
+	profileEvent.m_name = nullptr;
+	profileEvent.m_type = PROFILE_EVENT_END;
+	profileEvent.m_ticks = ticks;
+	m_writeIndex.store(writeIndex + 1, std::memory_order_release);
+	m_numberOpenScopes--;
+}
+
+
+ProfileScope::ProfileScope(char const* name)
+{
+	if (!g_theProfiler)
+	{
+		return;
+	}
+	m_threadBuffer = g_theProfiler->GetCurrentThreadBuffer();
+	if (!m_threadBuffer->PushBegin(name))
+	{
+		m_threadBuffer = nullptr;
+	}
+}
+
+
+ProfileScope::~ProfileScope()
+{
+	if (m_threadBuffer)
+	{
+		m_threadBuffer->PushEnd();
+	}
+}
+
+
+Profiler::Profiler(ProfilerConfig const& config)
+	: m_config(config)
+	, m_profilerID(s_nextProfilerID++)
+	, m_isVisible(config.m_startVisible)
+{
+	if (m_config.m_historyFrames < 1)
+	{
+		m_config.m_historyFrames = 1;
+	}
+}
+
+
+Profiler::~Profiler()
+{
+	ShutDown();
+}
+
+
+void Profiler::Startup()
+{
+	// calibrate the tick rate against the wall clock, BeginFrame keeps refining it over a longer baseline
+	m_startupTicks = GetTicks();
+	m_startupSeconds = GetCurrentTimeSeconds();
+	while (GetCurrentTimeSeconds() - m_startupSeconds < 0.01)
+	{
+	}
+	UpdateTickFrequency();
+
+	SetCurrentThreadName("main");
+
+	if (g_theEventSystem)
+	{
+		SubscribeEventCallbackFunction("profiler", Command_Profiler);
+		SubscribeEventCallbackFunction("profilerCapture", Command_ProfilerCapture);
+		SubscribeEventCallbackFunction("profilerReset", Command_ProfilerReset);
+	}
+}
+
+
+void Profiler::BeginFrame()
+{
+	UpdateTickFrequency();
+
+	m_threadBuffersMutex.lock();
+	std::vector<ProfilerThreadBuffer*> threadBuffers = m_threadBuffers;
+	m_threadBuffersMutex.unlock();
+
+	for (int bufferIndex = 0; bufferIndex < (int)threadBuffers.size(); bufferIndex++)
+	{
+		DrainThreadBuffer(*threadBuffers[bufferIndex]);
+	}
+	CloseFrameHistory();
+
+	if (m_numberCaptureFramesLeft > 0)
+	{
+		m_numberCaptureFramesLeft--;
+		if (m_numberCaptureFramesLeft == 0)
+		{
+			bool isWritten = WriteCapture();
+			if (g_theDevConsole)
+			{
+				if (isWritten)
+				{
+					g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("Wrote %d profile scopes to %s, open it in chrome://tracing", (int)m_capturedScopes.size(), m_captureFilename.c_str()));
+				}
+				else
+				{
+					g_theDevConsole->AddLine(DevConsole::INFO_ERROR, Stringf("Could not write profile capture to %s", m_captureFilename.c_str()));
+				}
+			}
+			m_capturedScopes.clear();
+		}
+	}
+}
+
+
+void Profiler::EndFrame()
+{
+}
+
+
+void Profiler::ShutDown()
+{
+	m_threadBuffersMutex.lock();
+	for (int bufferIndex = 0; bufferIndex < (int)m_threadBuffers.size(); bufferIndex++)
+	{
+		delete m_threadBuffers[bufferIndex];
+	}
+	m_threadBuffers.clear();
+	// threads still pointing at the deleted buffers register again under the new id
+	m_profilerID = s_nextProfilerID++;
+	m_threadBuffersMutex.unlock();
+
+	m_nodes.clear();
+	m_capturedScopes.clear();
+	m_numberCaptureFramesLeft = 0;
+}
+
+
+void Profiler::SetCurrentThreadName(std::string const& name)
+{
+	ProfilerThreadBuffer* threadBuffer = GetCurrentThreadBuffer();
+	m_threadBuffersMutex.lock();
+	threadBuffer->m_threadName = name;
+	m_threadBuffersMutex.unlock();
+}
+
+
+ProfileScopeStats Profiler::GetScopeStats(char const* name) const
+{
+	std::vector<int> nodeIndices;
+	for (int nodeIndex = 0; nodeIndex < (int)m_nodes.size(); nodeIndex++)
+	{
+		char const* nodeName = m_nodes[nodeIndex].m_name;
+		// the same literal can have a different address in another translation unit
+		if (nodeName && (nodeName == name || strcmp(nodeName, name) == 0))
+		{
+			nodeIndices.push_back(nodeIndex);
+		}
+	}
+	return GetNodeStats(nodeIndices);
+}
+
+
+void Profiler::ResetHistory()
+{
+	for (int nodeIndex = 0; nodeIndex < (int)m_nodes.size(); nodeIndex++)
+	{
+		ProfileNode& node = m_nodes[nodeIndex];
+		std::fill(node.m_historyMilliseconds.begin(), node.m_historyMilliseconds.end(), 0.f);
+		std::fill(node.m_historyCalls.begin(), node.m_historyCalls.end(), 0);
+	}
+	m_historyIndex = 0;
+	m_numberHistoryFrames = 0;
+}
+
+
+void Profiler::StartCapture(int numFrames, std::string const& filename)
+{
+	m_capturedScopes.clear();
+	m_captureFilename = filename;
+	m_numberCaptureFramesLeft = numFrames > 0 ? numFrames : 1;
+}
+
+
+bool Profiler::IsCapturing() const
+{
+	return m_numberCaptureFramesLeft > 0;
+}
+
+
+void Profiler::SetVisible(bool isVisible)
+{
+	m_isVisible = isVisible;
+}
+
+
+bool Profiler::IsVisible() const
+{
+	return m_isVisible;
+}
+
+
+void Profiler::Render(AABB2 const& bounds) const
+{
+	if (!m_isVisible || !m_config.m_renderer)
+	{
+		return;
+	}
+
+	std::vector<int> rowNodeIndices;
+	for (int nodeIndex = 0; nodeIndex < (int)m_nodes.size(); nodeIndex++)
+	{
+		if (m_nodes[nodeIndex].m_parentIndex < 0)
+		{
+			AddNodeRowsForRender(nodeIndex, rowNodeIndices);
+		}
+	}
+
+	Vec2 boxDimensions = bounds.GetDimensions();
+	float cellHeight = boxDimensions.y / static_cast<float>(PROFILER_VIEW_LINES);
+	float nameWidth = boxDimensions.x * 0.35f;
+	float barWidth = boxDimensions.x * 0.25f;
+	int numRows = (int)rowNodeIndices.size() < PROFILER_VIEW_LINES ? (int)rowNodeIndices.size() : PROFILER_VIEW_LINES;
+
+	std::vector<Vertex_PCU> boxVerts;
+	AABB2 panelBox(Vec2(bounds.m_mins.x, bounds.m_maxs.y - cellHeight * static_cast<float>(numRows)), bounds.m_maxs);
+	AddVertsForAABB2D(boxVerts, panelBox, Rgba8(0, 0, 0, 150));
+
+	BitmapFont* font = m_config.m_renderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
+	std::vector<Vertex_PCU> textVerts;
+
+	m_threadBuffersMutex.lock();
+	for (int rowIndex = 0; rowIndex < numRows; rowIndex++)
+	{
+		ProfileNode const& node = m_nodes[rowNodeIndices[rowIndex]];
+		float rowMaxY = bounds.m_maxs.y - cellHeight * static_cast<float>(rowIndex);
+		float rowMinY = rowMaxY - cellHeight;
+
+		// thread rows only carry the thread name
+		if (!node.m_name)
+		{
+			std::string threadName = "";
+			for (int bufferIndex = 0; bufferIndex < (int)m_threadBuffers.size(); bufferIndex++)
+			{
+				if (m_threadBuffers[bufferIndex]->m_threadIndex == node.m_threadIndex)
+				{
+					threadName = m_threadBuffers[bufferIndex]->m_threadName;
+					int numDroppedScopes = m_threadBuffers[bufferIndex]->m_numberDroppedScopes;
+					if (numDroppedScopes > 0)
+					{
+						threadName += Stringf(" (%d scopes dropped, buffer full)", numDroppedScopes);
+					}
+				}
+			}
+			AABB2 threadBox(Vec2(bounds.m_mins.x, rowMinY), Vec2(bounds.m_maxs.x, rowMaxY));
+			font->AddVertsForTextInBox2D(textVerts, threadBox, cellHeight, threadName, Rgba8::CYAN, 1.f, Vec2(0.f, 0.5f), TextBoxMode::SHRINK_TO_FIT);
+			continue;
+		}
+
+		std::vector<int> nodeIndices;
+		nodeIndices.push_back(rowNodeIndices[rowIndex]);
+		ProfileScopeStats stats = GetNodeStats(nodeIndices);
+
+		float indent = cellHeight * static_cast<float>(node.m_depth);
+		AABB2 nameBox(Vec2(bounds.m_mins.x + indent, rowMinY), Vec2(bounds.m_mins.x + nameWidth, rowMaxY));
+		font->AddVertsForTextInBox2D(textVerts, nameBox, cellHeight, node.m_name, Rgba8::WHITE, 1.f, Vec2(0.f, 0.5f), TextBoxMode::SHRINK_TO_FIT);
+
+		float barMinX = bounds.m_mins.x + nameWidth;
+		float averageFraction = ClampZeroToOne(stats.m_averageMilliseconds / m_config.m_frameBudgetMilliseconds);
+		float maxFraction = ClampZeroToOne(stats.m_maxMilliseconds / m_config.m_frameBudgetMilliseconds);
+		Rgba8 barColor = averageFraction < 0.25f ? Rgba8::GREEN : (averageFraction < 0.5f ? Rgba8::YELLOW : Rgba8::RED);
+		AddVertsForAABB2D(boxVerts, AABB2(Vec2(barMinX, rowMinY + cellHeight * 0.2f), Vec2(barMinX + barWidth * averageFraction, rowMaxY - cellHeight * 0.2f)), barColor);
+		AddVertsForAABB2D(boxVerts, AABB2(Vec2(barMinX + barWidth * maxFraction - 1.f, rowMinY), Vec2(barMinX + barWidth * maxFraction, rowMaxY)), Rgba8::WHITE);
+
+		std::string statsText = Stringf("avg=%6.2fms max=%6.2fms p99=%6.2fms calls=%5.1f", stats.m_averageMilliseconds, stats.m_maxMilliseconds, stats.m_p99Milliseconds,
+			static_cast<float>(stats.m_numberCalls) / static_cast<float>(stats.m_numberFrames));
+		AABB2 statsBox(Vec2(barMinX + barWidth + cellHeight, rowMinY), Vec2(bounds.m_maxs.x, rowMaxY));
+		font->AddVertsForTextInBox2D(textVerts, statsBox, cellHeight, statsText, Rgba8::WHITE, 1.f, Vec2(0.f, 0.5f), TextBoxMode::SHRINK_TO_FIT);
+	}
+	m_threadBuffersMutex.unlock();
+
+	m_config.m_renderer->BindTexture(nullptr);
+	m_config.m_renderer->DrawVertexArray(int(boxVerts.size()), boxVerts.data());
+	m_config.m_renderer->BindTexture(&font->GetTexture());
+	m_config.m_renderer->DrawVertexArray(int(textVerts.size()), textVerts.data());
+}
+
+
+uint64_t Profiler::GetTicks()
+{
+	return __rdtsc();
+}
+
+
+char const* Profiler::InternScopeName(std::string const& name)
+{
+	// set nodes never move, so the pointers stay good as more names are added
+	static std::mutex s_internedNamesMutex;
+	static std::set<std::string> s_internedNames;
+	s_internedNamesMutex.lock();
+	char const* internedName = s_internedNames.insert(name).first->c_str();
+	s_internedNamesMutex.unlock();
+	return internedName;
+}
+
+
+ProfilerThreadBuffer* Profiler::GetCurrentThreadBuffer()
+{
+	if (t_profilerThreadBufferID == m_profilerID)
+	{
+		return t_profilerThreadBuffer;
+	}
+
+	m_threadBuffersMutex.lock();
+	ProfilerThreadBuffer* threadBuffer = new ProfilerThreadBuffer((int)m_threadBuffers.size(), m_config.m_eventsPerThread);
+	m_threadBuffers.push_back(threadBuffer);
+	t_profilerThreadBuffer = threadBuffer;
+	t_profilerThreadBufferID = m_profilerID;
+	m_threadBuffersMutex.unlock();
+	return threadBuffer;
+}
+
+
+void Profiler::DrainThreadBuffer(ProfilerThreadBuffer& threadBuffer)
+{
+	if (threadBuffer.m_rootNodeIndex < 0)
+	{
+		threadBuffer.m_rootNodeIndex = FindOrAddChildNode(-1, nullptr);
+		m_nodes[threadBuffer.m_rootNodeIndex].m_threadIndex = threadBuffer.m_threadIndex;
+	}
+
+	uint32_t readIndex = threadBuffer.m_readIndex.load(std::memory_order_relaxed);
+	uint32_t writeIndex = threadBuffer.m_writeIndex.load(std::memory_order_acquire);
+	for (; readIndex != writeIndex; readIndex++)
+	{
+		ProfileEvent const& profileEvent = threadBuffer.m_events[readIndex & threadBuffer.m_eventMask];
+		if (profileEvent.m_type == PROFILE_EVENT_BEGIN)
+		{
+			int parentIndex = threadBuffer.m_openNodes.empty() ? threadBuffer.m_rootNodeIndex : threadBuffer.m_openNodes.back();
+			threadBuffer.m_openNodes.push_back(FindOrAddChildNode(parentIndex, profileEvent.m_name));
+			threadBuffer.m_openTicks.push_back(profileEvent.m_ticks);
+			continue;
+		}
+
+		// scopes still open from before a ShutDown have no begin here
+		if (threadBuffer.m_openNodes.empty())
+		{
+			continue;
+		}
+		int nodeIndex = threadBuffer.m_openNodes.back();
+		uint64_t beginTicks = threadBuffer.m_openTicks.back();
+		threadBuffer.m_openNodes.pop_back();
+		threadBuffer.m_openTicks.pop_back();
+
+		ProfileNode& node = m_nodes[nodeIndex];
+		node.m_frameTicks += profileEvent.m_ticks - beginTicks;
+		node.m_frameCalls++;
+
+		if (m_numberCaptureFramesLeft > 0)
+		{
+			CapturedScope capturedScope;
+			capturedScope.m_name = node.m_name;
+			capturedScope.m_threadIndex = threadBuffer.m_threadIndex;
+			capturedScope.m_beginTicks = beginTicks;
+			capturedScope.m_endTicks = profileEvent.m_ticks;
+			m_capturedScopes.push_back(capturedScope);
+		}
+	}
+	threadBuffer.m_readIndex.store(readIndex, std::memory_order_release);
+}
+
+
+int Profiler::FindOrAddChildNode(int parentIndex, char const* name)
+{
+	if (parentIndex >= 0)
+	{
+		std::vector<int> const& childIndices = m_nodes[parentIndex].m_childIndices;
+		for (int childIndex = 0; childIndex < (int)childIndices.size(); childIndex++)
+		{
+			char const* childName = m_nodes[childIndices[childIndex]].m_name;
+			if (childName == name || strcmp(childName, name) == 0)
+			{
+				return childIndices[childIndex];
+			}
+		}
+	}
+
+	ProfileNode node;
+	node.m_name = name;
+	node.m_parentIndex = parentIndex;
+	node.m_historyMilliseconds.resize(m_config.m_historyFrames, 0.f);
+	node.m_historyCalls.resize(m_config.m_historyFrames, 0);
+	if (parentIndex >= 0)
+	{
+		node.m_depth = m_nodes[parentIndex].m_depth + 1;
+		node.m_threadIndex = m_nodes[parentIndex].m_threadIndex;
+	}
+
+	int nodeIndex = (int)m_nodes.size();
+	m_nodes.push_back(node);
+	if (parentIndex >= 0)
+	{
+		m_nodes[parentIndex].m_childIndices.push_back(nodeIndex);
+	}
+	return nodeIndex;
+}
+
+
+void Profiler::CloseFrameHistory()
+{
+	for (int nodeIndex = 0; nodeIndex < (int)m_nodes.size(); nodeIndex++)
+	{
+		ProfileNode& node = m_nodes[nodeIndex];
+		node.m_historyMilliseconds[m_historyIndex] = static_cast<float>(TicksToMilliseconds(node.m_frameTicks));
+		node.m_historyCalls[m_historyIndex] = node.m_frameCalls;
+		node.m_frameTicks = 0;
+		node.m_frameCalls = 0;
+	}
+
+	m_historyIndex = (m_historyIndex + 1) % m_config.m_historyFrames;
+	if (m_numberHistoryFrames < m_config.m_historyFrames)
+	{
+		m_numberHistoryFrames++;
+	}
+}
+
+
+void Profiler::UpdateTickFrequency()
+{
+	uint64_t elapsedTicks = GetTicks() - m_startupTicks;
+	double elapsedSeconds = GetCurrentTimeSeconds() - m_startupSeconds;
+	if (elapsedTicks > 0 && elapsedSeconds > 0.0)
+	{
+		m_millisecondsPerTick = elapsedSeconds * 1000.0 / static_cast<double>(elapsedTicks);
+	}
+}
+
+
+double Profiler::TicksToMilliseconds(uint64_t ticks) const
+{
+	return static_cast<double>(ticks) * m_millisecondsPerTick;
+}
+
+
+ProfileScopeStats Profiler::GetNodeStats(std::vector<int> const& nodeIndices) const
+{
+	ProfileScopeStats stats;
+	if (nodeIndices.empty())
+	{
+		return stats;
+	}
+
+	std::vector<float> frameMilliseconds;
+	frameMilliseconds.reserve(m_numberHistoryFrames);
+	for (int frameIndex = 0; frameIndex < m_numberHistoryFrames; frameIndex++)
+	{
+		float milliseconds = 0.f;
+		int numCalls = 0;
+		for (int nodeIndex = 0; nodeIndex < (int)nodeIndices.size(); nodeIndex++)
+		{
+			ProfileNode const& node = m_nodes[nodeIndices[nodeIndex]];
+			milliseconds += node.m_historyMilliseconds[frameIndex];
+			numCalls += node.m_historyCalls[frameIndex];
+		}
+		if (numCalls > 0)
+		{
+			frameMilliseconds.push_back(milliseconds);
+			stats.m_numberCalls += numCalls;
+		}
+	}
+
+	stats.m_numberFrames = (int)frameMilliseconds.size();
+	if (stats.m_numberFrames == 0)
+	{
+		return stats;
+	}
+
+	std::sort(frameMilliseconds.begin(), frameMilliseconds.end());
+	float totalMilliseconds = 0.f;
+	for (int frameIndex = 0; frameIndex < stats.m_numberFrames; frameIndex++)
+	{
+		totalMilliseconds += frameMilliseconds[frameIndex];
+	}
+	stats.m_minMilliseconds = frameMilliseconds.front();
+	stats.m_maxMilliseconds = frameMilliseconds.back();
+	stats.m_averageMilliseconds = totalMilliseconds / static_cast<float>(stats.m_numberFrames);
+	stats.m_p99Milliseconds = frameMilliseconds[(stats.m_numberFrames - 1) * 99 / 100];
+	return stats;
+}
+
+
+void Profiler::AddNodeRowsForRender(int nodeIndex, std::vector<int>& outNodeIndices) const
+{
+	ProfileNode const& node = m_nodes[nodeIndex];
+	if (node.m_name)
+	{
+		std::vector<int> nodeIndices;
+		nodeIndices.push_back(nodeIndex);
+		if (GetNodeStats(nodeIndices).m_numberFrames == 0)
+		{
+			return;
+		}
+	}
+	else if (node.m_childIndices.empty())
+	{
+		return;
+	}
+
+	outNodeIndices.push_back(nodeIndex);
+	for (int childIndex = 0; childIndex < (int)node.m_childIndices.size(); childIndex++)
+	{
+		AddNodeRowsForRender(node.m_childIndices[childIndex], outNodeIndices);
+	}
+}
+
+
+bool Profiler::WriteCapture() const
+{
+	uint64_t baseTicks = 0;
+	for (int scopeIndex = 0; scopeIndex < (int)m_capturedScopes.size(); scopeIndex++)
+	{
+		if (scopeIndex == 0 || m_capturedScopes[scopeIndex].m_beginTicks < baseTicks)
+		{
+			baseTicks = m_capturedScopes[scopeIndex].m_beginTicks;
+		}
+	}
+
+	// same layout as the job trace, complete ("X") events in microseconds and one named track per thread
+	std::string json = "{\"traceEvents\":[\n";
+	m_threadBuffersMutex.lock();
+	for (int bufferIndex = 0; bufferIndex < (int)m_threadBuffers.size(); bufferIndex++)
+	{
+		ProfilerThreadBuffer const* threadBuffer = m_threadBuffers[bufferIndex];
+		json += Stringf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", bufferIndex == 0 ? "" : ",\n", threadBuffer->m_threadIndex, threadBuffer->m_threadName.c_str());
+	}
+	m_threadBuffersMutex.unlock();
+
+	for (int scopeIndex = 0; scopeIndex < (int)m_capturedScopes.size(); scopeIndex++)
+	{
+		CapturedScope const& capturedScope = m_capturedScopes[scopeIndex];
+		double startMicroseconds = TicksToMilliseconds(capturedScope.m_beginTicks - baseTicks) * 1000.0;
+		double durationMicroseconds = TicksToMilliseconds(capturedScope.m_endTicks - capturedScope.m_beginTicks) * 1000.0;
+		json += Stringf(",\n{\"name\":\"%s\",\"cat\":\"scope\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+			capturedScope.m_name, capturedScope.m_threadIndex, startMicroseconds, durationMicroseconds);
+	}
+	json += "\n]}\n";
+
+	std::vector<uint8_t> buffer(json.begin(), json.end());
+	return FileWriteFromBuffer(buffer, m_captureFilename) == 0;
+}
+
+
+bool Profiler::Command_Profiler(EventArgs& args)
+{
+	if (!g_theProfiler) return false;
+
+	// toggles without an argument
+	g_theProfiler->SetVisible(args.GetParsedValue("visible", !g_theProfiler->IsVisible()));
+	return false;
+}
+
+
+bool Profiler::Command_ProfilerCapture(EventArgs& args)
+{
+	if (!g_theProfiler) return false;
+
+	int numFrames = args.GetParsedValue("frames", 60);
+	std::string filename = args.GetValue("file", "ProfileCapture.json");
+	g_theProfiler->StartCapture(numFrames, filename);
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("Capturing %d frames to %s", numFrames > 0 ? numFrames : 1, filename.c_str()));
+	return false;
+}
+
+
+bool Profiler::Command_ProfilerReset(EventArgs& args)
+{
+	UNUSED(args)
+	if (!g_theProfiler) return false;
+
+	g_theProfiler->ResetHistory();
+	return false;
+}
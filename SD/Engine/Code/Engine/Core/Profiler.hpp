@@ -0,0 +1,190 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/AABB2.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Renderer;
+class Profiler;
+
+extern Profiler* g_theProfiler;
+
+// PROFILE_SCOPE("name") times the rest of the enclosing block, the events keep the pointer so name has to be a string literal
+// and the "" concatenation refuses anything else, a runtime name goes through Profiler::InternScopeName first
+#define PROFILE_SCOPE_CONCAT_INNER(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_SCOPE_CONCAT(profileScope_, __LINE__)(name "")
+
+
+struct ProfilerConfig
+{
+	Renderer* m_renderer = nullptr;
+	// per thread, rounded up to a power of two
+	int m_eventsPerThread = 65536;
+	int m_historyFrames = 240;
+	// the bar view draws a full bar for a scope that takes this long per frame
+	float m_frameBudgetMilliseconds = 16.67f;
+	bool m_startVisible = false;
+};
+
+
+enum ProfileEventType : uint8_t
+{
+	PROFILE_EVENT_BEGIN,
+	PROFILE_EVENT_END
+};
+
+
+struct ProfileEvent
+{
+	char const* m_name = nullptr;
+	uint64_t m_ticks = 0;
+	ProfileEventType m_type = PROFILE_EVENT_BEGIN;
+};
+
+
+// single producer ring buffer, only its own thread writes and only the main thread reads in BeginFrame
+class ProfilerThreadBuffer
+{
+	friend class Profiler;
+	friend class ProfileScope;
+
+private:
+	ProfilerThreadBuffer(int threadIndex, int numEvents);
+
+	bool PushBegin(char const* name);
+	void PushEnd();
+
+private:
+	int m_threadIndex = 0;
+	std::string m_threadName;
+	std::vector<ProfileEvent> m_events;
+	uint32_t m_eventMask = 0;
+	std::atomic<uint32_t> m_writeIndex = 0;
+	std::atomic<uint32_t> m_readIndex = 0;
+	// producer side, every open scope keeps a slot free for its end event
+	int m_numberOpenScopes = 0;
+	std::atomic<int> m_numberDroppedScopes = 0;
+
+	// consumer side, node and begin ticks of the scopes still open on this thread
+	std::vector<int> m_openNodes;
+	std::vector<uint64_t> m_openTicks;
+	int m_rootNodeIndex = -1;
+};
+
+
+struct ProfileScopeStats
+{
+	// frames in the history that ran the scope at least once, the times below are per frame totals over those
+	int m_numberFrames = 0;
+	int m_numberCalls = 0;
+	float m_minMilliseconds = 0.f;
+	float m_averageMilliseconds = 0.f;
+	float m_maxMilliseconds = 0.f;
+	float m_p99Milliseconds = 0.f;
+};
+
+
+class ProfileScope
+{
+public:
+	explicit ProfileScope(char const* name);
+	~ProfileScope();
+	ProfileScope(ProfileScope const& copy) = delete;
+
+private:
+	ProfilerThreadBuffer* m_threadBuffer = nullptr;
+};
+
+
+class Profiler
+{
+	friend class ProfileScope;
+
+	struct ProfileNode
+	{
+		char const* m_name = nullptr;
+		int m_parentIndex = -1;
+		int m_depth = 0;
+		int m_threadIndex = 0;
+		std::vector<int> m_childIndices;
+		uint64_t m_frameTicks = 0;
+		int m_frameCalls = 0;
+		std::vector<float> m_historyMilliseconds;
+		std::vector<int> m_historyCalls;
+	};
+
+	struct CapturedScope
+	{
+		char const* m_name = nullptr;
+		int m_threadIndex = 0;
+		uint64_t m_beginTicks = 0;
+		uint64_t m_endTicks = 0;
+	};
+
+public:
+	Profiler(ProfilerConfig const& config);
+	~Profiler();
+	void Startup();
+	void BeginFrame();
+	void EndFrame();
+	void ShutDown();
+
+	// names the calling thread in the bar view and in captures
+	void SetCurrentThreadName(std::string const& name);
+
+	// sums every node with this name across threads and call sites
+	ProfileScopeStats GetScopeStats(char const* name) const;
+	void ResetHistory();
+
+	// records every closed scope for the next numFrames frames and writes them as a Chrome trace
+	void StartCapture(int numFrames, std::string const& filename);
+	bool IsCapturing() const;
+
+	void SetVisible(bool isVisible);
+	bool IsVisible() const;
+	void Render(AABB2 const& bounds) const;
+
+	static uint64_t GetTicks();
+	// copy of name that lives until the program exits, same name same pointer, takes a lock so keep it off per frame paths
+	static char const* InternScopeName(std::string const& name);
+
+	static bool Command_Profiler(EventArgs& args);
+	static bool Command_ProfilerCapture(EventArgs& args);
+	static bool Command_ProfilerReset(EventArgs& args);
+
+private:
+	ProfilerThreadBuffer* GetCurrentThreadBuffer();
+	void DrainThreadBuffer(ProfilerThreadBuffer& threadBuffer);
+	int FindOrAddChildNode(int parentIndex, char const* name);
+	void CloseFrameHistory();
+	void UpdateTickFrequency();
+	double TicksToMilliseconds(uint64_t ticks) const;
+	ProfileScopeStats GetNodeStats(std::vector<int> const& nodeIndices) const;
+	void AddNodeRowsForRender(int nodeIndex, std::vector<int>& outNodeIndices) const;
+	bool WriteCapture() const;
+
+private:
+	ProfilerConfig m_config;
+	int m_profilerID = 0;
+	bool m_isVisible = false;
+
+	std::vector<ProfilerThreadBuffer*> m_threadBuffers;
+	mutable std::mutex m_threadBuffersMutex;
+
+	std::vector<ProfileNode> m_nodes;
+	int m_historyIndex = 0;
+	int m_numberHistoryFrames = 0;
+
+	uint64_t m_startupTicks = 0;
+	double m_startupSeconds = 0.0;
+	double m_millisecondsPerTick = 0.0;
+
+	std::vector<CapturedScope> m_capturedScopes;
+	std::string m_captureFilename;
+	int m_numberCaptureFramesLeft = 0;
+};
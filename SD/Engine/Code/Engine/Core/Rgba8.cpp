@@ -22,23 +22,24 @@ Rgba8 const Rgba8::BLUE(0, 0, 255, 255);
 Rgba8 const Rgba8::YELLOW(255, 255, 0, 255);
 
 
-void Rgba8::SetFromText(std::string const& text)
+void Rgba8::SetFromText(StringView const& text)
 {
-	Strings tokens = SplitStringOnDelimiter(text, ',');
+	StringView tokens[4];
+	int numTokens = SplitStringOnDelimiter(text, ',', tokens, 4);
 
-	if (tokens.size() == 3)
+	if (numTokens == 3)
 	{
-		r = static_cast<unsigned char>(atoi(tokens[0].c_str()));
-		g = static_cast<unsigned char>(atoi(tokens[1].c_str()));
-		b = static_cast<unsigned char>(atoi(tokens[2].c_str()));
+		r = static_cast<unsigned char>(ParseIntFromText(tokens[0]));
+		g = static_cast<unsigned char>(ParseIntFromText(tokens[1]));
+		b = static_cast<unsigned char>(ParseIntFromText(tokens[2]));
 		a = 255;
 	} 
-	else if (tokens.size() == 4) 
+	else if (numTokens == 4) 
 	{ 
-		r = static_cast<unsigned char>(atoi(tokens[0].c_str()));
-		g = static_cast<unsigned char>(atoi(tokens[1].c_str()));
-		b = static_cast<unsigned char>(atoi(tokens[2].c_str()));
-		a = static_cast<unsigned char>(atoi(tokens[3].c_str()));
+		r = static_cast<unsigned char>(ParseIntFromText(tokens[0]));
+		g = static_cast<unsigned char>(ParseIntFromText(tokens[1]));
+		b = static_cast<unsigned char>(ParseIntFromText(tokens[2]));
+		a = static_cast<unsigned char>(ParseIntFromText(tokens[3]));
 	}
 	else
 	{
@@ -1,5 +1,5 @@
 #pragma once
-#include <string>
+#include "Engine/Core/StringUtils.hpp"
 
 struct Rgba8
 {
@@ -26,7 +26,7 @@ public:
 	static Rgba8 const YELLOW;
 
 
-	void SetFromText(std::string const& text);
+	void SetFromText(StringView const& text);
 	void GetAsFloats(float* colorAsFloats);
 	void ConvertFromHexString(std::string const& colorString);
 
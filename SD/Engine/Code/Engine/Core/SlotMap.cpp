@@ -0,0 +1,50 @@
+#include "Engine/Core/SlotMap.hpp"
+
+SlotHandle const SlotHandle::INVALID;
+
+
+SlotHandle::SlotHandle()
+{
+}
+
+
+SlotHandle::SlotHandle(int index, int generation)
+{
+	m_data = ((unsigned int)index << 16) | ((unsigned int)generation & 0x0000ffff);
+}
+
+
+void SlotHandle::Invalidate()
+{
+	*this = INVALID;
+}
+
+
+bool SlotHandle::IsValid() const
+{
+	return *this != INVALID;
+}
+
+
+int SlotHandle::GetIndex() const
+{
+	return (int)(m_data >> 16);
+}
+
+
+int SlotHandle::GetGeneration() const
+{
+	return (int)(m_data & 0x0000ffff);
+}
+
+
+bool SlotHandle::operator==(SlotHandle const& other) const
+{
+	return m_data == other.m_data;
+}
+
+
+bool SlotHandle::operator!=(SlotHandle const& other) const
+{
+	return m_data != other.m_data;
+}
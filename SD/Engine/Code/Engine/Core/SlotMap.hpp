@@ -0,0 +1,194 @@
+#pragma once
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+// 16 bit slot index over a 16 bit generation, a handle goes stale as soon as its slot is freed
+struct SlotHandle
+{
+public:
+	SlotHandle();
+	SlotHandle(int index, int generation);
+
+	void Invalidate();
+	bool IsValid() const;
+	int GetIndex() const;
+	int GetGeneration() const;
+	bool operator==(SlotHandle const& other) const;
+	bool operator!=(SlotHandle const& other) const;
+
+	static const SlotHandle INVALID;
+
+private:
+	unsigned int m_data = 0xffffffff;
+};
+
+// the all ones index is what INVALID is made of
+constexpr int SLOT_MAP_MAX_SLOTS = 0x0000ffff;
+
+
+// objects live in fixed size pages that never move, so raw pointers stay good until Remove,
+// freed slots are reused most recent first and bump their generation so old handles miss
+template <typename T, int SLOTS_PER_PAGE = 64>
+class SlotMap
+{
+	static_assert(alignof(T) <= alignof(std::max_align_t), "SlotMap pages only guarantee default new alignment");
+
+public:
+	class Iterator
+	{
+	public:
+		Iterator(SlotMap const* slotMap, int slotIndex)
+			: m_slotMap(slotMap)
+			, m_slotIndex(slotIndex)
+		{
+			SkipDeadSlots();
+		}
+
+		T& operator*() const					{ return *m_slotMap->GetSlotMemory(m_slotIndex); }
+		T* operator->() const					{ return m_slotMap->GetSlotMemory(m_slotIndex); }
+		SlotHandle GetHandle() const			{ return m_slotMap->GetHandleAtSlot(m_slotIndex); }
+		bool operator!=(Iterator const& other) const	{ return m_slotIndex != other.m_slotIndex; }
+
+		Iterator& operator++()
+		{
+			m_slotIndex++;
+			SkipDeadSlots();
+			return *this;
+		}
+
+	private:
+		void SkipDeadSlots()
+		{
+			int slotCount = m_slotMap->GetSlotCount();
+			while (m_slotIndex < slotCount && !m_slotMap->m_isAlive[m_slotIndex])
+			{
+				m_slotIndex++;
+			}
+		}
+
+	private:
+		SlotMap const* m_slotMap = nullptr;
+		int m_slotIndex = 0;
+	};
+
+public:
+	SlotMap() = default;
+	SlotMap(SlotMap const& copy) = delete;
+	SlotMap& operator=(SlotMap const& copy) = delete;
+
+	~SlotMap()
+	{
+		Clear();
+		for (int pageIndex = 0; pageIndex < (int)m_pages.size(); pageIndex++)
+		{
+			delete[] m_pages[pageIndex];
+		}
+		m_pages.clear();
+	}
+
+	template <typename... Args>
+	SlotHandle Emplace(Args&&... args)
+	{
+		int slotIndex = 0;
+		if (!m_freeSlots.empty())
+		{
+			slotIndex = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else
+		{
+			slotIndex = (int)m_generations.size();
+			if (slotIndex >= SLOT_MAP_MAX_SLOTS)
+			{
+				ERROR_AND_DIE("SlotMap exceeded its maximum number of slots");
+			}
+			if (slotIndex >= (int)m_pages.size() * SLOTS_PER_PAGE)
+			{
+				m_pages.push_back(new unsigned char[sizeof(T) * SLOTS_PER_PAGE]);
+			}
+			m_generations.push_back(0);
+			m_isAlive.push_back(0);
+		}
+
+		// the slot is claimed before construction so a constructor that spawns more objects gets a different one
+		new (GetSlotMemory(slotIndex)) T(std::forward<Args>(args)...);
+		m_isAlive[slotIndex] = 1;
+		m_liveCount++;
+		return SlotHandle(slotIndex, m_generations[slotIndex]);
+	}
+
+	bool Remove(SlotHandle handle)
+	{
+		T* object = Get(handle);
+		if (!object) return false;
+
+		int slotIndex = handle.GetIndex();
+		object->~T();
+		m_isAlive[slotIndex] = 0;
+		m_generations[slotIndex] = (uint16_t)(m_generations[slotIndex] + 1);
+		m_freeSlots.push_back(slotIndex);
+		m_liveCount--;
+		return true;
+	}
+
+	void Clear()
+	{
+		for (int slotIndex = 0; slotIndex < GetSlotCount(); slotIndex++)
+		{
+			if (m_isAlive[slotIndex])
+			{
+				Remove(GetHandleAtSlot(slotIndex));
+			}
+		}
+	}
+
+	T* Get(SlotHandle handle) const
+	{
+		if (!handle.IsValid()) return nullptr;
+
+		int slotIndex = handle.GetIndex();
+		if (slotIndex >= GetSlotCount()) return nullptr;
+		if (!m_isAlive[slotIndex] || m_generations[slotIndex] != handle.GetGeneration()) return nullptr;
+
+		return GetSlotMemory(slotIndex);
+	}
+
+	bool IsAlive(SlotHandle handle) const	{ return Get(handle) != nullptr; }
+	int GetLiveCount() const				{ return m_liveCount; }
+
+	// for index loops, every slot ever handed out is counted and dead ones come back null
+	int GetSlotCount() const				{ return (int)m_generations.size(); }
+
+	T* GetAtSlot(int slotIndex) const
+	{
+		return m_isAlive[slotIndex] ? GetSlotMemory(slotIndex) : nullptr;
+	}
+
+	SlotHandle GetHandleAtSlot(int slotIndex) const
+	{
+		return m_isAlive[slotIndex] ? SlotHandle(slotIndex, m_generations[slotIndex]) : SlotHandle::INVALID;
+	}
+
+	Iterator begin() const					{ return Iterator(this, 0); }
+	Iterator end() const					{ return Iterator(this, GetSlotCount()); }
+
+private:
+	T* GetSlotMemory(int slotIndex) const
+	{
+		unsigned char* page = m_pages[slotIndex / SLOTS_PER_PAGE];
+		return reinterpret_cast<T*>(page + (slotIndex % SLOTS_PER_PAGE) * sizeof(T));
+	}
+
+private:
+	std::vector<unsigned char*> m_pages;
+	// per slot bookkeeping kept apart from the objects so skipping dead slots stays in a few cache lines
+	std::vector<uint16_t> m_generations;
+	std::vector<uint8_t> m_isAlive;
+	std::vector<int> m_freeSlots;
+	int m_liveCount = 0;
+};
@@ -1,5 +1,9 @@
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
 #include <stdarg.h>
+#include <string.h>
 
 
 //-----------------------------------------------------------------------------------------------
@@ -163,3 +167,261 @@ bool ContainsSubstring(const std::string& inputString, const std::string& compar
 }
 
 
+StringView::StringView(char const* text)
+	: m_data(text)
+	, m_length((int)strlen(text))
+{
+}
+
+
+StringView::StringView(char const* text, int length)
+	: m_data(text)
+	, m_length(length)
+{
+}
+
+
+StringView::StringView(std::string const& text)
+	: m_data(text.data())
+	, m_length((int)text.size())
+{
+}
+
+
+bool StringView::operator==(StringView const& compare) const
+{
+	return m_length == compare.m_length && memcmp(m_data, compare.m_data, m_length) == 0;
+}
+
+
+bool StringView::operator!=(StringView const& compare) const
+{
+	return !(*this == compare);
+}
+
+
+StringView StringView::GetSubView(int startIndex, int length) const
+{
+	if (startIndex > m_length) startIndex = m_length;
+	if (length > m_length - startIndex) length = m_length - startIndex;
+	return StringView(m_data + startIndex, length);
+}
+
+
+static bool IsWhitespace(char character)
+{
+	return character == ' ' || character == '\t' || character == '\r' || character == '\n';
+}
+
+
+StringView StringView::GetTrimmed() const
+{
+	int startIndex = 0;
+	int endIndex = m_length;
+	while (startIndex < endIndex && IsWhitespace(m_data[startIndex]))
+	{
+		startIndex++;
+	}
+	while (endIndex > startIndex && IsWhitespace(m_data[endIndex - 1]))
+	{
+		endIndex--;
+	}
+	return StringView(m_data + startIndex, endIndex - startIndex);
+}
+
+
+std::string StringView::ToString() const
+{
+	return std::string(m_data, m_length);
+}
+
+
+StringTokenizer::StringTokenizer(StringView const& text, char delimiter)
+	: m_text(text)
+	, m_delimiter(delimiter)
+{
+}
+
+
+bool StringTokenizer::GetNextToken(StringView& outToken)
+{
+	while (m_currentIndex < m_text.m_length && m_text.m_data[m_currentIndex] == m_delimiter)
+	{
+		m_currentIndex++;
+	}
+	if (m_currentIndex == m_text.m_length) return false;
+
+	char const* tokenStart = m_text.m_data + m_currentIndex;
+	char const* delimiter = (char const*)memchr(tokenStart, m_delimiter, m_text.m_length - m_currentIndex);
+	int tokenLength = delimiter ? (int)(delimiter - tokenStart) : m_text.m_length - m_currentIndex;
+	outToken = StringView(tokenStart, tokenLength);
+	m_currentIndex += tokenLength;
+	return true;
+}
+
+
+StringView StringTokenizer::GetRemainingText() const
+{
+	return m_text.GetSubView(m_currentIndex, m_text.m_length - m_currentIndex);
+}
+
+
+int SplitStringOnDelimiter(StringView const& text, char delimiterToSplitOn, StringView* outTokens, int maxTokens)
+{
+	StringTokenizer tokenizer(text, delimiterToSplitOn);
+	StringView token;
+	int numTokens = 0;
+	while (tokenizer.GetNextToken(token))
+	{
+		if (numTokens < maxTokens)
+		{
+			outTokens[numTokens] = token;
+		}
+		numTokens++;
+	}
+	return numTokens;
+}
+
+
+bool ParseInt(StringView const& text, int& outValue)
+{
+	int charIndex = 0;
+	while (charIndex < text.m_length && IsWhitespace(text.m_data[charIndex]))
+	{
+		charIndex++;
+	}
+
+	bool isNegative = false;
+	if (charIndex < text.m_length && (text.m_data[charIndex] == '-' || text.m_data[charIndex] == '+'))
+	{
+		isNegative = text.m_data[charIndex] == '-';
+		charIndex++;
+	}
+
+	int firstDigitIndex = charIndex;
+	int64_t value = 0;
+	while (charIndex < text.m_length && text.m_data[charIndex] >= '0' && text.m_data[charIndex] <= '9')
+	{
+		value = value * 10 + (text.m_data[charIndex] - '0');
+		if (value > 0xffffffffll) value = 0xffffffffll;
+		charIndex++;
+	}
+	if (charIndex == firstDigitIndex) return false;
+
+	outValue = (int)(isNegative ? -value : value);
+	return true;
+}
+
+
+// longer numbers than this are cut off, far more digits than a float can hold
+constexpr int PARSE_FLOAT_MAX_CHARS = 63;
+
+bool ParseFloat(StringView const& text, float& outValue)
+{
+	// strtod needs a terminated string, the view is copied to the stack instead of into a std::string
+	char terminatedText[PARSE_FLOAT_MAX_CHARS + 1];
+	int length = text.m_length < PARSE_FLOAT_MAX_CHARS ? text.m_length : PARSE_FLOAT_MAX_CHARS;
+	memcpy(terminatedText, text.m_data, length);
+	terminatedText[length] = '\0';
+
+	char* parseEnd = nullptr;
+	// through double like atof, so ported parsers produce bit identical values
+	double value = strtod(terminatedText, &parseEnd);
+	if (parseEnd == terminatedText) return false;
+
+	outValue = static_cast<float>(value);
+	return true;
+}
+
+
+int ParseIntFromText(StringView const& text)
+{
+	int value = 0;
+	ParseInt(text, value);
+	return value;
+}
+
+
+float ParseFloatFromText(StringView const& text)
+{
+	float value = 0.f;
+	ParseFloat(text, value);
+	return value;
+}
+
+
+static std::string GenerateBenchmarkObjText(int numLines)
+{
+	std::string objText;
+	objText.reserve(numLines * 32);
+	for (int lineIndex = 0; lineIndex < numLines; lineIndex++)
+	{
+		switch (lineIndex % 4)
+		{
+			case 0:		objText += Stringf("v %.6f %.6f %.6f\n", lineIndex * 0.001f, -lineIndex * 0.002f, lineIndex * 0.5f);	break;
+			case 1:		objText += Stringf("vt %.6f %.6f\n", (lineIndex % 97) / 97.f, (lineIndex % 89) / 89.f);					break;
+			case 2:		objText += Stringf("vn %.6f %.6f %.6f\n", 0.f, 0.70710678f, -0.70710678f);								break;
+			default:	objText += Stringf("f %d/%d/%d %d/%d/%d %d/%d/%d\n", lineIndex, lineIndex, lineIndex, lineIndex + 1, lineIndex + 2, lineIndex + 3, lineIndex + 4, lineIndex + 5, lineIndex + 6); break;
+		}
+	}
+	return objText;
+}
+
+
+bool Command_BenchmarkStringParsing(EventArgs& args)
+{
+	int numLines = args.GetParsedValue("lines", 200000);
+	if (numLines <= 0) return false;
+
+	std::string objText = GenerateBenchmarkObjText(numLines);
+
+	// the way the OBJ loader used to read a file, a string per line and per token
+	double splitStartTime = GetCurrentTimeSeconds();
+	double splitChecksum = 0.0;
+	Strings lines = SplitStringOnDelimiter(objText, '\n');
+	for (std::string const& line : lines)
+	{
+		Strings tokens = SplitStringOnDelimiter(line, ' ');
+		for (int tokenIndex = 1; tokenIndex < (int)tokens.size(); tokenIndex++)
+		{
+			Strings indices = SplitStringOnDelimiter(tokens[tokenIndex], '/');
+			for (int index = 0; index < (int)indices.size(); index++)
+			{
+				splitChecksum += static_cast<float>(atof(indices[index].c_str()));
+			}
+		}
+	}
+	double splitSeconds = GetCurrentTimeSeconds() - splitStartTime;
+
+	double viewStartTime = GetCurrentTimeSeconds();
+	double viewChecksum = 0.0;
+	StringTokenizer lineTokenizer(objText, '\n');
+	StringView line;
+	while (lineTokenizer.GetNextToken(line))
+	{
+		StringTokenizer tokenizer(line, ' ');
+		StringView token;
+		tokenizer.GetNextToken(token);
+		while (tokenizer.GetNextToken(token))
+		{
+			StringTokenizer indexTokenizer(token, '/');
+			StringView index;
+			while (indexTokenizer.GetNextToken(index))
+			{
+				float value = 0.f;
+				ParseFloat(index, value);
+				viewChecksum += value;
+			}
+		}
+	}
+	double viewSeconds = GetCurrentTimeSeconds() - viewStartTime;
+
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, Stringf("## String parsing benchmark, %d OBJ lines ##", numLines));
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("SplitStringOnDelimiter  %8.1fns/line", splitSeconds * 1e9 / numLines));
+	g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("StringTokenizer         %8.1fns/line  %.1fx", viewSeconds * 1e9 / numLines, viewSeconds > 0.0 ? splitSeconds / viewSeconds : 0.0));
+	if (splitChecksum != viewChecksum)
+	{
+		g_theDevConsole->AddLine(DevConsole::INFO_ERROR, Stringf("Checksums differ, %f vs %f", splitChecksum, viewChecksum));
+	}
+	return true;
+}
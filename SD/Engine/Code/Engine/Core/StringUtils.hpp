@@ -14,6 +14,53 @@ enum class StringAlignment
 //-----------------------------------------------------------------------------------------------
 typedef std::vector<std::string> Strings;
 
+class NamedProperties;
+
+
+// points into text owned by someone else, so it must not outlive the string or file it was made from
+struct StringView
+{
+	StringView() {}
+	StringView(char const* text);
+	StringView(char const* text, int length);
+	StringView(std::string const& text);
+
+	char const* GetData() const					{ return m_data; }
+	int GetLength() const						{ return m_length; }
+	bool IsEmpty() const						{ return m_length == 0; }
+	char operator[](int index) const			{ return m_data[index]; }
+	char const* begin() const					{ return m_data; }
+	char const* end() const						{ return m_data + m_length; }
+
+	bool operator==(StringView const& compare) const;
+	bool operator!=(StringView const& compare) const;
+
+	StringView GetSubView(int startIndex, int length) const;
+	// drops spaces, tabs and line breaks from both ends
+	StringView GetTrimmed() const;
+	std::string ToString() const;
+
+	char const* m_data = "";
+	int m_length = 0;
+};
+
+
+// hands out the tokens between delimiters one at a time without copying, empty tokens are skipped like SplitStringOnDelimiter
+class StringTokenizer
+{
+public:
+	StringTokenizer(StringView const& text, char delimiter);
+
+	bool GetNextToken(StringView& outToken);
+	StringView GetRemainingText() const;
+
+private:
+	StringView m_text;
+	char m_delimiter = ' ';
+	int m_currentIndex = 0;
+};
+
+
 const std::string Stringf( char const* format, ... );
 const std::string Stringf( int maxLength, char const* format, ... );
 
@@ -24,4 +71,18 @@ Strings SplitStringOnFirstDelimiter(std::string const& originalString, char deli
 void ParseConsoleCommand(std::string const& command, Strings& tokens); 
 bool ContainsSubstring(const std::string& inputString, const std::string& compareString);
 
+// fills up to maxTokens views and returns how many tokens the text has in total, so a count mismatch can be caught
+int SplitStringOnDelimiter(StringView const& text, char delimiterToSplitOn, StringView* outTokens, int maxTokens);
+
+// like atoi and atof they read the number at the start of the text and ignore what follows it,
+// false and outValue untouched when there is no number there, nothing is allocated
+bool ParseInt(StringView const& text, int& outValue);
+bool ParseFloat(StringView const& text, float& outValue);
+// 0 when there is no number, drop in for atoi and atof on a token
+int ParseIntFromText(StringView const& text);
+float ParseFloatFromText(StringView const& text);
+
+// benchmarkStringParsing lines=200000, times SplitStringOnDelimiter and atof against the tokenizer on OBJ style lines
+bool Command_BenchmarkStringParsing(NamedProperties& args);
+
 
@@ -1,25 +1,48 @@
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
+#include "Engine/Core/JobSystem.hpp"
 
 constexpr int NUM_CIRCLE_TRIANGLES = 16;
+// the per-entity arrays of the games stay on the calling thread, only large meshes are split across the workers
+constexpr int PARALLEL_TRANSFORM_MIN_VERTS = 16 * 1024;
+constexpr int PARALLEL_TRANSFORM_GRAIN_SIZE = 4 * 1024;
 
 void TransformVertexArrayXY3D(int numberVerts, Vertex_PCU* verts, float scaleXY, float zRotationDegrees, Vec2 const& translationXY)
 {
-	for (int vertexIndex = 0; vertexIndex < numberVerts; vertexIndex++)
+	if (numberVerts < PARALLEL_TRANSFORM_MIN_VERTS || !g_theJobSystem)
 	{
-		Vertex_PCU& vertex = verts[vertexIndex];
-		TransformPositionXY3D( vertex.m_position, scaleXY, zRotationDegrees, translationXY);
+		for (int vertexIndex = 0; vertexIndex < numberVerts; vertexIndex++)
+		{
+			Vertex_PCU& vertex = verts[vertexIndex];
+			TransformPositionXY3D(vertex.m_position, scaleXY, zRotationDegrees, translationXY);
+		}
+		return;
 	}
+
+	g_theJobSystem->ParallelFor(0, numberVerts, PARALLEL_TRANSFORM_GRAIN_SIZE, [&](int vertexIndex)
+	{
+		TransformPositionXY3D(verts[vertexIndex].m_position, scaleXY, zRotationDegrees, translationXY);
+	});
 }
 
 
 void TransformVertexArrayXYZ3D(int numberVerts, Vertex_PCU* verts, Vec3 const& iBasis, Vec3 const& jBasis, Vec3 const& kBasis, Vec3 const& translationXYZ)
 {
-	for (int vertexIndex = 0; vertexIndex < numberVerts; vertexIndex++)
+	if (numberVerts < PARALLEL_TRANSFORM_MIN_VERTS || !g_theJobSystem)
 	{
-		Vertex_PCU& vertex = verts[vertexIndex];
-		TransformPositionXYZ3D(vertex.m_position, iBasis, jBasis, kBasis, translationXYZ);
+		for (int vertexIndex = 0; vertexIndex < numberVerts; vertexIndex++)
+		{
+			Vertex_PCU& vertex = verts[vertexIndex];
+			TransformPositionXYZ3D(vertex.m_position, iBasis, jBasis, kBasis, translationXYZ);
+		}
+		return;
 	}
+
+	g_theJobSystem->ParallelFor(0, numberVerts, PARALLEL_TRANSFORM_GRAIN_SIZE, [&](int vertexIndex)
+	{
+		TransformPositionXYZ3D(verts[vertexIndex].m_position, iBasis, jBasis, kBasis, translationXYZ);
+	});
 }
 
 
@@ -64,7 +87,8 @@ void AddVertsForDiscs2D(std::vector<Vertex_PCU>& verts, Vec2 const& center, floa
 }
 
 
-void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, AABB2 const& bounds, Rgba8 const& color, Vec2 const& uvMins, Vec2 const& uvMaxs)
+template <typename VertexArray>
+void AddVertsForAABB2D(VertexArray& verts, AABB2 const& bounds, Rgba8 const& color, Vec2 const& uvMins, Vec2 const& uvMaxs)
 {
 	Vec3 pos0(Vec2(bounds.m_mins.x, bounds.m_mins.y));
 	Vec3 pos1(Vec2(bounds.m_maxs.x, bounds.m_mins.y));
@@ -81,7 +105,8 @@ void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, AABB2 const& bounds, Rgba
 }
 
 
-void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, AABB2 const& bounds, Rgba8 const& color, AABB2 const& UVs)
+template <typename VertexArray>
+void AddVertsForAABB2D(VertexArray& verts, AABB2 const& bounds, Rgba8 const& color, AABB2 const& UVs)
 {
 	AddVertsForAABB2D(verts, bounds, color, UVs.m_mins, UVs.m_maxs);
 }
@@ -177,7 +202,8 @@ void AddVertsForConvexOutline2D(std::vector<Vertex_PCU>& verts, ConvexPoly2D con
 //}
 
 
-void AddVertsForLineSegment2D(std::vector<Vertex_PCU>& verts, LineSegment2 const& lineSegment, float thickness, Rgba8 const& color, AABB2 const& UVs)
+template <typename VertexArray>
+void AddVertsForLineSegment2D(VertexArray& verts, LineSegment2 const& lineSegment, float thickness, Rgba8 const& color, AABB2 const& UVs)
 {
 	UNUSED(UVs)
 
@@ -955,3 +981,9 @@ void AddVertsForDoubleRoundedBorderUI(std::vector<Vertex_PCU>& verts, AABB2 cons
 }
 
 
+template void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, AABB2 const& bounds, Rgba8 const& color, Vec2 const& uvMins, Vec2 const& uvMaxs);
+template void AddVertsForAABB2D(FrameVector<Vertex_PCU>& verts, AABB2 const& bounds, Rgba8 const& color, Vec2 const& uvMins, Vec2 const& uvMaxs);
+template void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, AABB2 const& bounds, Rgba8 const& color, AABB2 const& UVs);
+template void AddVertsForAABB2D(FrameVector<Vertex_PCU>& verts, AABB2 const& bounds, Rgba8 const& color, AABB2 const& UVs);
+template void AddVertsForLineSegment2D(std::vector<Vertex_PCU>& verts, LineSegment2 const& lineSegment, float thickness, Rgba8 const& color, AABB2 const& UVs);
+template void AddVertsForLineSegment2D(FrameVector<Vertex_PCU>& verts, LineSegment2 const& lineSegment, float thickness, Rgba8 const& color, AABB2 const& UVs);
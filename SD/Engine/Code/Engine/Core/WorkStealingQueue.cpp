@@ -0,0 +1,143 @@
+#include "Engine/Core/WorkStealingQueue.hpp"
+
+WorkStealingQueue::RingBuffer::RingBuffer(int capacity)
+	: m_capacity(capacity)
+	, m_mask(capacity - 1)
+{
+	m_jobs = new std::atomic<Job*>[capacity];
+}
+
+
+WorkStealingQueue::RingBuffer::~RingBuffer()
+{
+	delete[] m_jobs;
+	m_jobs = nullptr;
+}
+
+
+Job* WorkStealingQueue::RingBuffer::Get(int64_t index) const
+{
+	return m_jobs[index & m_mask].load(std::memory_order_relaxed);
+}
+
+
+void WorkStealingQueue::RingBuffer::Put(int64_t index, Job* job)
+{
+	m_jobs[index & m_mask].store(job, std::memory_order_relaxed);
+}
+
+
+WorkStealingQueue::RingBuffer* WorkStealingQueue::RingBuffer::Grow(int64_t top, int64_t bottom) const
+{
+	RingBuffer* newBuffer = new RingBuffer((int)m_capacity * 2);
+	for (int64_t index = top; index < bottom; index++)
+	{
+		newBuffer->Put(index, Get(index));
+	}
+	return newBuffer;
+}
+
+
+WorkStealingQueue::WorkStealingQueue(int initialCapacity)
+{
+	int capacity = 1;
+	while (capacity < initialCapacity)
+	{
+		capacity <<= 1;
+	}
+	m_buffer.store(new RingBuffer(capacity), std::memory_order_relaxed);
+}
+
+
+WorkStealingQueue::~WorkStealingQueue()
+{
+	delete m_buffer.load();
+	for (int bufferIndex = 0; bufferIndex < (int)m_retiredBuffers.size(); bufferIndex++)
+	{
+		delete m_retiredBuffers[bufferIndex];
+	}
+	m_retiredBuffers.clear();
+}
+
+
+void WorkStealingQueue::Push(Job* job)
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	int64_t top = m_top.load(std::memory_order_acquire);
+	RingBuffer* buffer = m_buffer.load(std::memory_order_relaxed);
+
+	if (bottom - top > buffer->m_capacity - 1)
+	{
+		RingBuffer* newBuffer = buffer->Grow(top, bottom);
+		m_retiredBuffers.push_back(buffer);
+		m_buffer.store(newBuffer, std::memory_order_release);
+		buffer = newBuffer;
+	}
+
+	buffer->Put(bottom, job);
+	std::atomic_thread_fence(std::memory_order_release);
+	m_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+
+Job* WorkStealingQueue::Pop()
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+	RingBuffer* buffer = m_buffer.load(std::memory_order_relaxed);
+	m_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = buffer->Get(bottom);
+	if (top == bottom)
+	{
+		// last element, race against thieves for it
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+
+Job* WorkStealingQueue::Steal()
+{
+	int64_t top = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+	if (top >= bottom)
+	{
+		return nullptr;
+	}
+
+	RingBuffer* buffer = m_buffer.load(std::memory_order_acquire);
+	Job* job = buffer->Get(top);
+	if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+	return job;
+}
+
+
+bool WorkStealingQueue::IsEmpty() const
+{
+	return GetApproximateSize() <= 0;
+}
+
+
+int WorkStealingQueue::GetApproximateSize() const
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	int64_t top = m_top.load(std::memory_order_relaxed);
+	return (int)(bottom - top);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class Job;
+
+// Chase-Lev deque: the owning worker pushes and pops at the bottom without locking,
+// any other thread may steal from the top
+class WorkStealingQueue
+{
+public:
+	explicit WorkStealingQueue(int initialCapacity = 256);
+	~WorkStealingQueue();
+	WorkStealingQueue(WorkStealingQueue const& copy) = delete;
+
+	// owner thread only
+	void Push(Job* job);
+	Job* Pop();
+
+	// any thread
+	Job* Steal();
+	bool IsEmpty() const;
+	int GetApproximateSize() const;
+
+private:
+	struct RingBuffer
+	{
+		RingBuffer(int capacity);
+		~RingBuffer();
+
+		Job* Get(int64_t index) const;
+		void Put(int64_t index, Job* job);
+		RingBuffer* Grow(int64_t top, int64_t bottom) const;
+
+		int64_t m_capacity = 0;
+		int64_t m_mask = 0;
+		std::atomic<Job*>* m_jobs = nullptr;
+	};
+
+private:
+	std::atomic<int64_t> m_top = 0;
+	std::atomic<int64_t> m_bottom = 0;
+	std::atomic<RingBuffer*> m_buffer = nullptr;
+
+	// thieves may still be reading an old buffer after a grow, so they are only freed on destruction
+	std::vector<RingBuffer*> m_retiredBuffers;
+};
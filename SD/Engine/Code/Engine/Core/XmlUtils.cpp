@@ -132,7 +132,15 @@ Strings ParseXmlAttribute(XmlElement const& element, char const* attributeName,
 	const char* value = element.Attribute(attributeName);
 	if (!value) return defaultValues;
 
-	return SplitStringOnDelimiter(value, ',');
+	// each token is built once from its view instead of a char at a time
+	Strings values;
+	StringTokenizer tokenizer(value, ',');
+	StringView token;
+	while (tokenizer.GetNextToken(token))
+	{
+		values.emplace_back(token.GetData(), token.GetLength());
+	}
+	return values;
 }
 
 
@@ -26,13 +26,14 @@ void GUI_Button::Render(Renderer* renderer) const
 
 void GUI_Button::OnClick()
 {
-	CallHandler(m_handlerName);
+	CallHandler(m_handlerId);
 }
 
 
 void GUI_Button::SetHandler(std::string const& handlerName)
 {
 	m_handlerName = handlerName;
+	m_handlerId = EventId(handlerName);
 }
 
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/GUI/GUI_Text.hpp"
+#include "Engine/Core/EventSystem.hpp"
 
 class GUI_Button : public GUI_Text
 {
@@ -17,4 +18,5 @@ public:
 
 public:
 	std::string m_handlerName = "";
+	EventId m_handlerId;
 };
\ No newline at end of file
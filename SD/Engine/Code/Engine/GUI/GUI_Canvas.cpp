@@ -1,5 +1,6 @@
 #include "Engine/GUI/GUI_Canvas.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 #include "Engine/Window/Window.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Renderer/Renderer.hpp"
@@ -27,6 +28,7 @@ GUI_Canvas::~GUI_Canvas()
 
 void GUI_Canvas::Update()
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_GUI);
 	if (!m_isOpen) return;
 
 	if (g_theInput->WasKeyJustPressed(KEYCODE_LEFT_MOUSE) && !m_isLeftMouseHeld)
@@ -88,6 +90,7 @@ void GUI_Canvas::Update()
 
 void GUI_Canvas::Render(Renderer* renderer) const
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_GUI);
 	if (!m_isOpen) return;
 
 	std::deque<GUI_Element*> elementsQueue;
@@ -131,6 +134,7 @@ void GUI_Canvas::RenderModel(Renderer* renderer) const
 
 void GUI_Canvas::LoadLayout(std::string const& layoutPath, Renderer* renderer)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_GUI);
 	GUI_Layout layout(renderer);
 	GUI_Element* rootElement = layout.GenerateFromLayout(layoutPath, this);
 	SetRootElement(rootElement);
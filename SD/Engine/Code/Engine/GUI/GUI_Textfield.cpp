@@ -47,13 +47,14 @@ void GUI_Textfield::SetTextBoxColor(Rgba8 const& color)
 
 void GUI_Textfield::CallEventHandler()
 {
-	CallHandler(m_handlerName);
+	CallHandler(m_handlerId);
 }
 
 
 void GUI_Textfield::SetHandler(std::string const& handlerName)
 {
 	m_handlerName = handlerName;
+	m_handlerId = EventId(handlerName);
 }
 
 
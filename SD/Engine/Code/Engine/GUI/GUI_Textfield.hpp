@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/GUI/GUI_Text.hpp"
+#include "Engine/Core/EventSystem.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 
 class GUI_Textfield : public GUI_Text
@@ -23,4 +24,5 @@ public:
 public:
 	Rgba8 m_textBoxColor = Rgba8::CLEAR;
 	std::string m_handlerName = "";
+	EventId m_handlerId;
 };
\ No newline at end of file
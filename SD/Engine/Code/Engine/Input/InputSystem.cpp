@@ -2,6 +2,9 @@
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Window/Window.hpp"
 #include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+
+#include <algorithm>
 
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
@@ -40,6 +43,12 @@ unsigned char const KEYCODE_PERIOD			= VK_OEM_PERIOD;
 
 InputSystem* g_theInput;
 
+// fired for every key and character typed
+static EventId const s_keyPressedEventId("KeyPressed");
+static EventId const s_charInputEventId("CharInput");
+
+static bool ParseScriptedKeyCode(std::string const& keyName, unsigned char& out_keyCode);
+
 InputSystem::InputSystem(InputSystemConfig const& config)
 	:m_config(config)
 {
@@ -65,6 +74,25 @@ void InputSystem::Startup()
 
 void InputSystem::BeginFrame()
 {
+	if (m_isScripted)
+	{
+		while (m_nextScriptedEventIndex < (int)m_scriptedEvents.size() && m_scriptedEvents[m_nextScriptedEventIndex].m_frame <= m_scriptFrame)
+		{
+			ScriptedInputEvent const& scriptedEvent = m_scriptedEvents[m_nextScriptedEventIndex];
+			if (scriptedEvent.m_isPressed)
+			{
+				HandleKeyPressed(scriptedEvent.m_keyCode);
+			}
+			else
+			{
+				HandleKeyReleased(scriptedEvent.m_keyCode);
+			}
+			m_nextScriptedEventIndex++;
+		}
+		m_scriptFrame++;
+		return;
+	}
+
 	for (int controllerIndex = 0; controllerIndex < NUM_XBOX_CONTROLLERS; controllerIndex++)
 	{
 		m_controllers[controllerIndex].Update();
@@ -118,7 +146,7 @@ bool InputSystem::HandleKeyPressed(unsigned char keyCode)
 	m_keyStates[keyCode].m_isDownThisFrame = true;
 	EventArgs args;
 	args.SetValue("key", keyCode);
-	FireEvent("KeyPressed", args);
+	FireEvent(s_keyPressedEventId, args);
 	return true;
 }
 
@@ -134,7 +162,7 @@ bool InputSystem::HandleCharInput(int charCode)
 {
 	EventArgs args;
 	args.SetValue("key", charCode);
-	FireEvent("CharInput", args);
+	FireEvent(s_charInputEventId, args);
 
 	if (charCode == 22) // charCode for paste
 	{
@@ -201,6 +229,9 @@ void InputSystem::SetMouseMode(bool isHidden, bool isClipped, bool isRelative)
 	m_isRelative = isRelative;
 
 	HWND windowHandle = (HWND) Window::GetWindowContext()->GetOSWindowHandle();
+	// a headless run has no cursor of its own, leave the desktop one alone
+	if (Window::GetWindowContext()->IsHeadless()) return;
+
 	RECT clientRect;
 	::GetClientRect(windowHandle, &clientRect);
 	int centerX = (clientRect.left + clientRect.right) / 2;
@@ -301,3 +332,92 @@ XboxController const& InputSystem::GetController(int controllerID)
 }
 
 
+void InputSystem::SetInputScript(std::vector<ScriptedInputEvent> const& events)
+{
+	m_scriptedEvents = events;
+	std::stable_sort(m_scriptedEvents.begin(), m_scriptedEvents.end(), [](ScriptedInputEvent const& a, ScriptedInputEvent const& b) { return a.m_frame < b.m_frame; });
+	m_nextScriptedEventIndex = 0;
+	m_scriptFrame = 0;
+	m_isScripted = true;
+}
+
+
+bool InputSystem::LoadInputScript(std::string const& filePath)
+{
+	XmlDocument doc;
+	if (doc.LoadFile(filePath.c_str()) != tinyxml2::XML_SUCCESS)
+	{
+		return false;
+	}
+	XmlElement const* root = doc.RootElement();
+	if (!root)
+	{
+		return false;
+	}
+
+	// <InputScript> <Key frame="30" key="SPACE" pressed="true"/> ... </InputScript>
+	std::vector<ScriptedInputEvent> events;
+	for (XmlElement const* element = root->FirstChildElement("Key"); element; element = element->NextSiblingElement("Key"))
+	{
+		ScriptedInputEvent scriptedEvent;
+		scriptedEvent.m_frame = ParseXmlAttribute(*element, "frame", 0);
+		scriptedEvent.m_isPressed = ParseXmlAttribute(*element, "pressed", true);
+		std::string keyName = ParseXmlAttribute(*element, "key", "");
+		if (!ParseScriptedKeyCode(keyName, scriptedEvent.m_keyCode))
+		{
+			ERROR_RECOVERABLE(Stringf("Unknown key \"%s\" in input script %s", keyName.c_str(), filePath.c_str()));
+			continue;
+		}
+		events.push_back(scriptedEvent);
+	}
+	SetInputScript(events);
+	return true;
+}
+
+
+void InputSystem::ClearInputScript()
+{
+	m_scriptedEvents.clear();
+	m_nextScriptedEventIndex = 0;
+	m_scriptFrame = 0;
+	m_isScripted = false;
+}
+
+
+bool InputSystem::IsInputScripted() const
+{
+	return m_isScripted;
+}
+
+
+static bool ParseScriptedKeyCode(std::string const& keyName, unsigned char& out_keyCode)
+{
+	if (keyName.size() == 1)
+	{
+		out_keyCode = static_cast<unsigned char>(toupper(keyName[0]));
+		return true;
+	}
+
+	struct NamedKey
+	{
+		char const* m_name;
+		unsigned char m_keyCode;
+	};
+	NamedKey const namedKeys[] =
+	{
+		{ "SPACE", KEYCODE_SPACE }, { "ENTER", KEYCODE_ENTER }, { "ESC", KEYCODE_ESC }, { "SHIFT", KEYCODE_SHIFT },
+		{ "TILDE", KEYCODE_TILDE }, { "UP", KEYCODE_UPARROW }, { "DOWN", KEYCODE_DOWNARROW }, { "LEFT", KEYCODE_LEFTARROW },
+		{ "RIGHT", KEYCODE_RIGHTARROW }, { "LMB", KEYCODE_LEFT_MOUSE }, { "RMB", KEYCODE_RIGHT_MOUSE }, { "MMB", KEYCODE_MIDDLE_MOUSE },
+		{ "F1", KEYCODE_F1 }, { "F2", KEYCODE_F2 }, { "F3", KEYCODE_F3 }, { "F4", KEYCODE_F4 }, { "F5", KEYCODE_F5 }, { "F6", KEYCODE_F6 },
+		{ "F7", KEYCODE_F7 }, { "F8", KEYCODE_F8 }, { "F9", KEYCODE_F9 }, { "F10", KEYCODE_F10 }, { "F11", KEYCODE_F11 },
+	};
+	for (int keyIndex = 0; keyIndex < (int)(sizeof(namedKeys) / sizeof(namedKeys[0])); keyIndex++)
+	{
+		if (keyName == namedKeys[keyIndex].m_name)
+		{
+			out_keyCode = namedKeys[keyIndex].m_keyCode;
+			return true;
+		}
+	}
+	return false;
+}
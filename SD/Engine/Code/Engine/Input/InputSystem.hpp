@@ -1,6 +1,9 @@
 #pragma once
 #include "Engine/Input/XboxController.hpp"
 
+#include <string>
+#include <vector>
+
 extern unsigned char const KEYCODE_F1;
 extern unsigned char const KEYCODE_F2;
 extern unsigned char const KEYCODE_F3;
@@ -53,6 +56,15 @@ struct InputSystemConfig
 {
 };
 
+
+// one key change, applied at the start of the given frame as if the window had sent it
+struct ScriptedInputEvent
+{
+	int m_frame = 0;
+	unsigned char m_keyCode = 0;
+	bool m_isPressed = true;
+};
+
 class InputSystem
 {
 public:
@@ -82,6 +94,12 @@ public:
 	Vec2 const GetMouseClientDelta();
 	XboxController const& GetController(int controllerID);
 
+	// replays key events by frame number, controllers are not polled while a script is set so runs repeat exactly
+	void SetInputScript(std::vector<ScriptedInputEvent> const& events);
+	bool LoadInputScript(std::string const& filePath);
+	void ClearInputScript();
+	bool IsInputScripted() const;
+
 protected:
 	InputSystemConfig m_config;
 	KeyButtonState m_keyStates[NUM_KEYCODES];
@@ -92,4 +110,9 @@ protected:
 	bool m_isDeltaIgnored = false;
 	MouseState m_mouseState;
 	MouseWheelState m_mouseWheelState = MouseWheelState::WHEEL_IDLE;
+
+	bool m_isScripted = false;
+	std::vector<ScriptedInputEvent> m_scriptedEvents;
+	int m_nextScriptedEventIndex = 0;
+	int m_scriptFrame = 0;
 };
\ No newline at end of file
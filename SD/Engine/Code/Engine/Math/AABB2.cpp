@@ -132,11 +132,12 @@ void AABB2::AlignBoxWithin(AABB2& box, Vec2 const& alignment) const
 }
 
 
-void AABB2::SetFromText(std::string const& text)
+void AABB2::SetFromText(StringView const& text)
 {
-	Strings tokens = SplitStringOnDelimiter(text, ';');
+	StringView tokens[2];
+	int numTokens = SplitStringOnDelimiter(text, ';', tokens, 2);
 
-	if (tokens.size() == 2)
+	if (numTokens == 2)
 	{
 		m_mins.SetFromText(tokens[0]);
 		m_maxs.SetFromText(tokens[1]);
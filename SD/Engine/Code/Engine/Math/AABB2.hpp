@@ -29,7 +29,7 @@ public:
 	void StretchToIncludePoint(Vec2 const& point);
 	void AlignBoxWithin(AABB2& box, Vec2 const& alignment) const;
 
-	void SetFromText(std::string const& text);
+	void SetFromText(StringView const& text);
 
 public:
 	Vec2 m_mins;
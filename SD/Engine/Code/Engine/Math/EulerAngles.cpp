@@ -63,15 +63,16 @@ Mat44 EulerAngles::GetAsMatrix_XFwd_YLeft_ZUp() const
 }
 
 
-void EulerAngles::SetFromText(std::string const& text)
+void EulerAngles::SetFromText(StringView const& text)
 {
-	Strings tokens = SplitStringOnDelimiter(text, ',');
+	StringView tokens[3];
+	int numTokens = SplitStringOnDelimiter(text, ',', tokens, 3);
 
-	if (tokens.size() == 3)
+	if (numTokens == 3)
 	{
-		m_yawDegrees = static_cast<float>(atof(tokens[0].c_str()));
-		m_pitchDegrees = static_cast<float>(atof(tokens[1].c_str()));
-		m_rollDegrees = static_cast<float>(atof(tokens[2].c_str()));
+		m_yawDegrees = ParseFloatFromText(tokens[0]);
+		m_pitchDegrees = ParseFloatFromText(tokens[1]);
+		m_rollDegrees = ParseFloatFromText(tokens[2]);
 	}
 	else
 	{
@@ -12,7 +12,7 @@ public:
 	
 	void GetAsVectors_XFwd_YLeft_ZUp(Vec3& out_forwardIBasis, Vec3& out_leftJBasis, Vec3& out_upKBasis) const;
 	Mat44 GetAsMatrix_XFwd_YLeft_ZUp() const;
-	void SetFromText(std::string const& text);
+	void SetFromText(StringView const& text);
 	
 	EulerAngles const operator+(const EulerAngles& toAdd) const;
 	EulerAngles const operator*(const float multiplier) const;
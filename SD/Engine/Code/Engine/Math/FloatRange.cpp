@@ -52,14 +52,15 @@ FloatRange const FloatRange::GetOverlappingRangeWith(FloatRange const& range) co
 }
 
 
-void FloatRange::SetFromText(std::string const& text)
+void FloatRange::SetFromText(StringView const& text)
 {
-	Strings tokens = SplitStringOnDelimiter(text, '~');
+	StringView tokens[2];
+	int numTokens = SplitStringOnDelimiter(text, '~', tokens, 2);
 
-	if (tokens.size() == 2)
+	if (numTokens == 2)
 	{
-		m_min = static_cast<float>(atof(tokens[0].c_str()));
-		m_max = static_cast<float>(atof(tokens[1].c_str()));
+		m_min = ParseFloatFromText(tokens[0]);
+		m_max = ParseFloatFromText(tokens[1]);
 	}
 	else
 	{
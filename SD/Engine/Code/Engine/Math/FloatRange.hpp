@@ -1,6 +1,6 @@
 #pragma once
 
-#include <string>
+#include "Engine/Core/StringUtils.hpp"
 
 struct FloatRange
 {
@@ -21,7 +21,7 @@ public:
 	bool IsOnRange(float point) const;
 	bool IsOverlappingWith(FloatRange const& range) const;
 	FloatRange const GetOverlappingRangeWith(FloatRange const& range) const;
-	void SetFromText(std::string const& text);
+	void SetFromText(StringView const& text);
 
 	bool operator==(const FloatRange& compare) const;
 	bool operator!=(const FloatRange& compare) const;
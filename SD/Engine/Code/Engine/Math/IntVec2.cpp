@@ -88,14 +88,15 @@ void IntVec2::RotateMinus90Degrees()
 }
 
 
-void IntVec2::SetFromText(std::string const& text)
+void IntVec2::SetFromText(StringView const& text)
 {
-	Strings tokens = SplitStringOnDelimiter(text, ',');
+	StringView tokens[2];
+	int numTokens = SplitStringOnDelimiter(text, ',', tokens, 2);
 
-	if (tokens.size() == 2)
+	if (numTokens == 2)
 	{
-		x = atoi(tokens[0].c_str());
-		y = atoi(tokens[1].c_str());
+		x = ParseIntFromText(tokens[0]);
+		y = ParseIntFromText(tokens[1]);
 	}
 	else
 	{
@@ -1,5 +1,5 @@
 #pragma once
-#include <string>
+#include "Engine/Core/StringUtils.hpp"
 
 struct IntVec2
 {
@@ -36,7 +36,7 @@ public:
 
 	void Rotate90Degrees();
 	void RotateMinus90Degrees();
-	void SetFromText(std::string const& text);
+	void SetFromText(StringView const& text);
 
 	// Operators (const)
 	bool		operator==(const IntVec2& compare) const;		// vec2 == vec2
@@ -52,15 +52,16 @@ int IntVec3::GetTaxicabLength() const
 }
 
 
-void IntVec3::SetFromText(std::string const& text)
+void IntVec3::SetFromText(StringView const& text)
 {
-	Strings tokens = SplitStringOnDelimiter(text, ',');
+	StringView tokens[3];
+	int numTokens = SplitStringOnDelimiter(text, ',', tokens, 3);
 
-	if (tokens.size() == 3)
+	if (numTokens == 3)
 	{
-		x = atoi(tokens[0].c_str());
-		y = atoi(tokens[1].c_str());
-		z = atoi(tokens[2].c_str());
+		x = ParseIntFromText(tokens[0]);
+		y = ParseIntFromText(tokens[1]);
+		z = ParseIntFromText(tokens[2]);
 	}
 	else
 	{
@@ -1,5 +1,5 @@
 #pragma once
-#include <string>
+#include "Engine/Core/StringUtils.hpp"
 
 struct IntVec3
 {
@@ -39,7 +39,7 @@ public:
 
 	//void Rotate90DegreesAroundZ();
 	//void RotateMinus90DegreesAroundZ();
-	void SetFromText(std::string const& text);
+	void SetFromText(StringView const& text);
 
 	// Operators (const)
 	bool		operator==(const IntVec3& compare) const;		// vec3 == vec3
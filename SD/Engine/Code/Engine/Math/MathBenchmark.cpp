@@ -0,0 +1,600 @@
+#include "Engine/Math/MathBenchmark.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Capsule2.hpp"
+#include "Engine/Math/LineSegment2.hpp"
+#include "Engine/Math/LineSegment3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/OBB2.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+#include <math.h>
+
+// power of two so the op index wraps with a mask, small enough that every input set stays in L1/L2
+constexpr int NUM_BENCHMARK_INPUTS = 1024;
+constexpr int BENCHMARK_INPUT_MASK = NUM_BENCHMARK_INPUTS - 1;
+
+struct MathBenchmarkInputs
+{
+	Vec2 m_points2D[NUM_BENCHMARK_INPUTS];
+	Vec2 m_otherPoints2D[NUM_BENCHMARK_INPUTS];
+	Vec2 m_normals2D[NUM_BENCHMARK_INPUTS];
+	Vec3 m_points3D[NUM_BENCHMARK_INPUTS];
+	Vec3 m_otherPoints3D[NUM_BENCHMARK_INPUTS];
+	Vec3 m_normals3D[NUM_BENCHMARK_INPUTS];
+	float m_radii[NUM_BENCHMARK_INPUTS];
+	float m_degrees[NUM_BENCHMARK_INPUTS];
+	AABB2 m_boxes2D[NUM_BENCHMARK_INPUTS];
+	OBB2 m_orientedBoxes2D[NUM_BENCHMARK_INPUTS];
+	Capsule2 m_capsules2D[NUM_BENCHMARK_INPUTS];
+	LineSegment2 m_lines2D[NUM_BENCHMARK_INPUTS];
+	AABB3 m_boxes3D[NUM_BENCHMARK_INPUTS];
+	LineSegment3 m_lines3D[NUM_BENCHMARK_INPUTS];
+	Mat44 m_matrices[NUM_BENCHMARK_INPUTS];
+};
+
+// the timed runs store their checksum here so the optimizer cannot drop them
+static volatile double s_mathBenchmarkSink = 0.0;
+
+typedef double (*MathBenchmarkFunction)(MathBenchmarkInputs const& inputs, int numOps);
+
+struct MathBenchmarkCase
+{
+	char const* m_name = nullptr;
+	MathBenchmarkFunction m_function = nullptr;
+};
+
+
+static void GenerateMathBenchmarkInputs(MathBenchmarkInputs& inputs, unsigned int seed);
+static MathBenchmarkResult const* FindMathBenchmarkResult(std::vector<MathBenchmarkResult> const& results, std::string const& name);
+
+
+// inputs are spread over a 20 unit world so roughly half of the queries hit, the rest take the early outs
+static MathBenchmarkCase const s_mathBenchmarkCases[] =
+{
+	{ "RaycastVsDisc2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += RaycastVsDisc2D(in.m_points2D[i], in.m_normals2D[i], 20.f, in.m_otherPoints2D[i], in.m_radii[i]).m_impactDistance;
+		}
+		return checksum;
+	} },
+	{ "RaycastVsAABB2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += RaycastVsAABB2D(in.m_points2D[i], in.m_normals2D[i], 20.f, in.m_boxes2D[i]).m_impactDistance;
+		}
+		return checksum;
+	} },
+	{ "RaycastVsOBB2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += RaycastVsOBB2D(in.m_points2D[i], in.m_normals2D[i], 20.f, in.m_orientedBoxes2D[i]).m_impactDistance;
+		}
+		return checksum;
+	} },
+	{ "RaycastVsLineSegment2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += RaycastVsLineSegment2D(in.m_points2D[i], in.m_normals2D[i], 20.f, in.m_lines2D[i]).m_impactDistance;
+		}
+		return checksum;
+	} },
+	{ "RaycastVsSphere3D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += RaycastVsSphere3D(in.m_points3D[i], in.m_normals3D[i], 20.f, in.m_otherPoints3D[i], in.m_radii[i]).m_impactDistance;
+		}
+		return checksum;
+	} },
+	{ "RaycastVsAABB3D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += RaycastVsAABB3D(in.m_points3D[i], in.m_normals3D[i], 20.f, in.m_boxes3D[i]).m_impactDistance;
+		}
+		return checksum;
+	} },
+	{ "RaycastVsZCylinder3D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += RaycastVsZCylinder3D(in.m_points3D[i], in.m_normals3D[i], 20.f, in.m_otherPoints3D[i], in.m_radii[i], 2.f * in.m_radii[i]).m_impactDistance;
+		}
+		return checksum;
+	} },
+	{ "IsPointInsideDisc2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += IsPointInsideDisc2D(in.m_points2D[i], in.m_otherPoints2D[i], 4.f * in.m_radii[i]) ? 1.0 : 0.0;
+		}
+		return checksum;
+	} },
+	{ "IsPointInsideOBB2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += IsPointInsideOBB2D(in.m_points2D[i], in.m_orientedBoxes2D[i]) ? 1.0 : 0.0;
+		}
+		return checksum;
+	} },
+	{ "IsPointInsideCapsule2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += IsPointInsideCapsule2D(in.m_points2D[i], in.m_capsules2D[i]) ? 1.0 : 0.0;
+		}
+		return checksum;
+	} },
+	{ "IsPointInsideOrientedSector2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += IsPointInsideOrientedSector2D(in.m_points2D[i], in.m_otherPoints2D[i], in.m_degrees[i], 90.f, 10.f) ? 1.0 : 0.0;
+		}
+		return checksum;
+	} },
+	{ "IsPointInsideDirectedSector2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += IsPointInsideDirectedSector2D(in.m_points2D[i], in.m_otherPoints2D[i], in.m_normals2D[i], 90.f, 10.f) ? 1.0 : 0.0;
+		}
+		return checksum;
+	} },
+	{ "DoAABB3sOverlap3D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += DoAABB3sOverlap3D(in.m_boxes3D[i], in.m_boxes3D[(i + 1) & BENCHMARK_INPUT_MASK]) ? 1.0 : 0.0;
+		}
+		return checksum;
+	} },
+	{ "DoZCylindersOverlap3D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += DoZCylindersOverlap3D(in.m_points3D[i], in.m_radii[i], 2.f, in.m_otherPoints3D[i], in.m_radii[i], 2.f) ? 1.0 : 0.0;
+		}
+		return checksum;
+	} },
+	{ "DoesSphereOverlapWithAABB3D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += DoesSphereOverlapWithAABB3D(in.m_points3D[i], in.m_radii[i], in.m_boxes3D[i]) ? 1.0 : 0.0;
+		}
+		return checksum;
+	} },
+	{ "GetNearestPointOnOBB2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += GetNearestPointOnOBB2D(in.m_points2D[i], in.m_orientedBoxes2D[i]).x;
+		}
+		return checksum;
+	} },
+	{ "GetNearestPointOnCapsule2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += GetNearestPointOnCapsule2D(in.m_points2D[i], in.m_capsules2D[i]).x;
+		}
+		return checksum;
+	} },
+	{ "GetNearestPointOnLineSegment3D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += GetNearestPointOnLineSegment3D(in.m_points3D[i], in.m_lines3D[i]).x;
+		}
+		return checksum;
+	} },
+	{ "PushDiscOutOfDisc2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			Vec2 discCenter = in.m_points2D[i];
+			PushDiscOutOfDisc2D(discCenter, 4.f * in.m_radii[i], in.m_otherPoints2D[i], 4.f * in.m_radii[i]);
+			checksum += discCenter.x;
+		}
+		return checksum;
+	} },
+	{ "PushDiscsOutOfEachOther2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			Vec2 centerA = in.m_points2D[i];
+			Vec2 centerB = in.m_otherPoints2D[i];
+			PushDiscsOutOfEachOther2D(centerA, 4.f * in.m_radii[i], centerB, 4.f * in.m_radii[i]);
+			checksum += centerA.x + centerB.y;
+		}
+		return checksum;
+	} },
+	{ "PushDiscOutOfAABB2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			Vec2 discCenter = in.m_points2D[i];
+			PushDiscOutOfAABB2D(discCenter, in.m_radii[i], in.m_boxes2D[i]);
+			checksum += discCenter.x;
+		}
+		return checksum;
+	} },
+	{ "PushDiscOutOfOBB2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			Vec2 discCenter = in.m_points2D[i];
+			PushDiscOutOfOBB2D(discCenter, in.m_radii[i], in.m_orientedBoxes2D[i]);
+			checksum += discCenter.x;
+		}
+		return checksum;
+	} },
+	{ "PushDiscOutOfCapsule2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			Vec2 discCenter = in.m_points2D[i];
+			PushDiscOutOfCapsule2D(discCenter, in.m_radii[i], in.m_capsules2D[i]);
+			checksum += discCenter.x;
+		}
+		return checksum;
+	} },
+	{ "BounceDiscsOffEachOther2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			Vec2 centerA = in.m_points2D[i];
+			Vec2 centerB = in.m_otherPoints2D[i];
+			Vec2 velocityA = in.m_normals2D[i];
+			Vec2 velocityB = -in.m_normals2D[i];
+			BounceDiscsOffEachOther2D(centerA, 4.f * in.m_radii[i], velocityA, centerB, 4.f * in.m_radii[i], velocityB, 0.9f);
+			checksum += velocityA.x + velocityB.y;
+		}
+		return checksum;
+	} },
+	{ "GetShortestAngularDispDegrees", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += GetShortestAngularDispDegrees(in.m_degrees[i], in.m_degrees[(i + 1) & BENCHMARK_INPUT_MASK]);
+		}
+		return checksum;
+	} },
+	{ "Atan2Degrees", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += Atan2Degrees(in.m_points2D[i].y, in.m_points2D[i].x);
+		}
+		return checksum;
+	} },
+	{ "TransformPosition2D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			Vec2 position = in.m_points2D[i];
+			TransformPosition2D(position, 1.5f, in.m_degrees[i], in.m_otherPoints2D[i]);
+			checksum += position.x;
+		}
+		return checksum;
+	} },
+	{ "Mat44::Append", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			Mat44 matrix = in.m_matrices[i];
+			matrix.Append(in.m_matrices[(i + 1) & BENCHMARK_INPUT_MASK]);
+			checksum += matrix.m_values[Mat44::Tx];
+		}
+		return checksum;
+	} },
+	{ "Mat44::TransformPosition3D", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += in.m_matrices[i].TransformPosition3D(in.m_points3D[i]).x;
+		}
+		return checksum;
+	} },
+	{ "Mat44::GetOrthonormalInverse", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += in.m_matrices[i].GetOrthonormalInverse().m_values[Mat44::Tx];
+		}
+		return checksum;
+	} },
+	{ "Mat44::GetInverse", [](MathBenchmarkInputs const& in, int numOps) -> double
+	{
+		double checksum = 0.0;
+		for (int opIndex = 0; opIndex < numOps; opIndex++)
+		{
+			int i = opIndex & BENCHMARK_INPUT_MASK;
+			checksum += Mat44::GetInverse(in.m_matrices[i]).m_values[Mat44::Tx];
+		}
+		return checksum;
+	} },
+};
+
+
+void RunMathBenchmarks(MathBenchmarkConfig const& config, std::vector<MathBenchmarkResult>& outResults)
+{
+	outResults.clear();
+	if (config.m_numOps <= 0 || config.m_numRepeats <= 0) return;
+
+	// too big for the stack
+	MathBenchmarkInputs* inputs = new MathBenchmarkInputs();
+	GenerateMathBenchmarkInputs(*inputs, config.m_seed);
+
+	int numCases = sizeof(s_mathBenchmarkCases) / sizeof(s_mathBenchmarkCases[0]);
+	for (int caseIndex = 0; caseIndex < numCases; caseIndex++)
+	{
+		MathBenchmarkCase const& benchmarkCase = s_mathBenchmarkCases[caseIndex];
+		if (!config.m_filter.empty() && std::string(benchmarkCase.m_name).find(config.m_filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		// one untimed pass pulls the inputs and the code into cache
+		MathBenchmarkResult result;
+		result.m_name = benchmarkCase.m_name;
+		result.m_checksum = benchmarkCase.m_function(*inputs, config.m_numOps);
+
+		double bestSeconds = 0.0;
+		for (int repeat = 0; repeat < config.m_numRepeats; repeat++)
+		{
+			double startTime = GetCurrentTimeSeconds();
+			s_mathBenchmarkSink = benchmarkCase.m_function(*inputs, config.m_numOps);
+			double seconds = GetCurrentTimeSeconds() - startTime;
+			if (repeat == 0 || seconds < bestSeconds)
+			{
+				bestSeconds = seconds;
+			}
+		}
+
+		result.m_nanosecondsPerOp = bestSeconds * 1000000000.0 / static_cast<double>(config.m_numOps);
+		result.m_opsPerSecond = bestSeconds > 0.0 ? static_cast<double>(config.m_numOps) / bestSeconds : 0.0;
+		outResults.push_back(result);
+	}
+
+	delete inputs;
+}
+
+
+bool SaveMathBenchmarkBaseline(std::string const& filePath, MathBenchmarkConfig const& config, std::vector<MathBenchmarkResult> const& results)
+{
+	XmlDocument doc;
+	XmlElement* root = doc.NewElement("MathBenchmarks");
+	root->SetAttribute("seed", config.m_seed);
+	root->SetAttribute("ops", config.m_numOps);
+	doc.InsertFirstChild(root);
+	for (int resultIndex = 0; resultIndex < (int)results.size(); resultIndex++)
+	{
+		MathBenchmarkResult const& result = results[resultIndex];
+		XmlElement* element = doc.NewElement("Benchmark");
+		element->SetAttribute("name", result.m_name.c_str());
+		element->SetAttribute("nsPerOp", Stringf("%.3f", result.m_nanosecondsPerOp).c_str());
+		element->SetAttribute("checksum", Stringf("%.17g", result.m_checksum).c_str());
+		root->InsertEndChild(element);
+	}
+	return doc.SaveFile(filePath.c_str()) == tinyxml2::XML_SUCCESS;
+}
+
+
+bool LoadMathBenchmarkBaseline(std::string const& filePath, std::vector<MathBenchmarkResult>& outResults)
+{
+	outResults.clear();
+	XmlDocument doc;
+	if (doc.LoadFile(filePath.c_str()) != tinyxml2::XML_SUCCESS)
+	{
+		return false;
+	}
+	XmlElement const* root = doc.RootElement();
+	if (!root)
+	{
+		return false;
+	}
+
+	for (XmlElement const* element = root->FirstChildElement("Benchmark"); element; element = element->NextSiblingElement("Benchmark"))
+	{
+		MathBenchmarkResult result;
+		result.m_name = ParseXmlAttribute(*element, "name", "");
+		result.m_nanosecondsPerOp = element->DoubleAttribute("nsPerOp", 0.0);
+		result.m_checksum = element->DoubleAttribute("checksum", 0.0);
+		result.m_opsPerSecond = result.m_nanosecondsPerOp > 0.0 ? 1000000000.0 / result.m_nanosecondsPerOp : 0.0;
+		outResults.push_back(result);
+	}
+	return true;
+}
+
+
+bool Command_MathBenchmark(EventArgs& args)
+{
+	MathBenchmarkConfig config;
+	config.m_numOps = args.GetParsedValue("ops", config.m_numOps);
+	config.m_numRepeats = args.GetParsedValue("repeats", config.m_numRepeats);
+	config.m_seed = (unsigned int)args.GetParsedValue("seed", (int)config.m_seed);
+	config.m_filter = args.GetValue("filter", "");
+	std::string savePath = args.GetValue("save", "");
+	std::string baselinePath = args.GetValue("baseline", "");
+
+	std::vector<MathBenchmarkResult> baseline;
+	if (!baselinePath.empty() && !LoadMathBenchmarkBaseline(baselinePath, baseline))
+	{
+		g_theDevConsole->AddLine(DevConsole::INFO_ERROR, Stringf("Could not load math benchmark baseline %s", baselinePath.c_str()));
+		return false;
+	}
+
+	std::vector<MathBenchmarkResult> results;
+	RunMathBenchmarks(config, results);
+
+	g_theDevConsole->AddLine(DevConsole::INFO_MAJOR, Stringf("## Math benchmarks, %d ops x %d repeats, seed %u ##", config.m_numOps, config.m_numRepeats, config.m_seed));
+	for (int resultIndex = 0; resultIndex < (int)results.size(); resultIndex++)
+	{
+		MathBenchmarkResult const& result = results[resultIndex];
+		std::string line = Stringf("%-32s %8.2fns/op %12.0f ops/s", result.m_name.c_str(), result.m_nanosecondsPerOp, result.m_opsPerSecond);
+		Rgba8 color = DevConsole::INFO_MINOR;
+
+		MathBenchmarkResult const* baselineResult = FindMathBenchmarkResult(baseline, result.m_name);
+		if (baselineResult && baselineResult->m_nanosecondsPerOp > 0.0)
+		{
+			double changePercent = (result.m_nanosecondsPerOp - baselineResult->m_nanosecondsPerOp) * 100.0 / baselineResult->m_nanosecondsPerOp;
+			line += Stringf("  baseline %8.2fns/op %+6.1f%%", baselineResult->m_nanosecondsPerOp, changePercent);
+			// within 5% is run to run noise on a busy machine
+			if (changePercent > 5.0)
+			{
+				color = DevConsole::INFO_WARNING;
+			}
+			else if (changePercent < -5.0)
+			{
+				color = DevConsole::INFO_MAJOR;
+			}
+
+			// only meaningful against a baseline from the same seed and op count, reordered float math moves the last few digits
+			double checksumScale = fabs(baselineResult->m_checksum) > 1.0 ? fabs(baselineResult->m_checksum) : 1.0;
+			if (fabs(result.m_checksum - baselineResult->m_checksum) > checksumScale * 0.0001)
+			{
+				line += "  RESULTS CHANGED";
+				color = DevConsole::INFO_ERROR;
+			}
+		}
+		g_theDevConsole->AddLine(color, line);
+	}
+
+	if (!savePath.empty())
+	{
+		if (SaveMathBenchmarkBaseline(savePath, config, results))
+		{
+			g_theDevConsole->AddLine(DevConsole::INFO_MINOR, Stringf("Saved math benchmark baseline to %s", savePath.c_str()));
+		}
+		else
+		{
+			g_theDevConsole->AddLine(DevConsole::INFO_ERROR, Stringf("Could not save math benchmark baseline to %s", savePath.c_str()));
+		}
+	}
+	return true;
+}
+
+
+static void GenerateMathBenchmarkInputs(MathBenchmarkInputs& inputs, unsigned int seed)
+{
+	RandomNumberGenerator rng(seed);
+	for (int i = 0; i < NUM_BENCHMARK_INPUTS; i++)
+	{
+		inputs.m_points2D[i] = Vec2(rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f));
+		inputs.m_otherPoints2D[i] = Vec2(rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f));
+		inputs.m_normals2D[i] = Vec2::MakeFromPolarDegrees(rng.RollRandomFloatInRange(0.f, 360.f));
+		inputs.m_points3D[i] = Vec3(rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f));
+		inputs.m_otherPoints3D[i] = Vec3(rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f));
+		inputs.m_normals3D[i] = Vec3(rng.RollRandomFloatInRange(-1.f, 1.f), rng.RollRandomFloatInRange(-1.f, 1.f), rng.RollRandomFloatInRange(-1.f, 1.f)).GetNormalized();
+		inputs.m_radii[i] = rng.RollRandomFloatInRange(0.5f, 3.f);
+		inputs.m_degrees[i] = rng.RollRandomFloatInRange(-360.f, 360.f);
+
+		Vec2 boxCenter2D(rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f));
+		Vec2 halfDimensions2D(rng.RollRandomFloatInRange(0.5f, 4.f), rng.RollRandomFloatInRange(0.5f, 4.f));
+		inputs.m_boxes2D[i] = AABB2(boxCenter2D - halfDimensions2D, boxCenter2D + halfDimensions2D);
+		inputs.m_orientedBoxes2D[i] = OBB2(boxCenter2D, Vec2::MakeFromPolarDegrees(rng.RollRandomFloatInRange(0.f, 360.f)), halfDimensions2D);
+
+		Vec2 boneStart(rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f));
+		Vec2 boneEnd = boneStart + Vec2::MakeFromPolarDegrees(rng.RollRandomFloatInRange(0.f, 360.f), rng.RollRandomFloatInRange(1.f, 6.f));
+		inputs.m_lines2D[i] = LineSegment2(boneStart, boneEnd);
+		inputs.m_capsules2D[i] = Capsule2(LineSegment2(boneStart, boneEnd), rng.RollRandomFloatInRange(0.5f, 2.f));
+
+		Vec3 boxCenter3D(rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f), rng.RollRandomFloatInRange(0.f, 20.f));
+		Vec3 halfDimensions3D(rng.RollRandomFloatInRange(0.5f, 4.f), rng.RollRandomFloatInRange(0.5f, 4.f), rng.RollRandomFloatInRange(0.5f, 4.f));
+		inputs.m_boxes3D[i] = AABB3(boxCenter3D - halfDimensions3D, boxCenter3D + halfDimensions3D);
+		inputs.m_lines3D[i] = LineSegment3(boxCenter3D, inputs.m_otherPoints3D[i]);
+
+		// rigid transforms, so the orthonormal inverse is valid on them too
+		Mat44 matrix = Mat44::CreateTranslation3D(inputs.m_otherPoints3D[i]);
+		matrix.AppendZRotation(rng.RollRandomFloatInRange(0.f, 360.f));
+		matrix.AppendYRotation(rng.RollRandomFloatInRange(-90.f, 90.f));
+		matrix.AppendXRotation(rng.RollRandomFloatInRange(0.f, 360.f));
+		inputs.m_matrices[i] = matrix;
+	}
+}
+
+
+static MathBenchmarkResult const* FindMathBenchmarkResult(std::vector<MathBenchmarkResult> const& results, std::string const& name)
+{
+	for (int resultIndex = 0; resultIndex < (int)results.size(); resultIndex++)
+	{
+		if (results[resultIndex].m_name == name)
+		{
+			return &results[resultIndex];
+		}
+	}
+	return nullptr;
+}
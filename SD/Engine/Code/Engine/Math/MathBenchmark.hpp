@@ -0,0 +1,36 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+
+#include <string>
+#include <vector>
+
+struct MathBenchmarkConfig
+{
+	int m_numOps = 500000;
+	// each primitive is timed this many times and the fastest run is kept, the slower ones are mostly the OS
+	int m_numRepeats = 5;
+	// same seed, same inputs, so numbers from different builds line up
+	unsigned int m_seed = 1;
+	// only primitives whose name contains this, empty runs everything
+	std::string m_filter;
+};
+
+
+struct MathBenchmarkResult
+{
+	std::string m_name;
+	double m_nanosecondsPerOp = 0.0;
+	double m_opsPerSecond = 0.0;
+	// sum of what the primitive returned, keeps the optimizer honest and shows when a rewrite changes the answers
+	double m_checksum = 0.0;
+};
+
+
+void RunMathBenchmarks(MathBenchmarkConfig const& config, std::vector<MathBenchmarkResult>& outResults);
+
+// <MathBenchmarks seed="1" ops="500000"> <Benchmark name="RaycastVsAABB3D" nsPerOp="12.3" checksum="..."/> ... </MathBenchmarks>
+bool SaveMathBenchmarkBaseline(std::string const& filePath, MathBenchmarkConfig const& config, std::vector<MathBenchmarkResult> const& results);
+bool LoadMathBenchmarkBaseline(std::string const& filePath, std::vector<MathBenchmarkResult>& outResults);
+
+// mathBenchmark ops=500000 repeats=5 seed=1 filter=Raycast save=Baseline.xml baseline=Baseline.xml
+bool Command_MathBenchmark(EventArgs& args);
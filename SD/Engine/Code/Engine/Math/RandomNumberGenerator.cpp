@@ -1,30 +1,39 @@
 #include "Engine/Math/RandomNumberGenerator.hpp"
+#include "ThirdParty/Squirrel/RawNoise.hpp"
 
 #include <stdlib.h>
 
+
+RandomNumberGenerator::RandomNumberGenerator(unsigned int seed)
+	: m_isSeeded(true)
+	, m_seed(seed)
+{
+}
+
+
 int RandomNumberGenerator::RollRandomIntLessThan(int maxNotInclusive)
 {
-	return rand() % maxNotInclusive;
+	return RollRandomRaw() % maxNotInclusive;
 }
 
 
 int RandomNumberGenerator::RollRandomIntInRange(int minInclusive, int maxInclusive)
 {
 	int range = maxInclusive - minInclusive + 1;
-	return (rand() % range) + minInclusive;
+	return (RollRandomRaw() % range) + minInclusive;
 }
 
 
 float RandomNumberGenerator::RollRandomFloatZeroToOneInclusive()
 {
-	return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+	return static_cast<float>(RollRandomRaw()) / static_cast<float>(RAND_MAX);
 }
 
 
 float RandomNumberGenerator::RollRandomFloatInRange(float minInclusive, float maxInclusive)
 {
 	float range = maxInclusive - minInclusive;
-	return (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * range + minInclusive;
+	return (static_cast<float>(RollRandomRaw()) / static_cast<float>(RAND_MAX)) * range + minInclusive;
 }
 
 
@@ -34,3 +43,13 @@ float RandomNumberGenerator::RollRandomFloatInFloatRange(FloatRange floatRange)
 }
 
 
+int RandomNumberGenerator::RollRandomRaw()
+{
+	if (!m_isSeeded)
+	{
+		return rand();
+	}
+	// every noise position is independent so a sequence is just position++, kept in the same 0 to RAND_MAX range as rand() so the rolls above work either way
+	return (int)(Get1dNoiseUint(static_cast<int>(m_position++), m_seed) % ((unsigned int)RAND_MAX + 1));
+}
+
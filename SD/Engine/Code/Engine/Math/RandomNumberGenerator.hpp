@@ -4,6 +4,10 @@
 class RandomNumberGenerator
 {
 public:
+	RandomNumberGenerator() {}
+	// seeded generators replay the same sequence every run and ignore srand, unseeded ones use rand()
+	explicit RandomNumberGenerator(unsigned int seed);
+
 	int RollRandomIntLessThan(int maxNotInclusive);
 	int RollRandomIntInRange(int minInclusive, int MaxInclusive);
 	float RollRandomFloatZeroToOneInclusive();
@@ -11,6 +15,10 @@ public:
 	float RollRandomFloatInFloatRange(FloatRange floatRange);
 
 private:
-	//unsigned int m_seed = 0;
-	//int m_position = 0;
+	int RollRandomRaw();
+
+private:
+	bool m_isSeeded = false;
+	unsigned int m_seed = 0;
+	unsigned int m_position = 0;
 };
\ No newline at end of file
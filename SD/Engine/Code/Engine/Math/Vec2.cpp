@@ -263,14 +263,15 @@ void Vec2::Reflect(Vec2 const& impactSurfaceNormal)
 }
 
 
-void Vec2::SetFromText(std::string const& text)
+void Vec2::SetFromText(StringView const& text)
 {
-	Strings tokens = SplitStringOnDelimiter(text, ',');
+	StringView tokens[2];
+	int numTokens = SplitStringOnDelimiter(text, ',', tokens, 2);
 
-	if (tokens.size() == 2)
+	if (numTokens == 2)
 	{
-		x = static_cast<float>(atof(tokens[0].c_str()));
-		y = static_cast<float>(atof(tokens[1].c_str()));
+		x = ParseFloatFromText(tokens[0]);
+		y = ParseFloatFromText(tokens[1]);
 	}
 	else
 	{
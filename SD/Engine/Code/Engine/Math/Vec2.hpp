@@ -1,5 +1,5 @@
 #pragma once
-#include <string>
+#include "Engine/Core/StringUtils.hpp"
 
 struct IntVec2;
 //-----------------------------------------------------------------------------------------------
@@ -56,7 +56,7 @@ public:
 	void Normalize();
 	float NormalizeAndGetPreviousLength();
 	void Reflect(Vec2 const& impactSurfaceNormal);
-	void SetFromText(std::string const& text);
+	void SetFromText(StringView const& text);
 
 	// Operators (const)
 	bool		operator==( const Vec2& compare ) const;		// vec2 == vec2
@@ -155,15 +155,16 @@ void Vec3::SetLength(float newLength)
 }
 
 
-void Vec3::SetFromText(std::string const& text)
+void Vec3::SetFromText(StringView const& text)
 {
-	Strings tokens = SplitStringOnDelimiter(text, ',');
+	StringView tokens[3];
+	int numTokens = SplitStringOnDelimiter(text, ',', tokens, 3);
 
-	if (tokens.size() == 3)
+	if (numTokens == 3)
 	{
-		x = static_cast<float>(atof(tokens[0].c_str()));
-		y = static_cast<float>(atof(tokens[1].c_str()));
-		z = static_cast<float>(atof(tokens[2].c_str()));
+		x = ParseFloatFromText(tokens[0]);
+		y = ParseFloatFromText(tokens[1]);
+		z = ParseFloatFromText(tokens[2]);
 	}
 	else
 	{
@@ -43,7 +43,7 @@ public:
 	Vec3 const GetNormalized() const;
 	Vec3 const GetReflected(Vec3 const& impactSurfaceNormal) const;
 	void SetLength(float newLength);
-	void SetFromText(std::string const& text);
+	void SetFromText(StringView const& text);
 
 	//Operators (const)
 	bool operator==(Vec3 const& compare) const;
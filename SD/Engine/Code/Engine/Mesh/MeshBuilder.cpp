@@ -1,10 +1,11 @@
 #include "Engine/Mesh/MeshBuilder.hpp"
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Compression.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
-#include <stdio.h>
+#include <string.h>
 
 MeshBuilder::MeshBuilder()
 {
@@ -28,30 +29,38 @@ bool MeshBuilder::ParseDataFromOBJFile(const std::string& filename, MeshBuilderC
 {
 	m_texturePath = config.m_texturePath;
 	m_vertices.clear();
-	std::string fileString;
-	int result = FileReadToString(fileString, filename);
-	if (result != 0) return false;
-	Strings lines = SplitStringOnDelimiter(fileString, '\n');
+	// lines and tokens are views into the mapped file, nothing is copied out of it
+	MappedFile file(filename);
+	if (!file.IsOpen()) return false;
+	StringView fileText((char const*)file.GetData(), (int)file.GetSize());
 
 	std::vector<Vec3> positions;
 	std::vector<Vec2> uvs;
 	std::vector<Vec3> normals;
 
-	int verticesEstimateCounts = static_cast<int>(0.1f * lines.size());
+	// about 30 bytes a line, a tenth of the lines for each attribute
+	int verticesEstimateCounts = static_cast<int>(file.GetSize() / 300);
 	positions.reserve(verticesEstimateCounts);
 	uvs.reserve(verticesEstimateCounts);
 	normals.reserve(verticesEstimateCounts);
 
 	// parsing file
-	for (std::string line : lines)
+	StringTokenizer lineTokenizer(fileText, '\n');
+	StringView line;
+	while (lineTokenizer.GetNextToken(line))
 	{
-		Strings tokens = SplitStringOnDelimiter(line, ' ');
-		std::string firstToken = tokens[0];
+		// the file is not read in text mode, so the \r of each line is still there
+		StringTokenizer tokenizer(line.GetTrimmed(), ' ');
+		StringView firstToken;
+		if (!tokenizer.GetNextToken(firstToken)) continue;
+
+		StringView tokens[4];
 		if (firstToken == "v") // add position
 		{
-			float x = static_cast<float>(atof(tokens[1].c_str()));
-			float y = static_cast<float>(atof(tokens[2].c_str()));
-			float z = static_cast<float>(atof(tokens[3].c_str()));
+			SplitStringOnDelimiter(tokenizer.GetRemainingText(), ' ', tokens, 3);
+			float x = ParseFloatFromText(tokens[0]);
+			float y = ParseFloatFromText(tokens[1]);
+			float z = ParseFloatFromText(tokens[2]);
 			Vec3 iBasis = config.m_transform.GetIBasis3D();
 			Vec3 jBasis = config.m_transform.GetJBasis3D();
 			Vec3 kBasis = config.m_transform.GetKBasis3D();
@@ -62,8 +71,9 @@ bool MeshBuilder::ParseDataFromOBJFile(const std::string& filename, MeshBuilderC
 		}
 		else if (firstToken == "vt") // add uv
 		{
-			float u = static_cast<float>(atof(tokens[1].c_str()));
-			float v = static_cast<float>(atof(tokens[2].c_str()));
+			SplitStringOnDelimiter(tokenizer.GetRemainingText(), ' ', tokens, 2);
+			float u = ParseFloatFromText(tokens[0]);
+			float v = ParseFloatFromText(tokens[1]);
 			if (config.m_invertedTextureV)
 			{
 				v = 1.f - v;
@@ -72,39 +82,50 @@ bool MeshBuilder::ParseDataFromOBJFile(const std::string& filename, MeshBuilderC
 		}
 		else if (firstToken == "vn") // add normal
 		{
-			float x = static_cast<float>(atof(tokens[1].c_str()));
-			float y = static_cast<float>(atof(tokens[2].c_str()));
-			float z = static_cast<float>(atof(tokens[3].c_str()));
+			SplitStringOnDelimiter(tokenizer.GetRemainingText(), ' ', tokens, 3);
+			float x = ParseFloatFromText(tokens[0]);
+			float y = ParseFloatFromText(tokens[1]);
+			float z = ParseFloatFromText(tokens[2]);
 			normals.emplace_back(x, y, z);
 		}
 		else if (firstToken == "f") // read face and add vertices and indices
 		{
-			std::vector<Vertex_PNCU> verticesForFace;
+			// only triangles and quads are added, so more than four corners are counted but not kept
+			Vertex_PNCU verticesForFace[4];
+			int numVerticesForFace = 0;
 			// read faces
-			for (int count = 1; count < (int)tokens.size(); count++)
+			StringView faceToken;
+			while (tokenizer.GetNextToken(faceToken))
 			{
-				Strings indices = SplitStringOnDelimiter(tokens[count], '/');
-				if (indices.size() == 1) // v
+				StringView indices[3];
+				int numIndices = SplitStringOnDelimiter(faceToken, '/', indices, 3);
+				Vertex_PNCU& vertex = verticesForFace[numVerticesForFace < 4 ? numVerticesForFace : 3];
+				if (numIndices == 1) // v
+				{
+					int positionIndex = ParseIntFromText(indices[0]) - 1;
+					vertex = Vertex_PNCU(positions[positionIndex], Vec3::ZERO, Rgba8::WHITE, Vec2::ZERO);
+				}
+				else if (numIndices == 2) // v/vt
 				{
-					int positionIndex = atoi(indices[0].c_str()) - 1;
-					verticesForFace.emplace_back(positions[positionIndex], Vec3::ZERO, Rgba8::WHITE, Vec2::ZERO);
+					int positionIndex = ParseIntFromText(indices[0]) - 1;
+					int uvIndex = ParseIntFromText(indices[1]) - 1;
+					vertex = Vertex_PNCU(positions[positionIndex], Vec3::ZERO, Rgba8::WHITE, uvs[uvIndex]);
 				}
-				else if (indices.size() == 2) // v/vt
+				else if (numIndices == 3) // v/vt/vn
 				{
-					int positionIndex = atoi(indices[0].c_str()) - 1;
-					int uvIndex = atoi(indices[1].c_str()) - 1;
-					verticesForFace.emplace_back(positions[positionIndex], Vec3::ZERO, Rgba8::WHITE, uvs[uvIndex]);
+					int positionIndex = ParseIntFromText(indices[0]) - 1;
+					int uvIndex = ParseIntFromText(indices[1]) - 1;
+					int normalIndex = ParseIntFromText(indices[2]) - 1;
+					vertex = Vertex_PNCU(positions[positionIndex], normals[normalIndex], Rgba8::WHITE, uvs[uvIndex]);
 				}
-				else if (indices.size() == 3) // v/vt/vn
+				else
 				{
-					int positionIndex = atoi(indices[0].c_str()) - 1;
-					int uvIndex = atoi(indices[1].c_str()) - 1;
-					int normalIndex = atoi(indices[2].c_str()) - 1;
-					verticesForFace.emplace_back(positions[positionIndex], normals[normalIndex], Rgba8::WHITE, uvs[uvIndex]);
+					continue;
 				}
+				numVerticesForFace++;
 			}
 
-			if (verticesForFace.size() == 3)
+			if (numVerticesForFace == 3)
 			{
 				if (config.m_reversedWinding)
 				{
@@ -119,7 +140,7 @@ bool MeshBuilder::ParseDataFromOBJFile(const std::string& filename, MeshBuilderC
 					m_vertices.push_back(verticesForFace[2]);
 				}
 			}
-			else if (verticesForFace.size() == 4)
+			else if (numVerticesForFace == 4)
 			{
 				if (config.m_reversedWinding)
 				{
@@ -148,36 +169,24 @@ bool MeshBuilder::ParseDataFromOBJFile(const std::string& filename, MeshBuilderC
 
 bool MeshBuilder::SaveToBinaryFile(const std::string& filename)
 {
-	std::FILE* file = nullptr;
-	fopen_s(&file, filename.c_str(), "wb");
-	if (file)
-	{
-		size_t size = m_vertices.size();
-		fwrite(&size, sizeof(size_t), 1, file);
-		fwrite(m_vertices.data(), sizeof(Vertex_PNCU), m_vertices.size(), file);
-		fclose(file);
-		return true;
-	}
-
-	return false;
+	// one compressed frame of the vertices, the count comes back from its size
+	std::vector<uint8_t> frame;
+	CompressFrame(m_vertices.data(), (int)(m_vertices.size() * sizeof(Vertex_PNCU)), frame);
+	return FileWriteFromBuffer(frame, filename) == 0;
 }
 
 
 bool MeshBuilder::ReadFromBinaryFile(const std::string& filename)
 {
-	std::FILE* file = nullptr;
-	fopen_s(&file, filename.c_str(), "rb");
-	if (file)
+	std::vector<uint8_t> vertexBytes;
+	if (FileReadCompressedToBuffer(vertexBytes, filename) != 0 || vertexBytes.size() % sizeof(Vertex_PNCU) != 0)
 	{
-		size_t size = 0;
-		fread(&size, sizeof(size_t), 1, file);
-		m_vertices.resize(size);
-		fread(m_vertices.data(), sizeof(Vertex_PNCU), size, file);
-		fclose(file);
-		return true;
+		return false;
 	}
 
-	return false;
+	m_vertices.resize(vertexBytes.size() / sizeof(Vertex_PNCU));
+	memcpy(m_vertices.data(), vertexBytes.data(), vertexBytes.size());
+	return true;
 }
 
 
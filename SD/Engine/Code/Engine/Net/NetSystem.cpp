@@ -15,6 +15,7 @@ NetSystem::~NetSystem()
 
 void NetSystem::Startup()
 {
+	MEMORY_TAG_SCOPE(m_config.m_memoryTag);
 	WORD version = MAKEWORD(2, 2);
 	WSADATA data;
 
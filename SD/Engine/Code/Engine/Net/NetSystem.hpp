@@ -5,9 +5,11 @@
 #include <WinSock2.h>
 
 #include "Engine/Net/NetCommon.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 
 struct NetSystemConfig
 {
+	MemoryTag m_memoryTag = MEMORY_TAG_NET;
 };
 
 class NetSystem
@@ -1,6 +1,7 @@
 #include "Engine/Net/RemoteConsole.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 
 #include <iostream>
 #include <Winsock2.h>
@@ -14,7 +15,8 @@ RemoteConsole::RemoteConsole(RemoteConsoleConfig const& config)
 
 
 void RemoteConsole::Startup()
-{	
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_NET);
 	SubscribeEventCallbackFunction("RCLeave", Command_RCLeave);
 	SubscribeEventCallbackFunction("RCJoin", Command_RCJoin);
 	SubscribeEventCallbackFunction("RCHost", Command_RCHost);
@@ -40,6 +42,7 @@ void RemoteConsole::Startup()
 
 void RemoteConsole::BeginFrame()
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_NET);
 	if (m_state == State::Disconnected)
 	{
 		NetAddress loopback = NetAddress::GetLoopBack(REMOTE_CONSOLE_PORT);
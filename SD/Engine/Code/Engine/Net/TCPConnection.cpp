@@ -1,5 +1,6 @@
 #include "Engine/Net/TCPConnection.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Compression.hpp"
 
 #include <winsock2.h>
 
@@ -147,7 +148,7 @@ bool TCPConnection::ReceiveFull(void* data)
 	{
 		size_t recvd = Receive(m_buffer + m_bytesRead, m_bytesRemain);
 		m_bytesRead += recvd;
-		m_bytesRemain -= m_bytesRead;
+		m_bytesRemain -= recvd;
 		return false;
 	}
 }
@@ -174,6 +175,42 @@ size_t TCPConnection::Receive(void* data, size_t const maxDataSize)
 	}
 }
 
+size_t TCPConnection::SendCompressed(void const* data, size_t const dataSize)
+{
+	std::vector<unsigned char> message(2);
+	CompressFrame(data, (int)dataSize, message);
+	size_t frameSize = message.size() - 2;
+	if (frameSize > BUFFER_SIZE)
+	{
+		return 0;
+	}
+
+	u_short networkFrameSize = ::htons(static_cast<u_short>(frameSize));
+	memcpy(message.data(), &networkFrameSize, 2);
+	return Send(message.data(), message.size());
+}
+
+
+bool TCPConnection::ReceiveFullCompressed(std::vector<unsigned char>& outData)
+{
+	// ReceiveFull clears the count as it hands the message over, so it is read first
+	size_t frameSize = m_bytesRead;
+	char frame[BUFFER_SIZE];
+	if (!ReceiveFull(frame))
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> data;
+	if (DecompressFrame(reinterpret_cast<unsigned char const*>(frame), (int)frameSize, data) < 0)
+	{
+		return false;
+	}
+	outData.swap(data);
+	return true;
+}
+
+
 std::string TCPConnection::GetHistory() const
 {
 	return m_history;
@@ -2,6 +2,8 @@
 #include "Engine/Net/TCPSocket.hpp"
 #include "Engine/Net/NetAddress.hpp"
 
+#include <vector>
+
 constexpr int BUFFER_SIZE = 4096;
 
 enum class ConnectionState
@@ -23,6 +25,10 @@ public:
 	size_t Send(void const* data, size_t const dataSize);
 	bool ReceiveFull(void* data);
 	size_t Receive(void* data, size_t const maxDataSize);
+	// one whole message, the 2 byte size and a compressed frame, 0 if the frame does not fit in BUFFER_SIZE
+	size_t SendCompressed(void const* data, size_t const dataSize);
+	// ReceiveFull for a message from SendCompressed, outData is replaced once the whole message is in and passes its checksum
+	bool ReceiveFullCompressed(std::vector<unsigned char>& outData);
 
 	std::string GetHistory() const;
 	void SetHistory(std::string const& history);
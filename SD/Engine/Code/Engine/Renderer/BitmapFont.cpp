@@ -1,5 +1,6 @@
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Core/Image.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 
 BitmapFont::BitmapFont(char const* fontFilePath, Texture const& fontTexture, bool hasMetadata)
 	: m_fontFilePathName(fontFilePath)
@@ -31,7 +32,8 @@ Texture const& BitmapFont::GetTexture() const
 }
 
 
-void BitmapFont::AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, Vec2 const& textMins, float cellHeight, std::string const& text, Rgba8 const& tint, float cellAspect)
+template <typename VertexArray>
+void BitmapFont::AddVertsForText2D(VertexArray& vertexArray, Vec2 const& textMins, float cellHeight, std::string const& text, Rgba8 const& tint, float cellAspect)
 {
 	float currentWidth = 0.f;
 	if (!m_hasMetadata)
@@ -84,7 +86,8 @@ void BitmapFont::AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, Vec2 co
 }
 
 
-void BitmapFont::AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, AABB2 const& box, float cellHeight, std::string const& text, 
+template <typename VertexArray>
+void BitmapFont::AddVertsForTextInBox2D(VertexArray& vertexArray, AABB2 const& box, float cellHeight, std::string const& text, 
 	Rgba8 const& tint, float cellAspect, Vec2 const& alignment, TextBoxMode mode, int maxGlyphsToDraw)
 {
 
@@ -362,3 +365,9 @@ float BitmapFont::GetGlyphAspect(int glyphUnicode) const
 }
 
 
+template void BitmapFont::AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, Vec2 const& textMins, float cellHeight, std::string const& text, Rgba8 const& tint, float cellAspect);
+template void BitmapFont::AddVertsForText2D(FrameVector<Vertex_PCU>& vertexArray, Vec2 const& textMins, float cellHeight, std::string const& text, Rgba8 const& tint, float cellAspect);
+template void BitmapFont::AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, AABB2 const& box, float cellHeight, std::string const& text,
+	Rgba8 const& tint, float cellAspect, Vec2 const& alignment, TextBoxMode mode, int maxGlyphsToDraw);
+template void BitmapFont::AddVertsForTextInBox2D(FrameVector<Vertex_PCU>& vertexArray, AABB2 const& box, float cellHeight, std::string const& text,
+	Rgba8 const& tint, float cellAspect, Vec2 const& alignment, TextBoxMode mode, int maxGlyphsToDraw);
@@ -46,9 +46,12 @@ private:
 public:
 	Texture const& GetTexture() const;
 
-	void AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, Vec2 const& textMins,
+	// instantiated for std::vector<Vertex_PCU> and FrameVector<Vertex_PCU>
+	template <typename VertexArray>
+	void AddVertsForText2D(VertexArray& vertexArray, Vec2 const& textMins,
 		float cellHeight, std::string const& text, Rgba8 const& tint = Rgba8::WHITE, float cellAspect = 1.f);
-	void AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, AABB2 const& box, float cellHeight,
+	template <typename VertexArray>
+	void AddVertsForTextInBox2D(VertexArray& vertexArray, AABB2 const& box, float cellHeight,
 		std::string const& text, Rgba8 const& tint = Rgba8::WHITE, float cellAspect = 1.f,
 		Vec2 const& alignment = Vec2(.5f, .5f), TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT, int maxGlyphsToDraw = INT_MAX);
 	float GetTextWidth(float cellHeight, std::string const& text, float cellAspect = 1.f);
@@ -1,6 +1,7 @@
 #include "Engine/Renderer/DebugRenderer.hpp"
 #include "Engine/Renderer/DebugShape.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Renderer/BillBoard.hpp"
 #include "Engine/Window/Window.hpp"
 
@@ -125,7 +126,16 @@ void DebugRenderer::RenderScreen(Camera const& camera)
 	//Vec2 screenDimensions(1600.f, 800.f);
 	Vec2 screenDimensions = camera.GetOrthoTopRight();
 	float cellHeight = screenDimensions.y / DEBUG_MESSAGE_LINES;
-	std::vector<Vertex_PCU> messageVerts;
+	size_t numberGlyphs = 0;
+	for (int messageIndex = 0; messageIndex < (int)m_debugMessages.size(); messageIndex++)
+	{
+		if (m_debugMessages[messageIndex])
+		{
+			numberGlyphs += m_debugMessages[messageIndex]->m_messgae.size();
+		}
+	}
+	FrameVector<Vertex_PCU> messageVerts;
+	messageVerts.reserve(6 * numberGlyphs);
 	float lineCounter = 0.f;
 	BitmapFont& font = GetBitmapFont();
 	for (int messageIndex = 0; messageIndex < (int)m_debugMessages.size(); messageIndex++)
@@ -39,6 +39,7 @@ Renderer::~Renderer()
 
 void Renderer::Startup()
 {
+	MEMORY_TAG_SCOPE(m_config.m_memoryTag);
 #ifdef ENGINE_DEBUG_RENDER
 	m_dxgiDebugModule = (void*) ::LoadLibraryA("dxgidebug.dll");
 	typedef HRESULT(WINAPI* GetDebugModuleCB)(REFIID, void**);
@@ -76,7 +77,10 @@ void Renderer::BeginFrame()
 void Renderer::EndFrame()
 {
 	DebugRenderEndFrame();
-	m_swapChain->Present(0, 0);
+	if (m_swapChain)
+	{
+		m_swapChain->Present(0, 0);
+	}
 
 	CopyTexture(m_backBuffer, GetActiveColorTarget());
 }
@@ -356,7 +360,15 @@ void Renderer::CreateRenderContext()
 
 	D3D_DRIVER_TYPE driverType = D3D_DRIVER_TYPE_HARDWARE;
 	UINT sdkVersion = D3D11_SDK_VERSION;
-	HRESULT hr = D3D11CreateDeviceAndSwapChain(NULL, driverType, NULL, swapChainDesc.Flags, NULL, NULL, sdkVersion, &swapChainDesc, &m_swapChain, &m_device, NULL, &m_deviceContext);
+	HRESULT hr = S_OK;
+	if (m_config.m_isHeadless)
+	{
+		hr = D3D11CreateDevice(NULL, D3D_DRIVER_TYPE_WARP, NULL, swapChainDesc.Flags, NULL, NULL, sdkVersion, &m_device, NULL, &m_deviceContext);
+	}
+	else
+	{
+		hr = D3D11CreateDeviceAndSwapChain(NULL, driverType, NULL, swapChainDesc.Flags, NULL, NULL, sdkVersion, &swapChainDesc, &m_swapChain, &m_device, NULL, &m_deviceContext);
+	}
 	if (!SUCCEEDED(hr))
 	{
 		DebuggerPrintf("D3D11 Create Device Failed.");
@@ -383,6 +395,7 @@ void Renderer::CreateRenderContext()
 
 Texture* Renderer::CreateOrGetTextureFromFile(const char* imageFilePath)
 {
+	MEMORY_TAG_SCOPE(m_config.m_memoryTag);
 	Texture* existingTexture = GetTextureForFileName(imageFilePath);
 	if (existingTexture) return existingTexture;
 
@@ -392,6 +405,7 @@ Texture* Renderer::CreateOrGetTextureFromFile(const char* imageFilePath)
 
 BitmapFont* Renderer::CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNoExtension)
 {
+	MEMORY_TAG_SCOPE(m_config.m_memoryTag);
 	std::string appendPNG = std::string(bitmapFontFilePathWithNoExtension) + ".png";
 	BitmapFont* existingFont = GetBitmapFontForFileName(appendPNG.c_str());
 	if (existingFont) return existingFont;
@@ -402,6 +416,7 @@ BitmapFont* Renderer::CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNo
 
 BitmapFont* Renderer::CreateOrGetBitmapFontWithMetadata(const char* fontTexturePathWithNoExtension, const char* fontMetadataPath)
 {
+	MEMORY_TAG_SCOPE(m_config.m_memoryTag);
 	std::string appendPNG = std::string(fontTexturePathWithNoExtension) + ".png";
 	BitmapFont* existingFont = GetBitmapFontForFileName(appendPNG.c_str());
 	if (existingFont) return existingFont;
@@ -411,6 +426,7 @@ BitmapFont* Renderer::CreateOrGetBitmapFontWithMetadata(const char* fontTextureP
 
 Shader* Renderer::CreateOrGetShader(const char* shaderName)
 {
+	MEMORY_TAG_SCOPE(m_config.m_memoryTag);
 	Shader* existingShader = GetShaderForName(shaderName);
 	if (existingShader) return existingShader;
 
@@ -420,6 +436,7 @@ Shader* Renderer::CreateOrGetShader(const char* shaderName)
 
 Mesh* Renderer::CreateOrGetMeshFromConfig(const char* meshName, MeshBuilderConfig const& config)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_MESHES);
 	Mesh* existingMesh = GetMeshForName(meshName);
 	if (existingMesh) return existingMesh;
 
@@ -1014,6 +1031,25 @@ void Renderer::DestroyTexture(Texture* texture)
 
 void Renderer::CreateBackBuffer()
 {
+	TextureCreateInfo info;
+	info.dimensions = IntVec2(m_config.m_window->GetClientDimensions());
+	info.format = TextureFormat::R8G8B8A8_UNORM;
+	info.bindFlags = TEXTURE_BIND_RENDER_TARGET_BIT;
+	info.memoryHint = MemoryHint::GPU;
+
+	// nothing to present to, the back buffer is just another render target
+	if (!m_swapChain)
+	{
+		info.name = "HeadlessBackBuffer";
+		m_backBuffer = CreateTextureFromInfo(info);
+
+		info.name = "DefaultColor";
+		info.bindFlags |= TEXTURE_BIND_SHADER_RESOURCE_BIT;
+		m_defaultColorTarget[0] = CreateTextureFromInfo(info);
+		m_defaultColorTarget[1] = CreateTextureFromInfo(info);
+		return;
+	}
+
 	ID3D11Texture2D* texture2D = nullptr;
 	HRESULT hr = m_swapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (void**)&texture2D);
 	if (!SUCCEEDED(hr))
@@ -1025,13 +1061,8 @@ void Renderer::CreateBackBuffer()
 	D3D11_TEXTURE2D_DESC texture2DDesc = { 0 };
 	texture2D->GetDesc(&texture2DDesc);
 
-	TextureCreateInfo info;
 	info.name = "Swapchain";
-	info.dimensions = IntVec2(m_config.m_window->GetClientDimensions());
 	ASSERT_OR_DIE(texture2DDesc.Format == DXGI_FORMAT_R8G8B8A8_UNORM, "swap chain isn't R8G8B8A8");
-	info.format = TextureFormat::R8G8B8A8_UNORM;
-	info.bindFlags = TEXTURE_BIND_RENDER_TARGET_BIT;
-	info.memoryHint = MemoryHint::GPU;
 	info.handle = texture2D;
 	m_backBuffer = CreateTextureFromInfo(info);
 
@@ -3,6 +3,7 @@
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Core/Vertex_PNCU.hpp"
 #include "Engine/Core/Image.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 #include "Engine/Mesh/MeshBuilder.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/Texture.hpp"
@@ -98,6 +99,9 @@ struct ModelConstant
 struct RendererConfig
 {
 	Window* m_window = nullptr;
+	MemoryTag m_memoryTag = MEMORY_TAG_RENDERER;
+	// software WARP device without a swap chain, resources still get created so game code runs unchanged
+	bool m_isHeadless = false;
 };
 
 class Renderer
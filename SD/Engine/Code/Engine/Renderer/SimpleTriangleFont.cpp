@@ -7,6 +7,7 @@
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 
 //------------------------------------------------------------------------------------------------
 // A simple utility file for creating basic 5x9 pixel fonts out of pure triangles, i.e. does not
@@ -63,7 +64,8 @@ const char* g_triTextFontData[ TRITEXT_NUM_ROWS ] =
 
 
 //------------------------------------------------------------------------------------------------
-void AddVertsForGlyphTriangles2D( std::vector<Vertex_PCU>& verts, char glyph, const Vec2& cellMins, const Vec2& pixelSize, const Rgba8& color )
+template <typename VertexArray>
+void AddVertsForGlyphTriangles2D( VertexArray& verts, char glyph, const Vec2& cellMins, const Vec2& pixelSize, const Rgba8& color )
 {
 	if( glyph < TRITEXT_FIRST_ASCII || glyph > TRITEXT_LAST_ASCII )
 		return;
@@ -91,7 +93,8 @@ void AddVertsForGlyphTriangles2D( std::vector<Vertex_PCU>& verts, char glyph, co
 
 
 //------------------------------------------------------------------------------------------------
-void AddVertsForTextTriangles2D( std::vector<Vertex_PCU>& verts, const std::string& text, const Vec2& startMins, float cellHeight, const Rgba8& color, float cellAspect, bool isFlipped, float spacingFraction )
+template <typename VertexArray>
+void AddVertsForTextTriangles2D( VertexArray& verts, const std::string& text, const Vec2& startMins, float cellHeight, const Rgba8& color, float cellAspect, bool isFlipped, float spacingFraction )
 {
 	// #ToDo: Support flipped triangle fonts (e.g. when +Y is down)
 	UNUSED(isFlipped);
@@ -133,3 +136,6 @@ float GetSimpleTriangleStringWidth( const std::string& text, float cellHeight, f
 }
 
 
+//------------------------------------------------------------------------------------------------
+template void AddVertsForTextTriangles2D( std::vector<Vertex_PCU>& verts, const std::string& text, const Vec2& startMins, float cellHeight, const Rgba8& color, float cellAspect, bool isFlipped, float spacingFraction );
+template void AddVertsForTextTriangles2D( FrameVector<Vertex_PCU>& verts, const std::string& text, const Vec2& startMins, float cellHeight, const Rgba8& color, float cellAspect, bool isFlipped, float spacingFraction );
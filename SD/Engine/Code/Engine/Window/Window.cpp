@@ -233,12 +233,19 @@ Window::~Window()
 void Window::Startup()
 	
 {
+	if (m_config.m_isHeadless)
+	{
+		int clientHeight = m_config.m_headlessClientHeight;
+		m_windowDimensions = IntVec2(static_cast<int>(static_cast<float>(clientHeight) * m_config.m_clientAspect), clientHeight);
+		return;
+	}
 	CreateOSWindow();
 }
 
 
 void Window::BeginFrame()
 {
+	if (m_config.m_isHeadless) return;
 	RunMessagePump();
 }
 
@@ -269,6 +276,8 @@ Window* Window::GetWindowContext()
 
 Vec2 Window::GetNormalizedCursorPos() const
 {
+	if (!m_osWindowHandle) return Vec2(0.5f, 0.5f);
+
 	HWND windowHandle = HWND(m_osWindowHandle);
 	POINT cursorCoords;
 	RECT clientRect;
@@ -295,10 +304,18 @@ float Window::GetAspect() const
 
 bool Window::HasFocus() const
 {
+	// GetActiveWindow is null too when some other app has focus
+	if (!m_osWindowHandle) return false;
 	return GetOSWindowHandle() == ::GetActiveWindow();
 }
 
 
+bool Window::IsHeadless() const
+{
+	return m_config.m_isHeadless;
+}
+
+
 void Window::CreateOSWindow()
 {
 	// Define a window style/class
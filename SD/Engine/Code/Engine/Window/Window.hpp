@@ -10,6 +10,9 @@ struct WindowConfig
 	std::string m_windowTitle = "Untitled App";
 	float m_clientAspect = 2.0f;
 	bool m_isFullscreen = false;
+	// no OS window or message pump, the client area is only a size for render targets and cameras
+	bool m_isHeadless = false;
+	int m_headlessClientHeight = 720;
 };
 
 
@@ -31,6 +34,7 @@ public:
 	IntVec2 GetClientDimensions() const;
 	float GetAspect() const;
 	bool HasFocus() const;
+	bool IsHeadless() const;
 
 protected:
 	void CreateOSWindow();
@@ -2,6 +2,7 @@
 #include "Game/DatabaseClient.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Window/Window.hpp"
@@ -84,6 +85,7 @@ void App::Startup()
 	g_theDevConsole->Startup();
 	g_theClient->Startup();
 	g_theEventSystem->Startup();
+	FrameArenaStartup();
 	g_theInput->Startup();
 	g_theWindow->Startup();
 	g_theRenderer->Startup();
@@ -123,6 +125,7 @@ void App::Shutdown()
 	g_theInput->ShutDown();
 	g_theClient->Shutdown();
 	g_theDevConsole->ShutDown();
+	FrameArenaShutdown();
 	g_theEventSystem->ShutDown();
 	g_theNet->Shutdown();
 
@@ -190,6 +193,7 @@ void App::HandleQuitRequested()
 
 void App::BeginFrame()
 {
+	FrameArenaBeginFrame();
 	g_theNet->BeginFrame();
 	g_theDevConsole->BeginFrame();
 	g_theClient->BeginFrame();
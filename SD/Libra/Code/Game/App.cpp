@@ -2,16 +2,22 @@
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Window/Window.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/Benchmark.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
 #include <thread>
 #include "ThirdParty/TinyXML2/tinyxml2.h"
 #include "Engine/Renderer/SimpleTriangleFont.hpp"
 
+constexpr int DEFAULT_BENCHMARK_FRAMES = 1200;
+constexpr int DEFAULT_BENCHMARK_WARMUP_FRAMES = 60;
+
 Window* g_theWindow;
 Renderer* g_theRenderer;
 AudioSystem* g_theAudio;
@@ -20,6 +26,8 @@ static float screenCameraSizeX = 0.f;
 static float screenCameraSizeY = 0.f;
 AABB2 windowBounds;
 
+static std::vector<ScriptedInputEvent> GetDefaultBenchmarkInput(int numFrames);
+
 App::App()
 {
 
@@ -37,12 +45,14 @@ App::~App()
 }
 
 
-void App::Startup()
+void App::Startup(char const* commandLine)
 {
 	XmlDocument doc;
 	doc.LoadFile("Data/GameConfig.xml");
 	XmlElement* element = doc.RootElement();
 	g_gameConfigBlackboard.PopulateFromXmlElementAttributes(*element);
+	g_gameConfigBlackboard.PopulateFromCommandLine(commandLine);
+	m_isHeadless = g_gameConfigBlackboard.GetValue("headless", false);
 	screenCameraSizeX = g_gameConfigBlackboard.GetValue("screenCameraDimensionX", 20.f);
 	screenCameraSizeY = g_gameConfigBlackboard.GetValue("screenCameraDimensionY", 10.f);
 	windowBounds.SetDimensions(Vec2(screenCameraSizeX, screenCameraSizeY));
@@ -66,10 +76,12 @@ void App::Startup()
 	windowConfig.m_windowTitle = g_gameConfigBlackboard.GetValue("gameTitle", windowConfig.m_windowTitle);
 	windowConfig.m_clientAspect = g_gameConfigBlackboard.GetValue("windowAspect", windowConfig.m_clientAspect);
 	windowConfig.m_inputSystem = g_theInput;
+	windowConfig.m_isHeadless = m_isHeadless;
 	g_theWindow = new Window(windowConfig);
 
 	RendererConfig renderConfig;
 	renderConfig.m_window = g_theWindow;
+	renderConfig.m_isHeadless = m_isHeadless;
 	g_theRenderer = new Renderer(renderConfig);
 
 	DevConsoleConfig devConsoleConfig;
@@ -78,14 +90,26 @@ void App::Startup()
 	g_theDevConsole = new DevConsole(devConsoleConfig);
 
 	AudioSystemConfig audioSystemConfig;
+	audioSystemConfig.m_isHeadless = m_isHeadless;
 	g_theAudio = new AudioSystem(audioSystemConfig);
 
+	ProfilerConfig profilerConfig;
+	profilerConfig.m_renderer = g_theRenderer;
+	if (m_isHeadless)
+	{
+		// the benchmark reads its scope timings from the history, so it has to hold every frame of the run
+		profilerConfig.m_historyFrames = g_gameConfigBlackboard.GetValue("benchmarkFrames", DEFAULT_BENCHMARK_FRAMES) + g_gameConfigBlackboard.GetValue("benchmarkWarmupFrames", DEFAULT_BENCHMARK_WARMUP_FRAMES);
+	}
+	g_theProfiler = new Profiler(profilerConfig);
+
 	g_theDevConsole->Startup();
 	g_theEventSystem->Startup();
+	FrameArenaStartup();
 	g_theInput->Startup();
 	g_theWindow->Startup();
 	g_theRenderer->Startup();
 	g_theAudio->Startup();
+	g_theProfiler->Startup();
 
 	SubscribeEventCallbackFunction("QuitApp", QuitApp);
 
@@ -107,16 +131,20 @@ void App::RunFrame()
 
 void App::Shutdown()
 {
+	g_theProfiler->ShutDown();
 	g_theAudio->Shutdown();
 	g_theRenderer->Shutdown();
 	g_theWindow->Shutdown();
 	g_theInput->ShutDown();
 	g_theDevConsole->ShutDown();
+	FrameArenaShutdown();
 	g_theEventSystem->ShutDown();
 
 	delete m_theGame;
 	m_theGame = nullptr;
 
+	delete g_theProfiler;
+	g_theProfiler = nullptr;
 	delete g_theAudio;
 	g_theAudio = nullptr;
 	delete g_theRenderer;
@@ -134,6 +162,12 @@ void App::Shutdown()
 
 void App::Run()
 {
+	if (m_isHeadless)
+	{
+		RunBenchmark();
+		return;
+	}
+
 	while (!g_isQuitting)
 	{
 		RunFrame();
@@ -194,6 +228,8 @@ void App::HandleQuitRequested()
 
 void App::BeginFrame()
 {
+	g_theProfiler->BeginFrame();
+	FrameArenaBeginFrame();
 	g_theDevConsole->BeginFrame();
 	g_theEventSystem->BeginFrame();
 	g_theInput->BeginFrame();
@@ -206,6 +242,7 @@ void App::BeginFrame()
 
 void App::Update()
 {
+	PROFILE_SCOPE("Update");
 	HandleDeveloperCheatCode();
 	if (g_theDevConsole->IsOpen())
 	{
@@ -218,8 +255,10 @@ void App::Update()
 
 void App::Render() const
 {
+	PROFILE_SCOPE("Render");
 	m_theGame->Render();
 
+	g_theProfiler->Render(windowBounds);
 	g_theDevConsole->Render(windowBounds);
 }
 
@@ -232,11 +271,70 @@ void App::EndFrame()
 	g_theInput->EndFrame();
 	g_theEventSystem->EndFrame();
 	g_theDevConsole->EndFrame();
+	g_theProfiler->EndFrame();
 	//Sleep(1);
 	std::this_thread::yield();
 }
 
 
+void App::RunBenchmark()
+{
+	BenchmarkConfig benchmarkConfig;
+	benchmarkConfig.m_name = "Libra";
+	benchmarkConfig.m_numFrames = g_gameConfigBlackboard.GetValue("benchmarkFrames", DEFAULT_BENCHMARK_FRAMES);
+	benchmarkConfig.m_numWarmupFrames = g_gameConfigBlackboard.GetValue("benchmarkWarmupFrames", DEFAULT_BENCHMARK_WARMUP_FRAMES);
+	benchmarkConfig.m_outputFilePath = g_gameConfigBlackboard.GetValue("benchmarkOutput", "Benchmark_Libra.json");
+	benchmarkConfig.m_profiledScopes = { "Update", "Map Update", "Update Entities", "Push Entities", "Push Entities Out Of Walls", "Projectile Hits" };
+	BenchmarkRecorder benchmark(benchmarkConfig);
+
+	Clock::SetSystemFixedDeltaSeconds(g_gameConfigBlackboard.GetValue("benchmarkFixedDelta", 1.f / 60.f));
+	std::string inputScriptPath = g_gameConfigBlackboard.GetValue("inputScript", "");
+	if (inputScriptPath.empty())
+	{
+		g_theInput->SetInputScript(GetDefaultBenchmarkInput(benchmarkConfig.m_numWarmupFrames + benchmarkConfig.m_numFrames));
+	}
+	else if (!g_theInput->LoadInputScript(inputScriptPath))
+	{
+		ERROR_AND_DIE(Stringf("Could not load benchmark input script %s", inputScriptPath.c_str()));
+	}
+
+	while (!g_isQuitting && !benchmark.IsFinished())
+	{
+		benchmark.BeginFrame();
+		BeginFrame();
+		Update();
+		EndFrame();
+		benchmark.EndFrame();
+	}
+
+	m_theGame->AddBenchmarkCounters(benchmark);
+	if (!benchmark.WriteResults())
+	{
+		DebuggerPrintf("Could not write benchmark results to %s\n", benchmarkConfig.m_outputFilePath.c_str());
+	}
+	Clock::SetSystemFixedDeltaSeconds(0.0);
+}
+
+
+static std::vector<ScriptedInputEvent> GetDefaultBenchmarkInput(int numFrames)
+{
+	// start the game, turn on invulnerability so the run cannot end early, then drive around the map shooting
+	std::vector<ScriptedInputEvent> events;
+	events.push_back({ 1, 'P', true });
+	events.push_back({ 2, 'P', false });
+	events.push_back({ 5, KEYCODE_F2, true });
+	events.push_back({ 6, KEYCODE_F2, false });
+	events.push_back({ 10, KEYCODE_SPACE, true });
+	unsigned char const movementKeys[] = { 'E', 'F', 'D', 'S' };
+	for (int frame = 10, keyIndex = 0; frame < numFrames; frame += 120, keyIndex = (keyIndex + 1) % 4)
+	{
+		events.push_back({ frame, movementKeys[keyIndex], true });
+		events.push_back({ frame + 120, movementKeys[keyIndex], false });
+	}
+	return events;
+}
+
+
 static bool QuitApp(EventArgs& args)
 {
 	UNUSED(args)
@@ -8,7 +8,7 @@ class App
 public:
 	App();
 	~App();
-	void Startup();
+	void Startup(char const* commandLine);
 	void RunFrame();
 	void Shutdown();
 	void Run();
@@ -23,10 +23,13 @@ private:
 	void Update();
 	void Render() const;
 	void EndFrame();
+	// headless=true on the command line, fixed timestep and scripted input with nothing drawn, writes the frame timings as JSON
+	void RunBenchmark();
 
 private:
 	Game* m_theGame = nullptr;
 	double m_timeLastFrame = 0.0;
+	bool m_isHeadless = false;
 };
 
 static bool QuitApp(EventArgs& args);
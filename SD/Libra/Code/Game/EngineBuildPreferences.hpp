@@ -9,6 +9,7 @@
 //
 
 //#define ENGINE_DISABLE_AUDIO	// (If uncommented) Disables AudioSystem code and fmod linkage.
+//#define ENGINE_DISABLE_MEMORY_TRACKING	// (If uncommented) Leaves operator new/delete alone, memory tags and stats stay at zero.
 #define ENGINE_DEBUG_RENDER
 
 
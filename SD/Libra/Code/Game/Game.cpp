@@ -7,6 +7,7 @@
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/SimpleTriangleFont.hpp"
 #include "Engine/Renderer/SpriteAnimDefinition.hpp"
+#include "Engine/Core/Benchmark.hpp"
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -413,6 +414,13 @@ void Game::ResetGame()
 }
 
 
+void Game::AddBenchmarkCounters(BenchmarkRecorder& benchmark) const
+{
+	Map const* currentMap = m_currentWorld ? m_currentWorld->GetCurrentMap() : nullptr;
+	benchmark.SetCounter("liveEntities", currentMap ? currentMap->GetEntityCount() : 0.0);
+}
+
+
 void Game::LoadAssets()
 {
 	g_textures.resize(NUM_TEXTURE_TYPES);
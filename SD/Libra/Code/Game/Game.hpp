@@ -3,6 +3,8 @@
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Core/Clock.hpp"
 
+class BenchmarkRecorder;
+
 class Game
 {
 public:
@@ -25,6 +27,7 @@ public:
 	void DrawSelectTriangle(Vec2 pos, Rgba8 color) const;
 	void DrawVictoryScreen() const;
 	void DrawDefeatScreen() const;
+	void AddBenchmarkCounters(BenchmarkRecorder& benchmark) const;
 
 private:
 	App* m_theApp = nullptr;
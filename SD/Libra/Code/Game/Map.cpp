@@ -8,6 +8,8 @@
 #include "Game/World.hpp"
 #include "Engine/Window/Window.hpp"
 #include "Engine/Core/Image.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
+#include "Engine/Core/Profiler.hpp"
 
 RaycastResultLibra::RaycastResultLibra(Vec2 startPos, Vec2 forwardNorm, float maxDist, bool didImpact, Vec2 impactPos, float impactDist, Vec2 impactSurfaceNorm)
 	: RaycastResult2D(didImpact, impactPos, impactDist, impactSurfaceNorm, startPos, forwardNorm, maxDist)
@@ -87,6 +89,7 @@ void Map::Startup(Player* player)
 
 void Map::Update(float deltaSeconds)
 {
+	PROFILE_SCOPE("Map Update");
 	UpdatePlayerDuringFading(deltaSeconds);
 	UpdateEntities(deltaSeconds);
 	PushEntitiesOutOfEachOther(deltaSeconds);
@@ -395,6 +398,20 @@ Player* Map::GetPlayer() const
 }
 
 
+int Map::GetEntityCount() const
+{
+	int count = 0;
+	for (int entityIndex = 0; entityIndex < int(m_allEntities.size()); entityIndex++)
+	{
+		if (m_allEntities[entityIndex])
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+
 void Map::PopulateDistanceFieldForEntityPathToGoal(TileHeatMap& out_distanceField, float maxCost, Entity* e)
 {
 	out_distanceField.SetAllValues(maxCost);
@@ -642,6 +659,7 @@ void Map::UpdatePlayerDuringFading(float deltaSeconds)
 
 void Map::UpdateEntities(float deltaSeconds)
 {
+	PROFILE_SCOPE("Update Entities");
 	if (m_isPlayerDiscovered)
 	{
 		if (m_discoveryTimer >= m_discoveryDelay)
@@ -716,6 +734,7 @@ void Map::UpdateEntities(float deltaSeconds)
 
 void Map::PushEntitiesOutOfEachOther(float deltaSeconds)
 {
+	PROFILE_SCOPE("Push Entities");
 	UNUSED(deltaSeconds);
 
 	for (int entityAIndex = 0; entityAIndex < int(m_allEntities.size()); entityAIndex++)
@@ -744,6 +763,7 @@ void Map::PushEntitiesOutOfEachOther(float deltaSeconds)
 
 void Map::PushEntitiesOutOfWall(float deltaSeconds)
 {
+	PROFILE_SCOPE("Push Entities Out Of Walls");
 	UNUSED(deltaSeconds);
 
 	for (int entityIndex = 0; entityIndex < m_allEntities.size(); entityIndex++)
@@ -775,6 +795,7 @@ void Map::PushEntitiesOutOfWall(float deltaSeconds)
 
 void Map::CheckProjectileHits(float deltaSeconds)
 {
+	PROFILE_SCOPE("Projectile Hits");
 	UNUSED(deltaSeconds);
 
 	CheckProjectilesWithEntities(m_projectileListsByFaction[ENTITY_FACTION_GOOD], m_actorListsByFaction[ENTITY_FACTION_EVIL]);
@@ -1022,7 +1043,7 @@ void Map::RenderEntitiesHealth(EntityType entityTypeIndex) const
 
 void Map::RenderTiles() const
 {
-	std::vector<Vertex_PCU> verts;
+	FrameVector<Vertex_PCU> verts;
 	verts.reserve(6 * m_tiles.size());
 	g_theRenderer->BindTexture(&g_tileSpriteSheet->GetTexture());
 	for (int tileIndex = 0; tileIndex < int(m_tiles.size()); tileIndex++)
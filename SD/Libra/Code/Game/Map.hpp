@@ -49,6 +49,7 @@ public:
 	IntVec2 GetMapDimensions() const;
 	Player* SpawnPlayer();
 	Player* GetPlayer() const;
+	int GetEntityCount() const;
 	void PopulateDistanceFieldForEntityPathToGoal(TileHeatMap& out_distanceField, float maxCost, Entity* e);
 	std::vector<Vec2> GenerateEntityPathToGoal(TileHeatMap const& distanceField, IntVec2 const& goalCoords);
 	bool HasLineOfSight(Vec2 const& startPos, Vec2 const& targetPos);
@@ -61,3 +61,9 @@ void World::SpawnPlayer()
 }
 
 
+Map* World::GetCurrentMap() const
+{
+	return m_currentMap;
+}
+
+
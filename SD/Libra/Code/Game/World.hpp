@@ -15,6 +15,7 @@ public:
 	void Render() const;
 	void GoToNextLevel();
 	void SpawnPlayer();
+	Map* GetCurrentMap() const;
 
 private:
 	Game* m_game = nullptr;
@@ -1,26 +1,36 @@
 #include "Game/App.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Window/Window.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/Benchmark.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Game/ChunkGenerationJob.hpp"
+#include "Game/ChunkSkyLightingJob.hpp"
 
 #include <thread>
 
+constexpr int DEFAULT_BENCHMARK_FRAMES = 1200;
+constexpr int DEFAULT_BENCHMARK_WARMUP_FRAMES = 60;
+
 Window* g_theWindow;
 Renderer* g_theRenderer;
 AudioSystem* g_theAudio;
-JobSystem* g_theJobSystem;
 
 static float UICameraSizeX = 0.f;
 static float UICameraSizeY = 0.f;
 AABB2 windowBounds;
 
+static std::vector<ScriptedInputEvent> GetDefaultBenchmarkInput();
+
 App::App()
 {
 
@@ -38,12 +48,14 @@ App::~App()
 }
 
 
-void App::Startup()
+void App::Startup(char const* commandLine)
 {
 	XmlDocument doc;
 	doc.LoadFile("Data/GameConfig.xml");
 	XmlElement* element = doc.RootElement();
 	g_gameConfigBlackboard.PopulateFromXmlElementAttributes(*element);
+	g_gameConfigBlackboard.PopulateFromCommandLine(commandLine);
+	m_isHeadless = g_gameConfigBlackboard.GetValue("headless", false);
 	UICameraSizeX = g_gameConfigBlackboard.GetValue("UICameraDimensionX", 20.f);
 	UICameraSizeY = g_gameConfigBlackboard.GetValue("UICameraDimensionY", 10.f);
 	windowBounds.SetDimensions(Vec2(UICameraSizeX, UICameraSizeY));
@@ -69,10 +81,12 @@ void App::Startup()
 	windowConfig.m_windowTitle = g_gameConfigBlackboard.GetValue("gameTitle", "untitled game");
 	windowConfig.m_clientAspect = g_gameConfigBlackboard.GetValue("windowAspect", 1.f);
 	windowConfig.m_inputSystem = g_theInput;
+	windowConfig.m_isHeadless = m_isHeadless;
 	g_theWindow = new Window(windowConfig);
 
 	RendererConfig renderConfig;
 	renderConfig.m_window = g_theWindow;
+	renderConfig.m_isHeadless = m_isHeadless;
 	g_theRenderer = new Renderer(renderConfig);
 
 	DevConsoleConfig devConsoleConfig;
@@ -81,24 +95,41 @@ void App::Startup()
 	g_theDevConsole = new DevConsole(devConsoleConfig);
 
 	AudioSystemConfig audioSystemConfig;
+	audioSystemConfig.m_isHeadless = m_isHeadless;
 	g_theAudio = new AudioSystem(audioSystemConfig);
 
+	ProfilerConfig profilerConfig;
+	profilerConfig.m_renderer = g_theRenderer;
+	if (m_isHeadless)
+	{
+		// the benchmark reads its scope timings from the history, so it has to hold every frame of the run
+		profilerConfig.m_historyFrames = g_gameConfigBlackboard.GetValue("benchmarkFrames", DEFAULT_BENCHMARK_FRAMES) + g_gameConfigBlackboard.GetValue("benchmarkWarmupFrames", DEFAULT_BENCHMARK_WARMUP_FRAMES);
+	}
+	g_theProfiler = new Profiler(profilerConfig);
+
+	JobWorkerPoolConfig generationPoolConfig;
+	generationPoolConfig.m_name = "generation";
+	generationPoolConfig.m_numberWorkerThreads = std::thread::hardware_concurrency();
+	generationPoolConfig.m_jobTypes = CHUNK_GEN_JOB_TYPE | CHUNK_SKY_LIGHTING_JOB_TYPE;
+
 	JobSystemConfig jobSystemConfig;
-	jobSystemConfig.m_numberWorkerThreads = std::thread::hardware_concurrency();
+	jobSystemConfig.m_workerPools.push_back(generationPoolConfig);
 	g_theJobSystem = new JobSystem(jobSystemConfig);
+	g_theFileIOQueue = new FileIOQueue();
 
 	g_theDevConsole->Startup();
 	g_theEventSystem->Startup();
+	FrameArenaStartup();
+	MemoryTrackerStartup();
 	g_theInput->Startup();
 	g_theWindow->Startup();
 	g_theRenderer->Startup();
 	g_theAudio->Startup();
+	g_theProfiler->Startup();
 	g_theJobSystem->Startup();
-
-	for (int threadIndex = 0; threadIndex < jobSystemConfig.m_numberWorkerThreads; threadIndex++)
-	{
-		g_theJobSystem->SetJobTypeForWorker(threadIndex, CHUNK_GEN_JOB_TYPE);
-	}
+	g_theFileIOQueue->Startup();
+	g_theJobSystem->GetTelemetry().SetJobTypeName(CHUNK_GEN_JOB_TYPE, "ChunkGeneration");
+	g_theJobSystem->GetTelemetry().SetJobTypeName(CHUNK_SKY_LIGHTING_JOB_TYPE, "ChunkSkyLighting");
 
 	SubscribeEventCallbackFunction("QuitApp", Event_QuitApp);
 
@@ -121,18 +152,28 @@ void App::RunFrame()
 void App::Shutdown()
 {
 	g_theJobSystem->ShutDown();
+	g_theProfiler->ShutDown();
+	MemoryTrackerShutdown();
 	g_theAudio->Shutdown();
 	g_theRenderer->Shutdown();
 	g_theWindow->Shutdown();
 	g_theInput->ShutDown();
 	g_theDevConsole->ShutDown();
+	FrameArenaShutdown();
 	g_theEventSystem->ShutDown();
 
 	delete m_theGame;
 	m_theGame = nullptr;
 
+	// after the game, deleting the world queues the saves of every active chunk
+	g_theFileIOQueue->ShutDown();
+	delete g_theFileIOQueue;
+	g_theFileIOQueue = nullptr;
+
 	delete g_theJobSystem;
 	g_theJobSystem = nullptr;
+	delete g_theProfiler;
+	g_theProfiler = nullptr;
 	delete g_theAudio;
 	g_theAudio = nullptr;
 	delete g_theRenderer;
@@ -150,6 +191,12 @@ void App::Shutdown()
 
 void App::Run()
 {
+	if (m_isHeadless)
+	{
+		RunBenchmark();
+		return;
+	}
+
 	while (!g_isQuitting)
 	{
 		RunFrame();
@@ -185,6 +232,9 @@ void App::HandleQuitRequested()
 
 void App::BeginFrame()
 {
+	g_theProfiler->BeginFrame();
+	MemoryTrackerBeginFrame();
+	FrameArenaBeginFrame();
 	g_theDevConsole->BeginFrame();
 	g_theEventSystem->BeginFrame();
 	g_theInput->BeginFrame();
@@ -198,6 +248,7 @@ void App::BeginFrame()
 
 void App::Update()
 {
+	PROFILE_SCOPE("Update");
 	HandleDeveloperCheatCode();
 	if (g_theDevConsole->IsOpen())
 	{
@@ -210,9 +261,11 @@ void App::Update()
 
 void App::Render() const
 {
+	PROFILE_SCOPE("Render");
 	m_theGame->Render();
 
 	g_theRenderer->BeginCamera(m_devCamera);
+	g_theProfiler->Render(windowBounds);
 	g_theDevConsole->Render(windowBounds);
 	g_theRenderer->EndCamera(m_devCamera);
 }
@@ -227,10 +280,73 @@ void App::EndFrame()
 	g_theInput->EndFrame();
 	g_theEventSystem->EndFrame();
 	g_theDevConsole->EndFrame();
+	g_theProfiler->EndFrame();
 	std::this_thread::yield();
 }
 
 
+void App::RunBenchmark()
+{
+	BenchmarkConfig benchmarkConfig;
+	benchmarkConfig.m_name = "SimpleMiner";
+	benchmarkConfig.m_numFrames = g_gameConfigBlackboard.GetValue("benchmarkFrames", DEFAULT_BENCHMARK_FRAMES);
+	benchmarkConfig.m_numWarmupFrames = g_gameConfigBlackboard.GetValue("benchmarkWarmupFrames", DEFAULT_BENCHMARK_WARMUP_FRAMES);
+	benchmarkConfig.m_outputFilePath = g_gameConfigBlackboard.GetValue("benchmarkOutput", "Benchmark_SimpleMiner.json");
+	benchmarkConfig.m_profiledScopes = { "Update", "Chunk Activation", "Chunk Deactivation", "Retrieve Chunk Jobs", "Chunk Generation",
+		"Chunk Sky Lighting", "Chunk Rebuild", "Resolve Lighting", "Disk Load", "Disk Save" };
+	BenchmarkRecorder benchmark(benchmarkConfig);
+
+	Clock::SetSystemFixedDeltaSeconds(g_gameConfigBlackboard.GetValue("benchmarkFixedDelta", 1.f / 60.f));
+	std::string inputScriptPath = g_gameConfigBlackboard.GetValue("inputScript", "");
+	if (inputScriptPath.empty())
+	{
+		g_theInput->SetInputScript(GetDefaultBenchmarkInput());
+	}
+	else if (!g_theInput->LoadInputScript(inputScriptPath))
+	{
+		ERROR_AND_DIE(Stringf("Could not load benchmark input script %s", inputScriptPath.c_str()));
+	}
+
+	JobSystemStats warmupJobStats;
+	while (!g_isQuitting && !benchmark.IsFinished())
+	{
+		benchmark.BeginFrame();
+		BeginFrame();
+		// the job system counts a frame's allocations as the next one begins, so this covers the whole warmup
+		if (benchmark.GetFrameIndex() == benchmarkConfig.m_numWarmupFrames)
+		{
+			warmupJobStats = g_theJobSystem->GetStats();
+		}
+		Update();
+		EndFrame();
+		benchmark.EndFrame();
+	}
+
+	m_theGame->AddBenchmarkCounters(benchmark);
+	// the job path and the chunk job pools only allocate while they grow, both stay at zero once warmed up
+	JobSystemStats jobStats = g_theJobSystem->GetStats();
+	benchmark.SetCounter("jobPathAllocations", static_cast<double>(jobStats.m_numberJobPathAllocations - warmupJobStats.m_numberJobPathAllocations));
+	benchmark.SetCounter("jobPoolHeapAllocations", static_cast<double>(jobStats.m_numberJobPoolHeapAllocations - warmupJobStats.m_numberJobPoolHeapAllocations));
+	if (!benchmark.WriteResults())
+	{
+		DebuggerPrintf("Could not write benchmark results to %s\n", benchmarkConfig.m_outputFilePath.c_str());
+	}
+	Clock::SetSystemFixedDeltaSeconds(0.0);
+}
+
+
+static std::vector<ScriptedInputEvent> GetDefaultBenchmarkInput()
+{
+	// leave the attract screen, then fly forward at full speed so chunks keep activating ahead and deactivating behind
+	std::vector<ScriptedInputEvent> events;
+	events.push_back({ 1, KEYCODE_SPACE, true });
+	events.push_back({ 2, KEYCODE_SPACE, false });
+	events.push_back({ 10, KEYCODE_SHIFT, true });
+	events.push_back({ 10, 'W', true });
+	return events;
+}
+
+
 static bool Event_QuitApp(EventArgs& args)
 {
 	UNUSED(args)
@@ -10,7 +10,7 @@ class App
 public:
 	App();
 	~App();
-	void Startup();
+	void Startup(char const* commandLine);
 	void RunFrame();
 	void Shutdown();
 	void Run();
@@ -25,11 +25,14 @@ private:
 	void Update();
 	void Render() const;
 	void EndFrame();
+	// headless=true on the command line, fixed timestep and scripted input with nothing drawn, writes the frame timings as JSON
+	void RunBenchmark();
 
 private:
 	Game* m_theGame = nullptr;
 	Camera m_devCamera;
 	double m_timeLastFrame = 0.0;
+	bool m_isHeadless = false;
 };
 
 static bool Event_QuitApp(EventArgs& args);
@@ -4,7 +4,12 @@
 #include "Game/TemplateDefinition.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Core/Compression.hpp"
 #include "Engine/Core/Time.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 #include "ThirdParty/Squirrel/SmoothNoise.hpp"
 
 Chunk::Chunk(World* world, IntVec2 const& chunckCoords)
@@ -20,10 +25,13 @@ Chunk::Chunk(World* world, IntVec2 const& chunckCoords)
 	m_indexBuffer = g_theRenderer->CreateIndexBuffer(sizeof(unsigned int));
 	m_waterVertexBuffer = g_theRenderer->CreateVertexBuffer(sizeof(Vertex_PCU), sizeof(Vertex_PCU));
 	m_waterIndexBuffer = g_theRenderer->CreateIndexBuffer(sizeof(unsigned int));
-	m_vertices.reserve(RESERVED_VERTICES);
-	m_indices.reserve(RESERVED_INDICES);
-	m_waterVertices.reserve(RESERVED_VERTICES);
-	m_waterIndices.reserve(RESERVED_INDICES);
+	{
+		MEMORY_TAG_SCOPE(MEMORY_TAG_MESHES);
+		m_vertices.reserve(RESERVED_VERTICES);
+		m_indices.reserve(RESERVED_INDICES);
+		m_waterVertices.reserve(RESERVED_VERTICES);
+		m_waterIndices.reserve(RESERVED_INDICES);
+	}
 	m_worldSeed = m_world->GetWorldSeed();
 }
 
@@ -32,16 +40,8 @@ Chunk::~Chunk()
 {
 	if (m_needSaving)
 	{
-		m_world->m_diskSaveCounts++;
-		double start = GetCurrentTimeSeconds();
-
+		PROFILE_SCOPE("Disk Save");
 		SaveBlocksToDisk();
-
-		double end = GetCurrentTimeSeconds();
-		double duration = end - start;
-		if (duration > m_world->m_diskSaveWorse) m_world->m_diskSaveWorse = duration;
-		m_world->m_diskSaveFrametimes += duration;
-
 	}
 
 	delete m_debugVertexBuffer;
@@ -76,39 +76,85 @@ void Chunk::RenderWater() const
 }
 
 
+// fills count blocks from blockIndex on and returns the index after them, runs past the end of the chunk are cut off
+static int FillBlocksFromRun(Block* blocks, int blockIndex, uint8_t blockType, int blockCount)
+{
+	int endIndex = blockIndex + blockCount;
+	if (endIndex > CHUNK_BLOCKS_TOTAL) endIndex = CHUNK_BLOCKS_TOTAL;
+	bool isOpaque = BlockDefinition::GetById(blockType)->m_isOpaque;
+	for (; blockIndex < endIndex; blockIndex++)
+	{
+		blocks[blockIndex].m_type = blockType;
+		if (isOpaque)
+		{
+			blocks[blockIndex].SetBlockOpaque();
+		}
+	}
+	return blockIndex;
+}
+
+
 void Chunk::PopulateBlocksFromDisk()
 {
 	std::string fileName = Stringf("Saves/World_%i/Chunk(%i,%i).chunk", m_worldSeed, m_coordinates.x, m_coordinates.y);
-	std::vector<uint8_t> buffer;
-	FileReadToBuffer(buffer, fileName);
-	uint8_t g = buffer[0];
-	uint8_t c = buffer[1];
-	uint8_t h = buffer[2];
-	uint8_t k = buffer[3];
-	uint8_t version = buffer[4];
-	uint8_t chunkBitsX = buffer[5];
-	uint8_t chunkBitsY = buffer[6];
-	uint8_t chunkBitsZ = buffer[7];
-	if (g != 'G' || c != 'C' || h != 'H' || k != 'K' || version != 1 || chunkBitsX != CHUNK_BITS_X || chunkBitsY != CHUNK_BITS_Y || chunkBitsZ != CHUNK_BITS_Z)
+	// parsed straight out of the mapped file, no copy of it is made
+	MappedFile file(fileName);
+	if (file.GetSize() < 8)
+	{
+		GenerateBlocks();
+		return;
+	}
+	BufferParser parser(file.GetData(), (int)file.GetSize());
+
+	uint8_t g = parser.ParseByte();
+	uint8_t c = parser.ParseByte();
+	uint8_t h = parser.ParseByte();
+	uint8_t k = parser.ParseByte();
+	uint8_t version = parser.ParseByte();
+	uint8_t chunkBitsX = parser.ParseByte();
+	uint8_t chunkBitsY = parser.ParseByte();
+	uint8_t chunkBitsZ = parser.ParseByte();
+	bool isKnownVersion = version >= 1 && version <= CHUNK_SAVE_VERSION;
+	if (g != 'G' || c != 'C' || h != 'H' || k != 'K' || !isKnownVersion || chunkBitsX != CHUNK_BITS_X || chunkBitsY != CHUNK_BITS_Y || chunkBitsZ != CHUNK_BITS_Z)
 	{
 		GenerateBlocks();
 		return;
 	}
 
 	int blockIndex = 0;
-	for (int bufferIndex = 8; bufferIndex < (int)buffer.size(); bufferIndex += 2)
+	if (version == 1)
 	{
-		uint8_t currentBlockType = buffer[bufferIndex];
-		uint8_t currentBlockCount = buffer[bufferIndex + 1];
-		for (int blockCount = 0; blockCount < currentBlockCount; blockCount++)
+		// type and count bytes, runs longer than 255 are split
+		while (parser.GetRemainingSize() >= 2)
 		{
-			m_blocks[blockIndex].m_type = currentBlockType;
-			if (BlockDefinition::GetById(currentBlockType)->m_isOpaque)
-			{
-				m_blocks[blockIndex].SetBlockOpaque();
-			}
-			blockIndex++;
+			uint8_t currentBlockType = parser.ParseByte();
+			uint8_t currentBlockCount = parser.ParseByte();
+			blockIndex = FillBlocksFromRun(m_blocks, blockIndex, currentBlockType, currentBlockCount);
+		}
+		return;
+	}
+
+	// version 3 is the version 2 runs in a compressed frame after the header
+	std::vector<uint8_t> runs;
+	if (version == 3)
+	{
+		if (!parser.ParseCompressed(runs))
+		{
+			GenerateBlocks();
+			return;
 		}
+		parser = BufferParser(runs);
+	}
+
+	// type byte and varint count, so a run of air over the whole sky is three bytes
+	while (parser.GetRemainingSize() > 0 && blockIndex < CHUNK_BLOCKS_TOTAL)
+	{
+		uint8_t currentBlockType = parser.ParseByte();
+		// a corrupt count could overflow the index, no run is longer than the blocks left to fill
+		uint32_t currentBlockCount = parser.ParseVarUint32();
+		uint32_t numBlocksLeft = (uint32_t)(CHUNK_BLOCKS_TOTAL - blockIndex);
+		if (currentBlockCount > numBlocksLeft) currentBlockCount = numBlocksLeft;
+		blockIndex = FillBlocksFromRun(m_blocks, blockIndex, currentBlockType, (int)currentBlockCount);
 	}
 }
 
@@ -116,46 +162,55 @@ void Chunk::PopulateBlocksFromDisk()
 void Chunk::SaveBlocksToDisk()
 {
 	std::string fileName = Stringf("Saves/World_%i/Chunk(%i,%i).chunk", m_worldSeed, m_coordinates.x, m_coordinates.y);
-	std::vector<uint8_t> buffer;
-	buffer.reserve(10'000);
-	buffer.push_back('G');
-	buffer.push_back('C');
-	buffer.push_back('H');
-	buffer.push_back('K');
-	buffer.push_back(1);
-	buffer.push_back(CHUNK_BITS_X);
-	buffer.push_back(CHUNK_BITS_Y);
-	buffer.push_back(CHUNK_BITS_Z);
+	std::vector<uint8_t> runs;
+	BufferWriter runWriter(runs);
+	runWriter.Reserve(4'096);
 
 	uint8_t currentBlockType = m_blocks[0].m_type;
-	uint8_t currentBlockCount = 1;
+	uint32_t currentBlockCount = 1;
 	for (int blockIndex = 1; blockIndex < CHUNK_BLOCKS_TOTAL; blockIndex++)
 	{
 		uint8_t type = m_blocks[blockIndex].m_type;
 
 		if (currentBlockType == type)
 		{
-			if (currentBlockCount == 255)
-			{
-				buffer.push_back(currentBlockType);
-				buffer.push_back(currentBlockCount);
-				currentBlockCount = 0;
-			}
 			currentBlockCount++;
 		}
 		else
 		{
-			buffer.push_back(currentBlockType);
-			buffer.push_back(currentBlockCount);
+			runWriter.AppendByte(currentBlockType);
+			runWriter.AppendVarUint32(currentBlockCount);
 			currentBlockType = type;
 			currentBlockCount = 1;
 		}
 	}
 
-	buffer.push_back(currentBlockType);
-	buffer.push_back(currentBlockCount);
+	runWriter.AppendByte(currentBlockType);
+	runWriter.AppendVarUint32(currentBlockCount);
 
-	FileWriteFromBuffer(buffer, fileName);
+	std::vector<uint8_t> buffer;
+	BufferWriter writer(buffer);
+	writer.Reserve(GetMaxCompressedSize((int)runs.size()) + 64);
+	writer.AppendByte('G');
+	writer.AppendByte('C');
+	writer.AppendByte('H');
+	writer.AppendByte('K');
+	writer.AppendByte(CHUNK_SAVE_VERSION);
+	writer.AppendByte(CHUNK_BITS_X);
+	writer.AppendByte(CHUNK_BITS_Y);
+	writer.AppendByte(CHUNK_BITS_Z);
+	// neighbouring columns repeat the same runs, which the compressor turns into short back references
+	writer.AppendCompressed(runs.data(), (int)runs.size());
+
+	// written on the file I/O thread, World::ActivateChunk waits for it before loading this chunk again
+	if (g_theFileIOQueue)
+	{
+		g_theFileIOQueue->WriteFileAsync(fileName, std::move(buffer));
+	}
+	else
+	{
+		FileWriteFromBuffer(buffer, fileName);
+	}
 }
 
 
@@ -522,12 +577,8 @@ void Chunk::SetBufferDirty()
 }
 
 
-void Chunk::InitializeLighting()
+void Chunk::InitializeSkyBlocks()
 {
-	SetBufferDirty();
-
-	uint8_t water = (uint8_t) BlockDefinition::GetIndexByName("water");
-	// set sky blocks
 	for (int localY = 0; localY < CHUNK_SIZE_Y; localY++)
 	{
 		for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
@@ -541,79 +592,87 @@ void Chunk::InitializeLighting()
 			}
 		}
 	}
+	m_areSkyBlocksInitialized = true;
+}
 
-	//marking block dirty
-	for (int localZ = 0; localZ < CHUNK_SIZE_Z; localZ++)
+
+void Chunk::InitializeLighting()
+{
+	SetBufferDirty();
+
+	uint8_t water = (uint8_t) BlockDefinition::GetIndexByName("water");
+	// sky blocks are already set when the chunk came through the generation job graph
+	if (!m_areSkyBlocksInitialized)
 	{
-		for (int localY = 0; localY < CHUNK_SIZE_Y; localY++)
+		InitializeSkyBlocks();
+	}
+
+	// the layers only read blocks, so they are scanned in parallel
+	// marking pushes onto the world queue and touches neighbor chunks, so it is done here afterwards in layer order
+	int grainSize = g_theJobSystem->GetAutoGrainSize(CHUNK_SIZE_Z);
+	int numBatches = (CHUNK_SIZE_Z + grainSize - 1) / grainSize;
+	std::vector<std::vector<LightingDirtyMark>> marksPerBatch(numBatches);
+	g_theJobSystem->ParallelForBatches(0, CHUNK_SIZE_Z, grainSize, [&](int batchBegin, int batchEnd)
+	{
+		std::vector<LightingDirtyMark>& marks = marksPerBatch[batchBegin / grainSize];
+		for (int localZ = batchBegin; localZ < batchEnd; localZ++)
 		{
-			for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
+			AddLightingDirtyMarksForLayer(localZ, water, marks);
+		}
+	});
+
+	for (int batchIndex = 0; batchIndex < numBatches; batchIndex++)
+	{
+		std::vector<LightingDirtyMark> const& marks = marksPerBatch[batchIndex];
+		for (int markIndex = 0; markIndex < (int)marks.size(); markIndex++)
+		{
+			LightingDirtyMark const& mark = marks[markIndex];
+			mark.m_blockItr.m_chunk->SetBufferDirty();
+			if (mark.m_isLightingDirty)
 			{
-				int localIndex = GetIndexForLocalCoords(IntVec3(localX, localY, localZ));
-				BlockIterator currentBlockItr(this, localIndex);
-				Block* block = currentBlockItr.GetBlock();
+				m_world->MarkLightingDirty(mark.m_blockItr);
+			}
+		}
+	}
+}
 
-				// mark border blocks dirty
-				if (localX == 0 || localY == 0 || localX == CHUNK_MAX_X || localY == CHUNK_MAX_Y)
-				{
-					if (!block->IsBlockOpaque() || block->m_type == water)
-					{
-						m_world->MarkLightingDirty(currentBlockItr);
-					}
-				}
 
-				// mark light sources dirty
-				if (BlockDefinition::GetById(m_blocks[localIndex].m_type)->m_light != 0)
-				{
-					m_world->MarkLightingDirty(currentBlockItr);
-				}
+void Chunk::AddLightingDirtyMarksForLayer(int localZ, uint8_t water, std::vector<LightingDirtyMark>& marks)
+{
+	for (int localY = 0; localY < CHUNK_SIZE_Y; localY++)
+	{
+		for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
+		{
+			int localIndex = GetIndexForLocalCoords(IntVec3(localX, localY, localZ));
+			BlockIterator currentBlockItr(this, localIndex);
+			Block* block = currentBlockItr.GetBlock();
 
-				// mark sky neighbors dirty
-				if (block->IsBlockSky())
+			// mark border blocks dirty
+			if (localX == 0 || localY == 0 || localX == CHUNK_MAX_X || localY == CHUNK_MAX_Y)
+			{
+				if (!block->IsBlockOpaque() || block->m_type == water)
 				{
-					BlockIterator eastNeighbor = currentBlockItr.GetEastNeighbor();
-					Block* eastBlock = eastNeighbor.GetBlock();
-					if (eastBlock)
-					{
-						eastNeighbor.m_chunk->SetBufferDirty();
-						if (!eastBlock->IsBlockOpaque() && !eastBlock->IsBlockSky() || block->m_type == water)
-						{
-							m_world->MarkLightingDirty(eastNeighbor);
-						}
-					}
-
-					BlockIterator westNeighbor = currentBlockItr.GetWestNeighbor();
-					Block* westBlock = westNeighbor.GetBlock();
-					if (westBlock)
-					{
-						westNeighbor.m_chunk->SetBufferDirty();
-						if (!westBlock->IsBlockOpaque() && !westBlock->IsBlockSky() || block->m_type == water)
-						{
-							m_world->MarkLightingDirty(westNeighbor);
-						}
-					}
-
-					BlockIterator northNeighbor = currentBlockItr.GetNorthNeighbor();
-					Block* northBlock = northNeighbor.GetBlock();
-					if (northBlock)
-					{
-						northNeighbor.m_chunk->SetBufferDirty();
-						if (!northBlock->IsBlockOpaque() && !northBlock->IsBlockSky() || block->m_type == water)
-						{
-							m_world->MarkLightingDirty(northNeighbor);
-						}
+					marks.push_back(LightingDirtyMark{ currentBlockItr, true });
+				}
+			}
 
-					}
+			// mark light sources dirty
+			if (BlockDefinition::GetById(m_blocks[localIndex].m_type)->m_light != 0)
+			{
+				marks.push_back(LightingDirtyMark{ currentBlockItr, true });
+			}
 
-					BlockIterator southNeighbor = currentBlockItr.GetSouthNeighbor();
-					Block* southBlock = southNeighbor.GetBlock();
-					if (southBlock)
+			// mark sky neighbors dirty, every neighbor found has its buffer rebuilt
+			if (block->IsBlockSky())
+			{
+				BlockIterator neighbors[4] = { currentBlockItr.GetEastNeighbor(), currentBlockItr.GetWestNeighbor(), currentBlockItr.GetNorthNeighbor(), currentBlockItr.GetSouthNeighbor() };
+				for (int neighborIndex = 0; neighborIndex < 4; neighborIndex++)
+				{
+					Block* neighborBlock = neighbors[neighborIndex].GetBlock();
+					if (neighborBlock)
 					{
-						southNeighbor.m_chunk->SetBufferDirty();
-						if (!southBlock->IsBlockOpaque() && !southBlock->IsBlockSky() || block->m_type == water)
-						{
-							m_world->MarkLightingDirty(southNeighbor);
-						}
+						bool isLightingDirty = !neighborBlock->IsBlockOpaque() && !neighborBlock->IsBlockSky() || block->m_type == water;
+						marks.push_back(LightingDirtyMark{ neighbors[neighborIndex], isLightingDirty });
 					}
 				}
 			}
@@ -755,9 +814,8 @@ bool Chunk::RefreshVertexBuffer()
 {
 	if (m_isBufferDirty && AllNeighborsAreActivated())
 	{
-		m_world->m_rebuildBufferCounts++;
-		double start = GetCurrentTimeSeconds();
-
+		PROFILE_SCOPE("Chunk Rebuild");
+		MEMORY_TAG_SCOPE(MEMORY_TAG_MESHES);
 		m_vertices.clear();
 		m_indices.clear();
 		m_waterVertices.clear();
@@ -877,11 +935,6 @@ bool Chunk::RefreshVertexBuffer()
 		g_theRenderer->CopyCPUToGPU(m_waterIndices.data(), sizeof(unsigned int)* m_waterIndices.size(), m_waterIndexBuffer);
 
 		m_isBufferDirty = false;
-
-		double end = GetCurrentTimeSeconds();
-		double duration = end - start;
-		if (duration > m_world->m_rebuildBufferWorse) m_world->m_rebuildBufferWorse = duration;
-		m_world->m_rebuildBufferFrametimes += duration;
 		return true;
 	}
 	
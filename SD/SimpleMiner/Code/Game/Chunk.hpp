@@ -29,6 +29,8 @@ constexpr int CHUNK_BITSHIFT_Z = CHUNK_BITS_Y + CHUNK_BITS_X;
 
 constexpr int CHUNK_BLOCKS_PER_LAYER = CHUNK_SIZE_X * CHUNK_SIZE_Y;
 constexpr int CHUNK_BLOCKS_TOTAL = CHUNK_BLOCKS_PER_LAYER * CHUNK_SIZE_Z;
+// 2 stores run lengths as varints, 3 compresses those runs, version 1 and 2 saves still load
+constexpr uint8_t CHUNK_SAVE_VERSION = 3;
 
 constexpr int SEA_LEVEL = CHUNK_SIZE_Z / 2;
 constexpr int MAX_OCEAN_DEPTH = SEA_LEVEL - 20;
@@ -78,6 +80,13 @@ enum class ChunkState
 	NUM_CHUNK_STATES
 };
 
+// a block InitializeLighting found while scanning, its chunk's buffer is rebuilt and its lighting maybe marked dirty
+struct LightingDirtyMark
+{
+	BlockIterator m_blockItr;
+	bool m_isLightingDirty = false;
+};
+
 class Chunk
 {
 
@@ -107,11 +116,13 @@ public:
 	void DigBlockAt(BlockIterator const& blockItr);
 	void PlaceBlockAt(BlockIterator const& blockItr, uint8_t blockType);
 	void SetBufferDirty();
+	void InitializeSkyBlocks();
 	void InitializeLighting();
 
 private:
 	bool IsLocalCoordsTreenessLocalMax(IntVec2 const& coords, std::map<IntVec2, float> const& treenessNoise) const;
 	void GenerateTree(IntVec2 const& coords);
+	void AddLightingDirtyMarksForLayer(int localZ, uint8_t water, std::vector<LightingDirtyMark>& marks);
 	bool IsCoordsVillageLocalMax(std::map<IntVec2, float> const& villageNoise) const;
 	void GenerateVillage();
 	void AddIndexedVertsForBlock(BlockIterator const& blockItr, std::vector<Vertex_PCU>& verts, std::vector<unsigned int>& indices, AABB3 const& bounds, BlockDefinition const* blockDef, 
@@ -137,6 +148,7 @@ public:
 	bool m_isLightingDirty = false;
 	bool m_needSaving = false;
 	bool m_isHiddenSurfaceRemovedDisable = false;
+	bool m_areSkyBlocksInitialized = false;
 	int m_worldSeed = 0;
 
 	Chunk* m_westChunk = nullptr;
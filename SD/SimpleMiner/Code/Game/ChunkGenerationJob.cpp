@@ -1,18 +1,33 @@
 #include "Game/ChunkGenerationJob.hpp"
 #include "Game/Chunk.hpp"
+#include "Game/World.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/EventSystem.hpp"
+
+static EventId const s_chunkGeneratedEventId("ChunkGenerated");
 
 ChunkGenerationJob::ChunkGenerationJob(Chunk* chunk)
 	: Job(CHUNK_GEN_JOB_TYPE)
 	, m_chunk(chunk)
+	, m_chunkCoords(chunk->m_coordinates)
 {
 }
 
 
 void ChunkGenerationJob::Execute()
 {
+	PROFILE_SCOPE("Chunk Generation");
+	MEMORY_TAG_SCOPE(MEMORY_TAG_CHUNKS);
 	m_chunk->m_state = ChunkState::ACTIVATING_GENERATING;
 	m_chunk->GenerateBlocks();
 	m_chunk->m_state = ChunkState::ACTIVATING_GENERATE_DONE;
+
+	// this runs on a worker, the world hears about it on the main thread at the next BeginFrame
+	EventArgs args;
+	args.SetValue("chunkCoords", m_chunkCoords);
+	args.SetValue("worldSerial", m_chunk->m_world->m_worldSerial);
+	QueueEvent(s_chunkGeneratedEventId, args);
 }
 
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/Core/JobSystem.hpp"
+#include "Engine/Math/IntVec2.hpp"
 
 class Chunk;
 
@@ -17,4 +18,6 @@ public:
 
 public:
 	Chunk* m_chunk = nullptr;
+	// copied so the job can be matched after its chunk is gone
+	IntVec2 m_chunkCoords;
 };
\ No newline at end of file
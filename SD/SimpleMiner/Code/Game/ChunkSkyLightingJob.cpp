@@ -0,0 +1,24 @@
+#include "Game/ChunkSkyLightingJob.hpp"
+#include "Game/Chunk.hpp"
+#include "Engine/Core/Profiler.hpp"
+
+ChunkSkyLightingJob::ChunkSkyLightingJob(Chunk* chunk)
+	: Job(CHUNK_SKY_LIGHTING_JOB_TYPE)
+	, m_chunk(chunk)
+{
+}
+
+
+void ChunkSkyLightingJob::Execute()
+{
+	PROFILE_SCOPE("Chunk Sky Lighting");
+	m_chunk->InitializeSkyBlocks();
+}
+
+
+void ChunkSkyLightingJob::OnFinished()
+{
+
+}
+
+
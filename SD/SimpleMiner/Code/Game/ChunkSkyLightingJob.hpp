@@ -0,0 +1,20 @@
+#pragma once
+#include "Engine/Core/JobSystem.hpp"
+
+class Chunk;
+
+constexpr uint8_t CHUNK_SKY_LIGHTING_JOB_TYPE = 0b00000010;
+
+class ChunkSkyLightingJob : public Job
+{
+public:
+	ChunkSkyLightingJob(Chunk* chunk);
+	~ChunkSkyLightingJob() {}
+
+public:
+	virtual void Execute() override;
+	virtual void OnFinished() override;
+
+public:
+	Chunk* m_chunk = nullptr;
+};
\ No newline at end of file
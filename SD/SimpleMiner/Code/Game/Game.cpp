@@ -17,6 +17,9 @@
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Renderer/SimpleTriangleFont.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/Benchmark.hpp"
+#include "Engine/Core/Time.hpp"
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -84,13 +87,19 @@ Game::Game(App* const& owner)
 	pauseSound = g_theAudio->CreateOrGetSound("Data/Audio/Pause.mp3");
 	unpauseSound = g_theAudio->CreateOrGetSound("Data/Audio/Unpause.mp3");
 
-	BlockDefinition::InitializeBlockDefinitions();
-	BlockColorDefinition::InitializeBlockColorDefinitions();
-	EntityDefinition::InitializeDefinitions();
-	TemplateDefinition::InitalizeDefinitions("Data/Definitions/TreeTemplateDefinitions.xml");
-	TemplateDefinition::LoadFromSpriteFile("Data/3DSprites/oak.3dsprite");
-	TemplateDefinition::LoadFromSpriteFile("Data/3DSprites/spruce.3dsprite");
-	TemplateDefinition::LoadFromSpriteFile("Data/3DSprites/house.3dsprite");
+	{
+		MEMORY_TAG_SCOPE(MEMORY_TAG_DEFINITIONS);
+		double definitionLoadStartTime = GetCurrentTimeSeconds();
+		BlockDefinition::InitializeBlockDefinitions();
+		BlockColorDefinition::InitializeBlockColorDefinitions();
+		EntityDefinition::InitializeDefinitions();
+		TemplateDefinition::InitalizeDefinitions("Data/Definitions/TreeTemplateDefinitions.xml");
+		TemplateDefinition::LoadFromSpriteFile("Data/3DSprites/oak.3dsprite");
+		TemplateDefinition::LoadFromSpriteFile("Data/3DSprites/spruce.3dsprite");
+		TemplateDefinition::LoadFromSpriteFile("Data/3DSprites/house.3dsprite");
+		m_definitionLoadMilliseconds = (GetCurrentTimeSeconds() - definitionLoadStartTime) * 1000.0;
+		DebuggerPrintf("Definitions loaded in %.2fms\n", m_definitionLoadMilliseconds);
+	}
 	SubscribeEventCallbackFunction("debugSpawnScreenMessage", Event_SpawnScreenMessage);
 	g_theGame = this;
 }
@@ -395,6 +404,13 @@ float Game::GetTotalGameTime() const
 }
 
 
+void Game::AddBenchmarkCounters(BenchmarkRecorder& benchmark) const
+{
+	benchmark.SetCounter("activeChunks", m_currentWorld ? static_cast<double>(m_currentWorld->m_activeChunks.size()) : 0.0);
+	benchmark.SetCounter("definitionLoadMilliseconds", m_definitionLoadMilliseconds);
+}
+
+
 Camera* Game::GetCamera()
 {
 	return &m_worldCamera;
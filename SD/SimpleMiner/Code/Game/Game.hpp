@@ -4,6 +4,8 @@
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/Stopwatch.hpp"
 
+class BenchmarkRecorder;
+
 enum class GameMode
 {
 	INVALID_MODE = -1,
@@ -35,6 +37,7 @@ public:
 	void ResetGame();
 	float GetTotalGameTime() const;
 	Camera* GetCamera();
+	void AddBenchmarkCounters(BenchmarkRecorder& benchmark) const;
 
 private:
 	void RenderPausePanel() const;
@@ -50,6 +53,8 @@ private:
 	Camera m_UICamera;
 	Clock m_gameClock;
 	World* m_currentWorld = nullptr;
+	// the first launch after a definition XML changes parses and cooks it, later ones read the cooked file
+	double m_definitionLoadMilliseconds = 0.0;
 };
 
 
@@ -9,10 +9,8 @@ App* g_theApp;
 //-----------------------------------------------------------------------------------------------
 int WINAPI WinMain( HINSTANCE, HINSTANCE, LPSTR commandLineString, int )
 {
-	UNUSED( commandLineString );
-
 	g_theApp = new App();
-	g_theApp->Startup();
+	g_theApp->Startup( commandLineString );
 	g_theApp->Run();
 	g_theApp->Shutdown();
 	delete g_theApp;
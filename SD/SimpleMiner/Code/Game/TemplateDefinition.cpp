@@ -1,9 +1,12 @@
 #include "Game/TemplateDefinition.hpp"
 #include "Game/BlockColorDefinition.hpp"
+#include "Engine/Core/DefinitionCache.hpp"
 #include "Engine/Core/FileUtils.hpp"
 
 std::vector<TemplateDefinition*> TemplateDefinition::s_definitions;
 
+constexpr uint32_t TEMPLATE_COOK_VERSION = 1;
+
 bool TemplateDefinition::LoadFromXmlElement(XmlElement const& element)
 {
 	m_name = ParseXmlAttribute(element, "name", "none");
@@ -24,6 +27,31 @@ bool TemplateDefinition::LoadFromXmlElement(XmlElement const& element)
 }
 
 
+void TemplateDefinition::WriteCooked(BufferWriter& writer) const
+{
+	writer.AppendStringZeroTerminated(m_name);
+	writer.AppendUint32((uint32_t)m_blocks.size());
+	for (TemplateBlock const& block : m_blocks)
+	{
+		writer.AppendStringZeroTerminated(block.m_blockName);
+		writer.AppendIntVec3(block.m_offset);
+	}
+}
+
+
+void TemplateDefinition::ReadCooked(BufferParser& parser)
+{
+	m_name = parser.ParseStringZeroTerminated();
+	int numBlocks = (int)parser.ParseUint32();
+	m_blocks.resize(numBlocks);
+	for (int blockIndex = 0; blockIndex < numBlocks; blockIndex++)
+	{
+		m_blocks[blockIndex].m_blockName = parser.ParseStringZeroTerminated();
+		m_blocks[blockIndex].m_offset = parser.ParseIntVec3();
+	}
+}
+
+
 void TemplateDefinition::ParseInfoString(std::string const& infoString)
 {
 	size_t nameBegin = infoString.find("name") + 7;
@@ -79,29 +107,35 @@ void TemplateDefinition::ParseInfoString(std::string const& infoString)
 
 void TemplateDefinition::InitalizeDefinitions(char const* path)
 {
-	XmlDocument doc;
-	doc.LoadFile(path);
-	XmlElement const* root = doc.RootElement();
-
-	XmlElement const* element = root->FirstChildElement();
-	while (element)
+	LoadOrCookDefinitions(path, TEMPLATE_COOK_VERSION, s_definitions, [](XmlElement const& element) -> TemplateDefinition*
 	{
 		TemplateDefinition* newTemplateDef = new TemplateDefinition();
-		newTemplateDef->LoadFromXmlElement(*element);
-		TemplateDefinition::s_definitions.push_back(newTemplateDef);
-		element = element->NextSiblingElement();
-	}
+		newTemplateDef->LoadFromXmlElement(element);
+		return newTemplateDef;
+	});
 }
 
 
 void TemplateDefinition::LoadFromSpriteFile(char const* filePath)
 {
 	if (!FileExists(filePath)) return;
+	TemplateDefinition* newTemplateDef = new TemplateDefinition();
+	TemplateDefinition::s_definitions.push_back(newTemplateDef);
+
+	// a sprite file is one definition, cooked the same way as the XML ones
+	DefinitionCache cache(filePath, TEMPLATE_COOK_VERSION);
+	if (cache.OpenCooked())
+	{
+		BufferParser parser = cache.GetCookedParser();
+		newTemplateDef->ReadCooked(parser);
+		return;
+	}
+
 	std::string fileString;
 	FileReadToString(fileString, filePath);
-	TemplateDefinition* newTemplateDef = new TemplateDefinition();
 	newTemplateDef->ParseInfoString(fileString);
-	TemplateDefinition::s_definitions.push_back(newTemplateDef);
+	newTemplateDef->WriteCooked(cache.GetCookWriter());
+	cache.SaveCooked();
 }
 
 
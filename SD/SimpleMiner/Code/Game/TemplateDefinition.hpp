@@ -5,6 +5,9 @@
 #include <stdint.h>
 #include <vector>
 
+class BufferParser;
+class BufferWriter;
+
 struct TemplateBlock
 {
 	std::string m_blockName;
@@ -15,6 +18,8 @@ class TemplateDefinition
 {
 public:
 	bool LoadFromXmlElement(XmlElement const& element);
+	void WriteCooked(BufferWriter& writer) const;
+	void ReadCooked(BufferParser& parser);
 
 private:
 	void ParseInfoString(std::string const& infoString);
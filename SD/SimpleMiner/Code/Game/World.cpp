@@ -4,15 +4,21 @@
 #include "Game/Player.hpp"
 #include "Game/Game.hpp"
 #include "Game/BlockIterator.hpp"
-#include "Game/ChunkGenerationJob.hpp"
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Core/Time.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "ThirdParty/Squirrel/SmoothNoise.hpp"
 
 #include <algorithm>
 
+// the debug overlay fires this about a dozen times a frame
+static EventId const s_debugSpawnScreenMessageEventId("debugSpawnScreenMessage");
+static int s_numWorldsCreated = 0;
+
 struct{
 	bool operator()(IntVec2 const& a, IntVec2 const& b) const 
 	{
@@ -30,11 +36,13 @@ World::World(Game* game)
 	:m_game(game)
 {
 	m_texture = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/BasicSprites_64x64.png");
-	if (!g_gameConfigBlackboard.GetValue("disableShader", false))
+	m_isShaderDisabled = g_gameConfigBlackboard.GetValue("disableShader", false);
+	if (!m_isShaderDisabled)
 	{
 		m_shader = g_theRenderer->CreateOrGetShader("Data/Shaders/World");
 	}
 	m_worldSeed = g_gameConfigBlackboard.GetValue("worldSeed", 0);
+	m_worldSerial = ++s_numWorldsCreated;
 	m_chunkActivationRange = g_gameConfigBlackboard.GetValue("chunkActivationRange", 0.f);
 	m_chunkDeactivationRange = m_chunkActivationRange + static_cast<float>(CHUNK_SIZE_X + CHUNK_SIZE_Y);
 	m_maxChunkRadiusX = 1 + static_cast<int>(m_chunkActivationRange) / CHUNK_SIZE_X;
@@ -66,11 +74,15 @@ World::World(Game* game)
 
 	m_offsetsReversed = m_offsets;
 	std::reverse(m_offsetsReversed.begin(), m_offsetsReversed.end());
+
+	SubscribeEventCallbackObjectMethod("ChunkGenerated", this, &World::Event_ChunkGenerated);
 }
 
 
 World::~World()
 {
+	UnsubscribeEventCallbackObjectMethod("ChunkGenerated", this, &World::Event_ChunkGenerated);
+
 	std::map<IntVec2, Chunk*>::iterator generateItr;
 	for (generateItr = m_generationChunks.begin(); generateItr != m_generationChunks.end(); generateItr++)
 	{
@@ -101,6 +113,8 @@ World::~World()
 void World::Startup(Vec3 const& pos, EulerAngles const& orientation)
 {
 	m_player = new Player(this, pos, orientation, m_game->GetCamera());
+	m_startupSeconds = GetCurrentTimeSeconds();
+	PregenerateChunks();
 }
 
 
@@ -385,7 +399,7 @@ GameRaycastResult3D World::RaycastVsBlocks(Vec3 const& rayStart, Vec3 const& for
 
 void World::UpdateWorld(float deltaSeconds)
 {
-	if (!g_gameConfigBlackboard.GetValue("disableShader", false))
+	if (!m_isShaderDisabled)
 	{
 		SetGameConstant();
 		BindGameConstantBuffer();
@@ -402,6 +416,8 @@ void World::UpdateWorld(float deltaSeconds)
 		m_worldDay += (deltaSeconds * REAL_TIME_RATIO) * DAYS_PER_SECOND;
 	}
 
+	UpdateChunkGenerationJobs();
+
 	bool activateThisFrame = false;
 	if ((int)m_activeChunks.size() < m_maxChunks)
 	{
@@ -427,16 +443,8 @@ void World::UpdateWorld(float deltaSeconds)
 	}
 	// profiling end
 
-	m_resolveLightingCounts++;
-	double start = GetCurrentTimeSeconds();
-
 	ProcessDirtyLighting();
 
-	double end = GetCurrentTimeSeconds();
-	double duration = end - start;
-	if (duration > m_resolveLightingWorse) m_resolveLightingWorse = duration;
-	m_resolveLightingFrametimes += duration;
-
 	std::map<IntVec2, Chunk*>::iterator itr;
 	for (itr = m_activeChunks.begin(); itr != m_activeChunks.end(); itr++)
 	{
@@ -459,6 +467,10 @@ void World::UpdateWorld(float deltaSeconds)
 		{
 			if (chunk->RefreshVertexBuffer())
 			{
+				if (m_firstVisibleChunkSeconds < 0.0)
+				{
+					m_firstVisibleChunkSeconds = GetCurrentTimeSeconds() - m_startupSeconds;
+				}
 				refreshCount--;
 			}
 
@@ -471,8 +483,31 @@ void World::UpdateWorld(float deltaSeconds)
 }
 
 
+void World::PregenerateChunks()
+{
+	float pregenerationRange = g_gameConfigBlackboard.GetValue("chunkPregenerationRange", static_cast<float>(CHUNK_SIZE_X * 2));
+	if (pregenerationRange > m_chunkActivationRange) pregenerationRange = m_chunkActivationRange;
+	if (pregenerationRange <= 0.f) return;
+
+	Vec3 playerPos = m_player->m_camera->GetCameraPosition();
+	IntVec2 playerChunk = GetChunkCoordinatesForPosition(playerPos);
+	for (int index = 0; index < (int)m_offsetsReversed.size(); index++)
+	{
+		IntVec2 chunkCoords = playerChunk + m_offsetsReversed[index];
+		if (m_generationChunks.find(chunkCoords) != m_generationChunks.end() || m_activeChunks.find(chunkCoords) != m_activeChunks.end()) continue;
+		if (GetDistanceSquaredToChunk(chunkCoords) > pregenerationRange * pregenerationRange) continue;
+		ActivateChunk(chunkCoords);
+	}
+
+	// the main thread generates alongside the workers instead of idling until they are done
+	g_theJobSystem->WaitForAll(CHUNK_GEN_JOB_TYPE | CHUNK_SKY_LIGHTING_JOB_TYPE);
+	RetrieveCompletedJobs();
+}
+
+
 bool World::ActivateNearestChunk()
 {
+	PROFILE_SCOPE("Chunk Activation");
 	Vec3 playerPos = m_player->m_camera->GetCameraPosition();
 	IntVec2 playerChunk = GetChunkCoordinatesForPosition(playerPos);
 	int minChunkX = playerChunk.x - m_maxChunkRadiusX;
@@ -511,6 +546,7 @@ bool World::ActivateNearestChunk()
 
 bool World::DeactivateFurthestChunk()
 {
+	PROFILE_SCOPE("Chunk Deactivation");
 	Vec3 playerPos = m_player->m_camera->GetCameraPosition();
 	IntVec2 playerChunk = GetChunkCoordinatesForPosition(playerPos);
 	float furthestDistanceSquared = 0.f;
@@ -605,24 +641,41 @@ EulerAngles const& World::GetPlayerOrientation() const
 }
 
 
+bool World::Event_ChunkGenerated(EventArgs& args)
+{
+	if (args.GetValue("worldSerial", 0) != m_worldSerial)
+	{
+		return false;
+	}
+
+	// a finished generation job needs no more reprioritizing, RetrieveCompletedJobs still catches any that finish after this
+	// and the chunk may already hold a newer job, which is just as safe to drop once it is completed
+	std::map<IntVec2, ChunkGenerationJob*>::iterator jobItr = m_chunkGenerationJobs.find(args.GetValue("chunkCoords", IntVec2()));
+	if (jobItr != m_chunkGenerationJobs.end() && jobItr->second->GetJobState() == JobState::COMPLETED)
+	{
+		m_chunkGenerationJobs.erase(jobItr);
+	}
+	return false;
+}
+
+
 void World::ActivateChunk(IntVec2 const& chunkCoords)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_CHUNKS);
 	Chunk* newChunk = new Chunk(this, chunkCoords);
 	m_generationChunks[chunkCoords] = newChunk;
 
 	std::string fileName = Stringf("Saves/World_%i/Chunk(%i,%i).chunk", m_worldSeed, chunkCoords.x, chunkCoords.y);
+	// a save of this chunk may still be queued from when it was deactivated
+	if (g_theFileIOQueue)
+	{
+		g_theFileIOQueue->WaitForFile(fileName);
+	}
 	if (FileExists(fileName))
 	{
-		m_diskLoadCounts++;
-		double start = GetCurrentTimeSeconds();
-
+		PROFILE_SCOPE("Disk Load");
 		newChunk->PopulateBlocksFromDisk();
 		AddActiveChunkToWorld(newChunk);
-
-		double end = GetCurrentTimeSeconds();
-		double duration = end - start;
-		if (duration > m_diskLoadWorse) m_diskLoadWorse = duration;
-		m_diskLoadFrametimes += duration;
 	}
 	else
 	{
@@ -636,8 +689,12 @@ void World::ActivateChunk(IntVec2 const& chunkCoords)
 		//if (duration > m_perlinGenerationWorse) m_perlinGenerationWorse = duration;
 		//m_perlinGenerationFrametimes += duration;
 
-		ChunkGenerationJob* job = new ChunkGenerationJob(newChunk);
-		g_theJobSystem->QueueJob(job);
+		ChunkGenerationJob* generationJob = m_chunkGenerationJobPool.Acquire(newChunk);
+		ChunkSkyLightingJob* skyLightingJob = m_chunkSkyLightingJobPool.Acquire(newChunk);
+		skyLightingJob->AddDependency(generationJob);
+		g_theJobSystem->QueueJob(skyLightingJob);
+		g_theJobSystem->QueuePrioritizedJob(generationJob, GetDistanceSquaredToChunk(chunkCoords));
+		m_chunkGenerationJobs[chunkCoords] = generationJob;
 	}
 }
 
@@ -668,18 +725,61 @@ void World::DeactivateChunk(IntVec2 const& chunkCoords)
 }
 
 
+void World::UpdateChunkGenerationJobs()
+{
+	// nearer chunks jump ahead as the player moves, chunks that left the range are dropped before generating
+	std::map<IntVec2, ChunkGenerationJob*>::iterator itr;
+	for (itr = m_chunkGenerationJobs.begin(); itr != m_chunkGenerationJobs.end(); itr++)
+	{
+		ChunkGenerationJob* job = itr->second;
+		if (job->IsCancelled() || job->GetJobState() == JobState::COMPLETED) continue;
+
+		float distanceSquared = GetDistanceSquaredToChunk(itr->first);
+		if (distanceSquared >= (m_chunkDeactivationRange * m_chunkDeactivationRange))
+		{
+			g_theJobSystem->CancelJob(job);
+		}
+		else
+		{
+			g_theJobSystem->SetJobPriority(job, distanceSquared);
+		}
+	}
+}
+
+
 void World::RetrieveCompletedJobs()
 {
+	PROFILE_SCOPE("Retrieve Chunk Jobs");
 	Job* completedJob = g_theJobSystem->RetrieveCompletedJob();
 	while (completedJob)
 	{
-		if (ChunkGenerationJob* job = dynamic_cast<ChunkGenerationJob*>(completedJob))
+		// the generation job only feeds the sky lighting job, the chunk is ready once that one is done
+		if (completedJob->GetJobType() == CHUNK_GEN_JOB_TYPE)
 		{
-			Chunk* chunk = job->m_chunk;
-			AddActiveChunkToWorld(chunk);
+			// the sky lighting job may have been retrieved first, so only the copied coordinates are safe to use
+			ChunkGenerationJob* job = static_cast<ChunkGenerationJob*>(completedJob);
+			std::map<IntVec2, ChunkGenerationJob*>::iterator jobItr = m_chunkGenerationJobs.find(job->m_chunkCoords);
+			if (jobItr != m_chunkGenerationJobs.end() && jobItr->second == job)
+			{
+				m_chunkGenerationJobs.erase(jobItr);
+			}
+		}
+		else if (completedJob->GetJobType() == CHUNK_SKY_LIGHTING_JOB_TYPE)
+		{
+			ChunkSkyLightingJob* job = static_cast<ChunkSkyLightingJob*>(completedJob);
+			if (job->IsCancelled())
+			{
+				// cancellation of the generation job carries over, the chunk never became active
+				m_generationChunks.erase(job->m_chunk->m_coordinates);
+				delete job->m_chunk;
+			}
+			else
+			{
+				AddActiveChunkToWorld(job->m_chunk);
+			}
 		}
 
-		delete completedJob;
+		g_theJobSystem->DestroyJob(completedJob);
 		completedJob = g_theJobSystem->RetrieveCompletedJob();
 	}
 }
@@ -739,6 +839,15 @@ Chunk* World::GetChunkForCoordinate(IntVec2 const& coordinate) const
 }
 
 
+float World::GetDistanceSquaredToChunk(IntVec2 const& chunkCoords) const
+{
+	Vec3 playerPos = m_player->m_camera->GetCameraPosition();
+	float chunkCenterX = static_cast<float>(chunkCoords.x << CHUNK_BITS_X) + 0.5f * static_cast<float>(CHUNK_SIZE_X);
+	float chunkCenterY = static_cast<float>(chunkCoords.y << CHUNK_BITS_Y) + 0.5f * static_cast<float>(CHUNK_SIZE_Y);
+	return GetDistanceSquared2D(Vec2(playerPos.x, playerPos.y), Vec2(chunkCenterX, chunkCenterY));
+}
+
+
 BlockIterator World::GetBlockIteratorForPosition(Vec3 const& pos) const
 {
 	IntVec2 chunkCoords = GetChunkCoordinatesForPosition(pos);
@@ -749,6 +858,7 @@ BlockIterator World::GetBlockIteratorForPosition(Vec3 const& pos) const
 
 void World::ProcessDirtyLighting()
 {
+	PROFILE_SCOPE("Resolve Lighting");
 	while (!m_dirtyLightingQueue.empty())
 	{
 		BlockIterator blockItr = m_dirtyLightingQueue.front();
@@ -945,7 +1055,7 @@ void World::UpdateDebugInfo(float deltaSeconds)
 	guideArgs.SetValue("text", controlGuide);
 	guideArgs.SetValue("duration", "0.0");
 	guideArgs.SetValue("color", "255, 255, 0");
-	FireEvent("debugSpawnScreenMessage", guideArgs);
+	FireEvent(s_debugSpawnScreenMessageEventId, guideArgs);
 
 	Vec3 position = m_player->m_position;
 	EulerAngles orientation = m_player->m_orientationDegree;
@@ -960,7 +1070,7 @@ void World::UpdateDebugInfo(float deltaSeconds)
 	debugArgs.SetValue("text", gameStatus);
 	debugArgs.SetValue("duration", "0.0");
 	debugArgs.SetValue("color", "100, 255, 100");
-	FireEvent("debugSpawnScreenMessage", debugArgs);
+	FireEvent(s_debugSpawnScreenMessageEventId, debugArgs);
 	
 	std::string cameraModeInfo = "";
 	switch (m_player->m_cameraMode)
@@ -986,7 +1096,7 @@ void World::UpdateDebugInfo(float deltaSeconds)
 	modeArgs.SetValue("text", modeInfo);
 	modeArgs.SetValue("duration", "0.0");
 	modeArgs.SetValue("color", "255, 100, 100");
-	FireEvent("debugSpawnScreenMessage", modeArgs);
+	FireEvent(s_debugSpawnScreenMessageEventId, modeArgs);
 
 	if (!g_isDebugging || g_gameConfigBlackboard.GetValue("disableProfiling", true)) return;
 	// fps profiling
@@ -997,7 +1107,7 @@ void World::UpdateDebugInfo(float deltaSeconds)
 	fpsArgs.SetValue("text", fpsInfo);
 	fpsArgs.SetValue("duration", "0.0");
 	fpsArgs.SetValue("color", "100, 255, 255");
-	FireEvent("debugSpawnScreenMessage", fpsArgs);
+	FireEvent(s_debugSpawnScreenMessageEventId, fpsArgs);
 
 	// Perlin generation profiling
 	//double perlinGenAverage = m_perlinGenerationFrametimes / static_cast<double>(m_perlinGenerationCounts) * 1000.0;
@@ -1006,43 +1116,68 @@ void World::UpdateDebugInfo(float deltaSeconds)
 	//perlinGenArgs.SetValue("text", perlinGenInfo);
 	//perlinGenArgs.SetValue("duration", "0.0");
 	//perlinGenArgs.SetValue("color", "100, 255, 255");
-	//FireEvent("debugSpawnScreenMessage", perlinGenArgs);
-
-	// disk load profiling
-	double diskLoadAverage = m_diskLoadFrametimes / static_cast<double>(m_diskLoadCounts) * 1000.0;
-	std::string diskLoadInfo = Stringf("Disk Load         - worst=%.2fms, average %.2fms", m_diskLoadWorse * 1000.0, diskLoadAverage);
-	EventArgs diskLoadArgs;
-	diskLoadArgs.SetValue("text", diskLoadInfo);
-	diskLoadArgs.SetValue("duration", "0.0");
-	diskLoadArgs.SetValue("color", "100, 255, 255");
-	FireEvent("debugSpawnScreenMessage", diskLoadArgs);
-
-	// disk save profiling
-	double diskSaveAverage = m_diskSaveFrametimes / static_cast<double>(m_diskSaveCounts) * 1000.0;
-	std::string diskSaveInfo = Stringf("Disk Save         - worst=%.2fms, average %.2fms", m_diskSaveWorse * 1000.0, diskSaveAverage);
-	EventArgs diskSaveArgs;
-	diskSaveArgs.SetValue("text", diskSaveInfo);
-	diskSaveArgs.SetValue("duration", "0.0");
-	diskSaveArgs.SetValue("color", "100, 255, 255");
-	FireEvent("debugSpawnScreenMessage", diskSaveArgs);
-
-	// chunk rebuild profiling
-	double rebuildBufferAverage = m_rebuildBufferFrametimes / static_cast<double>(m_rebuildBufferCounts) * 1000.0;
-	std::string rebuildBufferInfo = Stringf("Chunk Rebuild     - worst=%.2fms, average %.2fms", m_rebuildBufferWorse * 1000.0, rebuildBufferAverage);
-	EventArgs rebuildBufferArgs;
-	rebuildBufferArgs.SetValue("text", rebuildBufferInfo);
-	rebuildBufferArgs.SetValue("duration", "0.0");
-	rebuildBufferArgs.SetValue("color", "100, 255, 255");
-	FireEvent("debugSpawnScreenMessage", rebuildBufferArgs);
-
-	// light resolve profiling
-	double resolveLightingAverage = m_resolveLightingFrametimes / static_cast<double>(m_resolveLightingCounts) * 1000.0;
-	std::string resolveLightingInfo = Stringf("Resolve Lighting  - worst=%.2fms, average %.2fms", m_resolveLightingWorse * 1000.0, resolveLightingAverage);
-	EventArgs resolveLightingArgs;
-	resolveLightingArgs.SetValue("text", resolveLightingInfo);
-	resolveLightingArgs.SetValue("duration", "0.0");
-	resolveLightingArgs.SetValue("color", "100, 255, 255");
-	FireEvent("debugSpawnScreenMessage", resolveLightingArgs);
+	//FireEvent(s_debugSpawnScreenMessageEventId, perlinGenArgs);
+
+	// scope profiling, per frame totals over the profiler history
+	char const* profiledScopes[] = { "Disk Load", "Disk Save", "Chunk Rebuild", "Resolve Lighting" };
+	for (int scopeIndex = 0; scopeIndex < 4; scopeIndex++)
+	{
+		ProfileScopeStats scopeStats = g_theProfiler->GetScopeStats(profiledScopes[scopeIndex]);
+		std::string scopeInfo = Stringf("%-17s - worst=%.2fms, average %.2fms, p99 %.2fms", profiledScopes[scopeIndex], scopeStats.m_maxMilliseconds, scopeStats.m_averageMilliseconds, scopeStats.m_p99Milliseconds);
+		EventArgs scopeArgs;
+		scopeArgs.SetValue("text", scopeInfo);
+		scopeArgs.SetValue("duration", "0.0");
+		scopeArgs.SetValue("color", "100, 255, 255");
+		FireEvent(s_debugSpawnScreenMessageEventId, scopeArgs);
+	}
+
+	// memory tags, live size and last frame's allocation churn
+	MemoryTagStats chunkMemory = GetMemoryTagStats(MEMORY_TAG_CHUNKS);
+	MemoryTagStats meshMemory = GetMemoryTagStats(MEMORY_TAG_MESHES);
+	MemoryTagStats totalMemory = GetTotalMemoryStats();
+	std::string memoryInfo = Stringf("Memory            - chunks=%.1fMB, meshes=%.1fMB, total=%.1fMB, allocations/frame=%i", (double)chunkMemory.m_liveBytes / (1024.0 * 1024.0), (double)meshMemory.m_liveBytes / (1024.0 * 1024.0), (double)totalMemory.m_liveBytes / (1024.0 * 1024.0), totalMemory.m_frameAllocations);
+	EventArgs memoryArgs;
+	memoryArgs.SetValue("text", memoryInfo);
+	memoryArgs.SetValue("duration", "0.0");
+	memoryArgs.SetValue("color", "100, 255, 255");
+	FireEvent(s_debugSpawnScreenMessageEventId, memoryArgs);
+
+	FrameArenaStats frameArena = GetFrameArenaStats();
+	std::string frameArenaInfo = Stringf("Frame Arena       - requested=%.2fMB of %.2fMB, allocations=%i, heap fallbacks=%i", (double)frameArena.m_frameBytes / (1024.0 * 1024.0), (double)frameArena.m_capacityBytes / (1024.0 * 1024.0), frameArena.m_frameAllocations, frameArena.m_frameHeapFallbacks);
+	EventArgs frameArenaArgs;
+	frameArenaArgs.SetValue("text", frameArenaInfo);
+	frameArenaArgs.SetValue("duration", "0.0");
+	frameArenaArgs.SetValue("color", "100, 255, 255");
+	FireEvent(s_debugSpawnScreenMessageEventId, frameArenaArgs);
+
+	// job pool profiling
+	int jobHeapAllocations = m_chunkGenerationJobPool.GetNumberHeapAllocations() + m_chunkSkyLightingJobPool.GetNumberHeapAllocations();
+	int jobAcquires = m_chunkGenerationJobPool.GetNumberAcquires() + m_chunkSkyLightingJobPool.GetNumberAcquires();
+	int liveJobs = m_chunkGenerationJobPool.GetNumberLiveJobs() + m_chunkSkyLightingJobPool.GetNumberLiveJobs();
+	std::string jobPoolInfo = Stringf("Job Pools         - acquires=%i, heap allocations=%i, live=%i", jobAcquires, jobHeapAllocations, liveJobs);
+	EventArgs jobPoolArgs;
+	jobPoolArgs.SetValue("text", jobPoolInfo);
+	jobPoolArgs.SetValue("duration", "0.0");
+	jobPoolArgs.SetValue("color", "100, 255, 255");
+	FireEvent(s_debugSpawnScreenMessageEventId, jobPoolArgs);
+
+	// job worker idle profiling
+	JobSystemStats jobStats = g_theJobSystem->GetStats();
+	std::string jobWorkerInfo = Stringf("Job Workers       - parks=%i, wakeups=%i, spin=%.2fms", jobStats.m_numberParks, jobStats.m_numberWakeups, jobStats.m_spinSeconds * 1000.0);
+	EventArgs jobWorkerArgs;
+	jobWorkerArgs.SetValue("text", jobWorkerInfo);
+	jobWorkerArgs.SetValue("duration", "0.0");
+	jobWorkerArgs.SetValue("color", "100, 255, 255");
+	FireEvent(s_debugSpawnScreenMessageEventId, jobWorkerArgs);
+
+	// streaming latency profiling
+	double firstVisibleChunkMilliseconds = m_firstVisibleChunkSeconds < 0.0 ? 0.0 : m_firstVisibleChunkSeconds * 1000.0;
+	std::string streamingInfo = Stringf("Chunk Streaming   - first visible=%.2fms, pending=%i, cancelled=%i", firstVisibleChunkMilliseconds, (int)m_chunkGenerationJobs.size(), jobStats.m_numberCancelledJobs);
+	EventArgs streamingArgs;
+	streamingArgs.SetValue("text", streamingInfo);
+	streamingArgs.SetValue("duration", "0.0");
+	streamingArgs.SetValue("color", "100, 255, 255");
+	FireEvent(s_debugSpawnScreenMessageEventId, streamingArgs);
 }
 
 
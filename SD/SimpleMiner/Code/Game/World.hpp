@@ -1,5 +1,8 @@
 #pragma once
 #include "Game/BlockIterator.hpp"
+#include "Game/ChunkGenerationJob.hpp"
+#include "Game/ChunkSkyLightingJob.hpp"
+#include "Engine/Core/JobPool.hpp"
 #include "Engine/Math/IntVec2.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Math/Vec4.hpp"
@@ -72,16 +75,21 @@ public:
 	Vec3 const& GetPlayerPos() const;
 	EulerAngles const& GetPlayerOrientation() const;
 
+	bool Event_ChunkGenerated(EventArgs& args);
+
 private:
 	void UpdateWorld(float deltaSeconds);
+	void PregenerateChunks();
 	bool ActivateNearestChunk();
 	bool DeactivateFurthestChunk();
 	void ActivateChunk(IntVec2 const& chunkCoords);
 	void DeactivateChunk(IntVec2 const& chunkCoords);
+	void UpdateChunkGenerationJobs();
 	void RetrieveCompletedJobs();
 	void AddActiveChunkToWorld(Chunk* chunk);
 	IntVec2 GetChunkCoordinatesForPosition(Vec3 const& pos) const;
 	Chunk* GetChunkForCoordinate(IntVec2 const& coordinate) const;
+	float GetDistanceSquaredToChunk(IntVec2 const& chunkCoords) const;
 	BlockIterator GetBlockIteratorForPosition(Vec3 const& pos) const;
 	void ProcessDirtyLighting();
 	void ProcessNextDirtyLightBlock(BlockIterator const& blockItr);
@@ -92,14 +100,22 @@ private:
 
 public:
 	int m_worldSeed = 0;
+	// a reset world can still have chunk events queued by its jobs, they are told apart from this world's by it
+	int m_worldSerial = 0;
 	Game* m_game = nullptr;
 	Player* m_player = nullptr;
 	std::map<IntVec2, Chunk*> m_activeChunks;
 	std::map<IntVec2, Chunk*> m_generationChunks;
+	// generation jobs that may still be queued, reprioritized by distance or cancelled when out of range
+	std::map<IntVec2, ChunkGenerationJob*> m_chunkGenerationJobs;
+	JobPool<ChunkGenerationJob> m_chunkGenerationJobPool;
+	JobPool<ChunkSkyLightingJob> m_chunkSkyLightingJobPool;
 	std::vector<IntVec2> m_offsets;
 	std::vector<IntVec2> m_offsetsReversed;
 	Texture const* m_texture = nullptr;
 	Shader* m_shader = nullptr;
+	// read once, the blackboard is a string map
+	bool m_isShaderDisabled = false;
 	float m_chunkActivationRange = 0.f;
 	float m_chunkDeactivationRange = 0.f;
 	int m_maxChunkRadiusX = 0;
@@ -122,18 +138,8 @@ public:
 	//int m_perlinGenerationCounts = 0;
 	//double m_perlinGenerationFrametimes = 0.0;
 	//double m_perlinGenerationWorse = 0.0;
-	int m_diskLoadCounts = 0;
-	double m_diskLoadFrametimes = 0.0;
-	double m_diskLoadWorse = 0.0;
-	int m_diskSaveCounts = 0;
-	double m_diskSaveFrametimes = 0.0;
-	double m_diskSaveWorse = 0.0;
-	int m_rebuildBufferCounts = 0;
-	double m_rebuildBufferFrametimes = 0.0;
-	double m_rebuildBufferWorse = 0.0;
-	int m_resolveLightingCounts = 0;
-	double m_resolveLightingFrametimes = 0.0;
-	double m_resolveLightingWorse = 0.0;
+	double m_startupSeconds = 0.0;
+	double m_firstVisibleChunkSeconds = -1.0;
 };
 
 
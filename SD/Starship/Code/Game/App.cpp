@@ -5,6 +5,7 @@
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
@@ -80,6 +81,7 @@ void App::Startup()
 
 	g_theDevConsole->Startup();
 	g_theEventSystem->Startup();
+	FrameArenaStartup();
 	g_theInput->Startup();
 	g_theWindow->Startup();
 	g_theRenderer->Startup();
@@ -110,6 +112,7 @@ void App::Shutdown()
 	g_theWindow->Shutdown();
 	g_theInput->ShutDown();
 	g_theDevConsole->ShutDown();
+	FrameArenaShutdown();
 	g_theEventSystem->ShutDown();
 
 	delete m_theGame;
@@ -170,6 +173,7 @@ void App::HandleQuitRequested()
 
 void App::BeginFrame()
 {
+	FrameArenaBeginFrame();
 	g_theDevConsole->BeginFrame();
 	g_theEventSystem->BeginFrame();
 	g_theInput->BeginFrame();
@@ -3,6 +3,7 @@
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/Renderer.hpp"
@@ -1176,17 +1177,17 @@ void Game::SpawnStarfield()
 void Game::DrawLevelTextUI() const
 {
 	int level = (m_wave == MAX_WAVE) ? m_wave : m_wave + 1;
-	std::vector<Vertex_PCU> levelTextVertexArray;
+	FrameVector<Vertex_PCU> levelTextVertexArray;
 	AddVertsForTextTriangles2D(levelTextVertexArray, "Level: " + std::to_string(level), Vec2(30.f, 755.f), 20.f, Rgba8(255, 255, 255, 255));
-	g_theRenderer->DrawVertexArray(int(levelTextVertexArray.size()), &levelTextVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(levelTextVertexArray.size()), levelTextVertexArray.data());
 }
 
 
 void Game::DrawPlayerLivesUI() const
 {
-	std::vector<Vertex_PCU> livesTextVertexArray;
+	FrameVector<Vertex_PCU> livesTextVertexArray;
 	AddVertsForTextTriangles2D(livesTextVertexArray, "Lives: ", Vec2(30.f, 715.f), 20.f, Rgba8(255, 255, 255, 255));
-	g_theRenderer->DrawVertexArray(int(livesTextVertexArray.size()), &livesTextVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(livesTextVertexArray.size()), livesTextVertexArray.data());
 
 	for (int liveIndex = 0; liveIndex < m_playerShip->health; liveIndex++)
 	{
@@ -1198,9 +1199,9 @@ void Game::DrawPlayerLivesUI() const
 
 void Game::DrawWeaponUI() const
 {
-	std::vector<Vertex_PCU> weaponTextVertexArray;
+	FrameVector<Vertex_PCU> weaponTextVertexArray;
 	AddVertsForTextTriangles2D(weaponTextVertexArray, "Weapon: ", Vec2(30.f, 675.f), 20.f, Rgba8(255, 255, 255, 255));
-	g_theRenderer->DrawVertexArray(int(weaponTextVertexArray.size()), &weaponTextVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(weaponTextVertexArray.size()), weaponTextVertexArray.data());
 
 	for (int bulletIndex = 0; bulletIndex < m_playerShip->m_bulletCount; bulletIndex++)
 	{
@@ -1211,9 +1212,9 @@ void Game::DrawWeaponUI() const
 
 void Game::DrawEnemyCountsUI() const
 {
-	std::vector<Vertex_PCU> enemyTextVertexArray;
+	FrameVector<Vertex_PCU> enemyTextVertexArray;
 	AddVertsForTextTriangles2D(enemyTextVertexArray, "Enemies: ", Vec2(30.f, 635.f), 20.f, Rgba8(255, 255, 255, 255));
-	g_theRenderer->DrawVertexArray(int(enemyTextVertexArray.size()), &enemyTextVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(enemyTextVertexArray.size()), enemyTextVertexArray.data());
 
 	for (int beetleIndex = 0; beetleIndex < m_beetleCounter; beetleIndex++)
 	{
@@ -1274,18 +1275,18 @@ void Game::DrawEnemiesHealthBar() const
 void Game::DrawWinningUI() const
 {
 	float percentage = Clamp(m_returnTimer, 0.f, 1.5f);
-	std::vector<Vertex_PCU> winTextVertexArray;
+	FrameVector<Vertex_PCU> winTextVertexArray;
 	AddVertsForTextTriangles2D(winTextVertexArray, "You Win", Vec2(775.f - 100.f * percentage, 415.f - 50.f * percentage), 50.f * percentage, Rgba8(0, 0, 255, 255));
-	g_theRenderer->DrawVertexArray(int(winTextVertexArray.size()), &winTextVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(winTextVertexArray.size()), winTextVertexArray.data());
 }
 
 
 void Game::DrawLosingUI() const
 {
 	float percentage = Clamp(m_returnTimer, 0.f, 1.5f);
-	std::vector<Vertex_PCU> loseTextVertexArray;
+	FrameVector<Vertex_PCU> loseTextVertexArray;
 	AddVertsForTextTriangles2D(loseTextVertexArray, "You Lose", Vec2(775.f - 100.f * percentage, 415.f - 50.f * percentage), 50.f * percentage, Rgba8(255, 0, 0, 255));
-	g_theRenderer->DrawVertexArray(int(loseTextVertexArray.size()), &loseTextVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(loseTextVertexArray.size()), loseTextVertexArray.data());
 }
 
 
@@ -1302,21 +1303,21 @@ void Game::DrawAttractScreen() const
 	frames++;
 	if (frames > 180) frames = 0;
 
-	std::vector<Vertex_PCU> starshipTitleShadowVertexArray;
+	FrameVector<Vertex_PCU> starshipTitleShadowVertexArray;
 	AddVertsForTextTriangles2D(starshipTitleShadowVertexArray, "Starship", Vec2(14.f, 64.f), 20.f, Rgba8(50, 50, 50, 100 - static_cast<unsigned char>(offset)));
-	g_theRenderer->DrawVertexArray(int(starshipTitleShadowVertexArray.size()), &starshipTitleShadowVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(starshipTitleShadowVertexArray.size()), starshipTitleShadowVertexArray.data());
 
-	std::vector<Vertex_PCU> starshipTitleVertexArray;
+	FrameVector<Vertex_PCU> starshipTitleVertexArray;
 	AddVertsForTextTriangles2D(starshipTitleVertexArray, "Starship", Vec2(15.f, 63.f), 20.f, Rgba8(100, 100, 255, 150 - static_cast<unsigned char>(offset)));
-	g_theRenderer->DrawVertexArray(int(starshipTitleVertexArray.size()), &starshipTitleVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(starshipTitleVertexArray.size()), starshipTitleVertexArray.data());
 
-	std::vector<Vertex_PCU> startGameVertexArray;
+	FrameVector<Vertex_PCU> startGameVertexArray;
 	AddVertsForTextTriangles2D(startGameVertexArray, "START", Vec2(165.f, 20.f), 5.f, Rgba8(255, 255, 255, 255));
-	g_theRenderer->DrawVertexArray(int(startGameVertexArray.size()), &startGameVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(startGameVertexArray.size()), startGameVertexArray.data());
 
-	std::vector<Vertex_PCU> endGameVertexArray;
+	FrameVector<Vertex_PCU> endGameVertexArray;
 	AddVertsForTextTriangles2D(endGameVertexArray, "EXIT", Vec2(165.f, 10.f), 5.f, Rgba8(255, 255, 255, 255));
-	g_theRenderer->DrawVertexArray(int(endGameVertexArray.size()), &endGameVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(endGameVertexArray.size()), endGameVertexArray.data());
 	
 	if (m_isStartOrExit)
 	{
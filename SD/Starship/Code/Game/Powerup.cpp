@@ -4,6 +4,7 @@
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/SimpleTriangleFont.hpp"
@@ -60,9 +61,9 @@ void Powerup::Render() const
 
 	g_theRenderer->DrawVertexArray(NUM_POWERUP_VERTICES, tempPowerupVerts);
 
-	std::vector<Vertex_PCU> powerupTextVertexArray;
+	FrameVector<Vertex_PCU> powerupTextVertexArray;
 	AddVertsForTextTriangles2D(powerupTextVertexArray, "P", m_position - Vec2(.5f, 1.2f), 2.f, Rgba8(50, 50, 150, m_mainColor.a));
-	g_theRenderer->DrawVertexArray(int(powerupTextVertexArray.size()), &powerupTextVertexArray[0]);
+	g_theRenderer->DrawVertexArray(int(powerupTextVertexArray.size()), powerupTextVertexArray.data());
 }
 
 